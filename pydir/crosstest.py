@@ -67,7 +67,8 @@ def main():
                            dest='clang_opt')
     argparser.add_argument('--mattr',  required=False, default='sse2',
                            dest='attr', choices=['sse2', 'sse4.1',
-                                                 'neon', 'hwdiv-arm',
+                                                 'popcnt', 'bmi', 'bmi2',
+                                                 'avx', 'neon', 'hwdiv-arm',
                                                  'base'],
                            metavar='ATTRIBUTE',
                            help='Target attribute. Default %(default)s.')
@@ -51,6 +51,25 @@ def RunNativePrefix(toolchain_root, target, attr, run_cmd):
     prefix = 'QEMU_SET_ENV=LD_LIBRARY_PATH=/usr/mipsel-linux-gnu/lib/ ' + prefix
   return (prefix + ' ' + run_cmd) if prefix else run_cmd
 
+def HostSupportsAttr(target, attr):
+  """Returns whether a native executable for the target and attribute can run
+  on this machine.
+
+  The x86 avx level also assumes BMI1 and BMI2, so the host CPU needs all
+  three. The other attributes are either baseline or run under an emulator.
+  """
+  if target not in ('x8632', 'x8664') or attr != 'avx':
+    return True
+  try:
+    with open('/proc/cpuinfo') as f:
+      for line in f:
+        if line.startswith('flags'):
+          flags = set(line.split(':', 1)[1].split())
+          return set(['avx', 'bmi1', 'bmi2']) <= flags
+  except IOError:
+    pass
+  return False
+
 def NonsfiLoaderArch(target):
   """Returns the arch for the nonsfi_loader"""
   arch_map = { 'arm32' : 'arm',
@@ -74,9 +93,9 @@ def main():
   # The rest of the attribute sets.
   targets = [ 'x8632', 'x8664', 'arm32', 'mips32' ]
   sandboxing = [ 'native', 'sandbox', 'nonsfi' ]
-  opt_levels = [ 'Om1', 'O2' ]
-  arch_attrs = { 'x8632': [ 'sse2', 'sse4.1' ],
-                 'x8664': [ 'sse2', 'sse4.1' ],
+  opt_levels = [ 'Om1', 'O1', 'O2' ]
+  arch_attrs = { 'x8632': [ 'sse2', 'sse4.1', 'avx' ],
+                 'x8664': [ 'sse2', 'sse4.1', 'avx' ],
                  'arm32': [ 'neon', 'hwdiv-arm' ],
                  'mips32': [ 'base' ]
                }
@@ -168,6 +187,10 @@ def main():
           for attr in arch_attrs[target]:
             desc = [ test, target, sb, opt, attr ]
             if Match(set(desc), includes, excludes, default_match):
+              if not HostSupportsAttr(target, attr):
+                print 'Skipping {desc}, which the host CPU cannot run'.format(
+                  desc=','.join(desc))
+                continue
               exe = '{test}_{target}_{sb}_{opt}_{attr}'.format(
                 test=test, target=target, sb=sb, opt=opt,
                 attr=attr)
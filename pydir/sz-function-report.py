@@ -0,0 +1,138 @@
+#!/usr/bin/env python2
+
+import argparse
+import collections
+import csv
+import json
+import sys
+
+# Numeric fields of a -function-report entry, in output order.
+FIELDS = ['input_bits', 'insts_before', 'insts_after', 'spills', 'fills',
+          'code_bytes', 'arena_bytes', 'translate_sec']
+
+
+def ReadReport(filename):
+    """Yield the entries of a -function-report file as dicts.
+
+    CSV files are recognized by their .csv extension, like pnacl-sz does, and
+    their pass_sec field is converted to the dict used in JSON Lines files.
+    """
+    with open(filename) as f:
+        if filename.endswith('.csv'):
+            for row in csv.DictReader(f):
+                passes = {}
+                for item in row['pass_sec'].split(';'):
+                    if item:
+                        name, seconds = item.split('=')
+                        passes[name] = seconds
+                row['pass_sec'] = passes
+                yield row
+        else:
+            for line in f:
+                if line.strip():
+                    yield json.loads(line)
+
+
+class FunctionSummary(object):
+    """Accumulates the entries of one function across reports."""
+    def __init__(self, name):
+        self.name = name
+        self.runs = 0
+        self.total = collections.defaultdict(float)
+        self.max = collections.defaultdict(float)
+        self.pass_total = collections.defaultdict(float)
+
+    def Add(self, entry):
+        self.runs += 1
+        for field in FIELDS:
+            value = float(entry[field])
+            self.total[field] += value
+            self.max[field] = max(self.max[field], value)
+        for name, seconds in entry['pass_sec'].items():
+            self.pass_total[name] += float(seconds)
+
+    def SlowestPass(self):
+        if not self.pass_total:
+            return ''
+        return max(self.pass_total.items(), key=lambda item: item[1])[0]
+
+    def Row(self):
+        row = collections.OrderedDict()
+        row['name'] = self.name
+        row['runs'] = self.runs
+        for field in FIELDS:
+            row['mean_' + field] = self.total[field] / self.runs
+            row['max_' + field] = self.max[field]
+        row['slowest_pass'] = self.SlowestPass()
+        return row
+
+
+def main():
+    """Aggregate pnacl-sz -function-report files across runs.
+
+    Entries are grouped by function name, which should be unique within a
+    pexe, so reports of the same pexe from different builds or machines can be
+    combined to find the functions that are pathologically slow to translate or
+    that use the most memory.  Each output row has the number of entries for the
+    function, the mean and maximum of each numeric field, and the pass with the
+    largest total time.
+    """
+    argparser = argparse.ArgumentParser(
+        description='    ' + main.__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    argparser.add_argument('reports', nargs='+', metavar='REPORT',
+                           help='Report files (.csv for CSV, JSON Lines '
+                           'otherwise)')
+    argparser.add_argument('--sort', default='max_translate_sec',
+                           choices=['runs'] + [stat + field
+                                               for field in FIELDS
+                                               for stat in ['mean_', 'max_']],
+                           help='Column to sort by, in decreasing order '
+                           '(default: %(default)s)')
+    argparser.add_argument('--top', type=int, default=0,
+                           help='Only print the first TOP functions')
+    argparser.add_argument('--csv', action='store_true',
+                           help='Print CSV instead of an aligned table')
+    args = argparser.parse_args()
+
+    summaries = {}
+    for filename in args.reports:
+        for entry in ReadReport(filename):
+            name = entry['name']
+            if name not in summaries:
+                summaries[name] = FunctionSummary(name)
+            summaries[name].Add(entry)
+
+    rows = sorted((summary.Row() for summary in summaries.values()),
+                  key=lambda row: (-row[args.sort], row['name']))
+    if args.top:
+        rows = rows[:args.top]
+    if not rows:
+        return 0
+    columns = list(rows[0].keys())
+
+    def Format(value):
+        if isinstance(value, float):
+            return '%.6f' % value if value != int(value) else '%d' % value
+        return str(value)
+
+    if args.csv:
+        writer = csv.writer(sys.stdout)
+        writer.writerow(columns)
+        for row in rows:
+            writer.writerow([Format(value) for value in row.values()])
+        return 0
+
+    table = [columns] + [[Format(value) for value in row.values()]
+                         for row in rows]
+    widths = [max(len(line[i]) for line in table) for i in range(len(columns))]
+    for line in table:
+        sys.stdout.write('  '.join(cell.ljust(width) if i == 0 or
+                                   i == len(columns) - 1 else cell.rjust(width)
+                                   for i, (cell, width) in
+                                   enumerate(zip(line, widths))).rstrip() + '\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,133 @@
+#!/usr/bin/env python2
+
+import argparse
+import collections
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+TIERS = ['Om1', 'O1', 'O2']
+
+
+def TimeCommand(cmd, repeat):
+    """Returns the fastest wall time of 'repeat' runs of cmd, in seconds."""
+    best = None
+    with open(os.devnull, 'w') as devnull:
+        for _ in range(repeat):
+            start = time.time()
+            subprocess.check_call(cmd, stdout=devnull)
+            elapsed = time.time() - start
+            best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def CompileStats(args, pexe, tier):
+    """Translates pexe at the given tier, and returns the wall time together
+    with the totals of the -function-report fields."""
+    handle, report = tempfile.mkstemp(suffix='.jsonl')
+    os.close(handle)
+    try:
+        cmd = [args.pnacl_sz, '-' + tier, '-filetype=obj', '-o', os.devnull,
+               '-threads=0', '-function-report=' + report,
+               '--target=' + args.target, pexe]
+        wall = TimeCommand(cmd, args.repeat)
+        totals = collections.defaultdict(float)
+        with open(report) as f:
+            for line in f:
+                if line.strip():
+                    entry = json.loads(line)
+                    for field in ['translate_sec', 'code_bytes', 'spills',
+                                  'fills']:
+                        totals[field] += float(entry[field])
+    finally:
+        os.remove(report)
+    # The report is rewritten by each run, so the totals are those of the last
+    # run, which is representative for the size and spill counts.
+    return wall, totals
+
+
+def Print(header, rows):
+    widths = [max(len(str(row[i])) for row in [header] + rows)
+              for i in range(len(header))]
+    for row in [header] + rows:
+        sys.stdout.write('  '.join(str(cell).ljust(width) if i == 0 else
+                                   str(cell).rjust(width)
+                                   for i, (cell, width) in
+                                   enumerate(zip(row, widths))) + '\n')
+
+
+def main():
+    """Compare the -Om1, -O1, and -O2 translation tiers.
+
+    For each pexe, reports the translation time, code size, and spill and fill
+    counts at each tier, using pnacl-sz's -function-report.  With
+    --crosstest-dir, also reports the run time of the executables that
+    crosstest_generator.py built into that directory, grouped by the tier in
+    their names, e.g. "simple_loop_x8632_native_O1_sse2".  Build the
+    executables with "crosstest_generator.py -i x8632,native,sse2" so that all
+    three tiers are present.  Times are the fastest of --repeat runs.
+    """
+    argparser = argparse.ArgumentParser(
+        description='    ' + main.__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    argparser.add_argument('pexes', nargs='*', metavar='PEXE',
+                           help='Finalized pexe files to translate')
+    argparser.add_argument('--pnacl-sz', default='./pnacl-sz',
+                           help='Path to pnacl-sz (default: %(default)s)')
+    argparser.add_argument('--target', default='x8632',
+                           help='Translation target (default: %(default)s)')
+    argparser.add_argument('--crosstest-dir', default=None,
+                           help='Directory of crosstest executables to run')
+    argparser.add_argument('--repeat', type=int, default=3,
+                           help='Number of runs of each command '
+                           '(default: %(default)s)')
+    args = argparser.parse_args()
+
+    if args.pexes:
+        rows = []
+        for pexe in args.pexes:
+            for tier in TIERS:
+                wall, totals = CompileStats(args, pexe, tier)
+                rows.append([os.path.basename(pexe), tier, '%.3f' % wall,
+                             '%.3f' % totals['translate_sec'],
+                             '%d' % totals['code_bytes'],
+                             '%d' % totals['spills'], '%d' % totals['fills']])
+        Print(['pexe', 'tier', 'wall_sec', 'translate_sec', 'code_bytes',
+               'spills', 'fills'], rows)
+
+    if args.crosstest_dir:
+        # Executables are named {test}_{target}_{sb}_{opt}_{attr}, and test
+        # names may themselves contain underscores.
+        pattern = re.compile(r'^(.*)_(\w+?)_(native|sandbox|nonsfi)_(' +
+                             '|'.join(TIERS) + r')_([\w.-]+)$')
+        times = collections.defaultdict(dict)
+        for name in sorted(os.listdir(args.crosstest_dir)):
+            path = os.path.join(args.crosstest_dir, name)
+            match = pattern.match(name)
+            if not match or not os.access(path, os.X_OK):
+                continue
+            test, target, sb, tier, attr = match.groups()
+            if sb != 'native':
+                continue
+            key = '_'.join([test, target, attr])
+            times[key][tier] = TimeCommand([path], args.repeat)
+        rows = []
+        for key in sorted(times):
+            row = [key]
+            for tier in TIERS:
+                row.append('%.3f' % times[key][tier] if tier in times[key]
+                           else '-')
+            base = times[key].get('Om1')
+            fast = times[key].get('O1')
+            row.append('%.2fx' % (base / fast) if base and fast else '-')
+            rows.append(row)
+        Print(['test'] + [tier + '_sec' for tier in TIERS] + ['Om1/O1'], rows)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
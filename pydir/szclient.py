@@ -0,0 +1,91 @@
+#!/usr/bin/env python2
+
+import argparse
+import os
+import shlex
+import socket
+import subprocess
+import sys
+import time
+
+STATUS_PREFIX = 'pnacl-sz-status: '
+
+
+def main():
+    """Send a compile request to a pnacl-sz running with -compile-server.
+
+    The request consists of the client's working directory and the pnacl-sz
+    arguments, one per line, terminated by an empty line.  Everything the
+    server writes to its stdout/stderr while serving the request is copied to
+    stdout, and the exit status of the request becomes the exit status of this
+    script.
+    """
+    argparser = argparse.ArgumentParser(
+        description='    ' + main.__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    argparser.add_argument('--socket', required=True,
+                           help='Unix domain socket the server listens on')
+    argparser.add_argument('--start-server', metavar='COMMAND', default=None,
+                           help='Start a server with this pnacl-sz command ' +
+                           'line for the request, and stop it afterwards ' +
+                           '(for testing)')
+    argparser.add_argument('args', nargs=argparse.REMAINDER,
+                           help='Arguments to pass to pnacl-sz')
+    args = argparser.parse_args()
+
+    if any('\n' in arg for arg in args.args):
+        print >> sys.stderr, 'Arguments must not contain newlines'
+        return 1
+
+    server = None
+    if args.start_server:
+        server = start_server(args.start_server, args.socket)
+    try:
+        return send_request(args.socket, args.args)
+    finally:
+        if server:
+            server.terminate()
+            server.wait()
+
+
+def start_server(command, socket_path):
+    """Starts pnacl-sz as a compile server on socket_path, and waits until
+    it accepts connections."""
+    if os.path.exists(socket_path):
+        os.unlink(socket_path)
+    server = subprocess.Popen(shlex.split(command) +
+                              ['-compile-server=' + socket_path])
+    for _ in range(500):
+        if os.path.exists(socket_path):
+            return server
+        if server.poll() is not None:
+            break
+        time.sleep(0.01)
+    server.kill()
+    raise RuntimeError('Compile server did not start: ' + command)
+
+
+def send_request(socket_path, request_args):
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(socket_path)
+    sock.sendall('\n'.join([os.getcwd()] + request_args) + '\n\n')
+
+    reply = ''
+    while True:
+        data = sock.recv(1 << 16)
+        if not data:
+            break
+        reply += data
+    sock.close()
+
+    status_pos = reply.rfind(STATUS_PREFIX)
+    if status_pos < 0:
+        # The server process died before finishing the request.
+        sys.stdout.write(reply)
+        return 1
+    sys.stdout.write(reply[:status_pos])
+    return int(reply[status_pos + len(STATUS_PREFIX):].strip())
+
+
+if __name__ == '__main__':
+    sys.exit(main())
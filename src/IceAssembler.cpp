@@ -146,6 +146,22 @@ llvm::StringRef Assembler::getBufferView() const {
 void Assembler::bindRelocOffset(RelocOffset *Offset) {
   if (!getPreliminary()) {
     Offset->setOffset(Buffer.getPosition());
+    BoundRelocOffsets.push_back(Offset);
+  }
+}
+
+void Assembler::resetForReemission() {
+  Buffer.setSize(0);
+  Buffer.truncateFixups(0);
+  for (RelocOffset *Offset : BoundRelocOffsets)
+    Offset->resetOffset();
+  BoundRelocOffsets.clear();
+}
+
+void Assembler::emitBytes(llvm::StringRef Bytes) {
+  for (const char Byte : Bytes) {
+    AssemblerBuffer::EnsureCapacity _(&Buffer);
+    Buffer.emit<uint8_t>(Byte);
   }
 }
 
@@ -196,6 +196,11 @@ public:
   void installFixup(AssemblerFixup *F);
 
   const FixupRefList &fixups() const { return Fixups; }
+  /// Drops the fixups installed after the first NumFixups.
+  void truncateFixups(SizeT NumFixups) {
+    assert(NumFixups <= Fixups.size());
+    Fixups.resize(NumFixups);
+  }
 
   void setSize(intptr_t NewSize) {
     assert(NewSize <= size());
@@ -321,6 +326,9 @@ public:
 
   bool needsTextFixup() const { return Buffer.needsTextFixup(); }
 
+  /// Appends the given (previously assembled) bytes to the buffer.
+  void emitBytes(llvm::StringRef Bytes);
+
   void emitIASBytes(GlobalContext *Ctx) const;
   bool getInternal() const { return IsInternal; }
   void setInternal(bool Internal) { IsInternal = Internal; }
@@ -332,6 +340,13 @@ public:
   void setPreliminary(bool Value) { Preliminary = Value; }
   bool getPreliminary() const { return Preliminary; }
 
+  /// Returns true if the function has to be emitted again, because branch
+  /// relaxation found short branches that do not reach their targets.
+  virtual bool needsReemission() const { return false; }
+  /// Discards the code, fixups and labels of the function, so that it can be
+  /// emitted again. What branch relaxation has learned is kept.
+  virtual void resetForReemission();
+
   AssemblerKind getKind() const { return Kind; }
 
 protected:
@@ -355,6 +370,9 @@ private:
   /// all changes to label bindings, label links, and relocation fixups are
   /// fully committed (Preliminary=false).
   bool Preliminary = false;
+  /// The label offsets bound while emitting the current function, which have to
+  /// be unbound before it is emitted again.
+  std::vector<RelocOffset *> BoundRelocOffsets;
 
   /// Installs a created fixup, after it has been allocated.
   void installFixup(AssemblerFixup *F) { Buffer.installFixup(F); }
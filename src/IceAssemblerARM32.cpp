@@ -699,8 +699,8 @@ size_t BlRelocatableFixup::emit(GlobalContext *Ctx,
     return InstARM32::InstSize;
   Ostream &Str = Ctx->getStrEmit();
   IValueT Inst = Asm.load<IValueT>(position());
-  Str << "\t"
-         "bl\t" << symbol() << "\t@ .word "
+  const char *Opcode = kind() == llvm::ELF::R_ARM_JUMP24 ? "b" : "bl";
+  Str << "\t" << Opcode << "\t" << symbol() << "\t@ .word "
       << llvm::format_hex_no_prefix(Inst, 8) << "\n";
   return InstARM32::InstSize;
 }
@@ -1396,6 +1396,22 @@ void AssemblerARM32::b(Label *L, CondARM32::Cond Cond) {
   emitBranch(L, Cond, false);
 }
 
+void AssemblerARM32::b(const ConstantRelocatable *Target) {
+  // B (immediate) - ARM section A8.8.18, encoding A1:
+  //   b<c> <label>
+  //
+  // cccc1010iiiiiiiiiiiiiiiiiiiiiiii where cccc=Cond (not currently allowed)
+  // and iiiiiiiiiiiiiiiiiiiiiiii is the (encoded) Target to branch to. Unlike
+  // bl, this uses a R_ARM_JUMP24 relocation.
+  BlRelocatableFixup *F = createBlFixup(Target);
+  F->set_kind(llvm::ELF::R_ARM_JUMP24);
+  emitFixup(F);
+  constexpr CondARM32::Cond Cond = CondARM32::AL;
+  constexpr IValueT Immed = 0;
+  constexpr bool Link = false;
+  emitType05(Cond, Immed, Link);
+}
+
 void AssemblerARM32::bkpt(uint16_t Imm16) {
   // BKPT - ARM section A*.8.24 - encoding A1:
   //   bkpt #<Imm16>
@@ -191,6 +191,9 @@ public:
 
   void b(Label *L, CondARM32::Cond Cond);
 
+  /// Unconditional branch to an external target, e.g. for sibling calls.
+  void b(const ConstantRelocatable *Target);
+
   void bkpt(uint16_t Imm16);
 
   void bic(const Operand *OpRd, const Operand *OpRn, const Operand *OpSrc1,
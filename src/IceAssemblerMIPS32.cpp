@@ -65,6 +65,14 @@ void AssemblerMIPS32::trap() {
 
 void AssemblerMIPS32::nop() { emitInst(0); }
 
+void AssemblerMIPS32::emitDelaySlot() {
+  if (DelaySlotFilled) {
+    DelaySlotFilled = false;
+    return;
+  }
+  nop();
+}
+
 void AssemblerMIPS32::padWithNop(intptr_t Padding) {
   constexpr intptr_t InstWidth = sizeof(IValueT);
   assert(Padding % InstWidth == 0 &&
@@ -648,7 +656,7 @@ void AssemblerMIPS32::jal(const ConstantRelocatable *Target) {
   IValueT Opcode = 0x0C000000;
   emitFixup(createMIPS32Fixup(RelocOp::RO_Jal, Target));
   emitInst(Opcode);
-  nop();
+  emitDelaySlot();
 }
 
 void AssemblerMIPS32::jalr(const Operand *OpRs, const Operand *OpRd) {
@@ -659,7 +667,7 @@ void AssemblerMIPS32::jalr(const Operand *OpRs, const Operand *OpRd) {
   Opcode |= Rd << 11;
   Opcode |= Rs << 21;
   emitInst(Opcode);
-  nop();
+  emitDelaySlot();
 }
 
 void AssemblerMIPS32::lui(const Operand *OpRt, const Operand *OpImm,
@@ -741,6 +749,15 @@ void AssemblerMIPS32::lw(const Operand *OpRt, const Operand *OpBase,
   }
 }
 
+void AssemblerMIPS32::lw(const Operand *OpRt, const Operand *OpBase,
+                         const Operand *OpOff, const RelocOp Reloc) {
+  if (OpRt->getType() != IceType_i32) {
+    llvm::report_fatal_error("lw: Relocatable offsets are only for i32 loads");
+  }
+  static constexpr IValueT Opcode = 0x8C000000;
+  emitRtRsImm16Rel(Opcode, OpRt, OpBase, OpOff, Reloc, "lw");
+}
+
 void AssemblerMIPS32::lwc1(const Operand *OpRt, const Operand *OpBase,
                            const Operand *OpOff, const RelocOp Reloc) {
   IValueT Opcode = 0xC4000000;
@@ -968,7 +985,7 @@ void AssemblerMIPS32::ori(const Operand *OpRt, const Operand *OpRs,
 void AssemblerMIPS32::ret(void) {
   static constexpr IValueT Opcode = 0x03E00008; // JR $31
   emitInst(Opcode);
-  nop(); // delay slot
+  emitDelaySlot();
 }
 
 void AssemblerMIPS32::sc(const Operand *OpRt, const Operand *OpBase,
@@ -1234,7 +1251,7 @@ void AssemblerMIPS32::emitBr(const CondMIPS32::Cond Cond, const Operand *OpRs,
 
   Opcode = encodeBranchOffset(Offset, Opcode);
   emitInst(Opcode);
-  nop(); // delay slot
+  emitDelaySlot();
 }
 
 void AssemblerMIPS32::bcc(const CondMIPS32::Cond Cond, const Operand *OpRs,
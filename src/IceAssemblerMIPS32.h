@@ -72,6 +72,10 @@ public:
 
   void nop();
 
+  /// Makes the next branch, jump or call leave its delay slot to the caller,
+  /// which emits the instruction filling it right after, instead of a nop.
+  void fillNextDelaySlot() { DelaySlotFilled = true; }
+
   void emitRsRt(IValueT Opcode, const Operand *OpRs, const Operand *OpRt,
                 const char *InsnName);
 
@@ -199,6 +203,9 @@ public:
 
   void lw(const Operand *OpRt, const Operand *OpBase, const uint32_t Offset);
 
+  void lw(const Operand *OpRt, const Operand *OpBase, const Operand *OpOff,
+          const RelocOp Reloc);
+
   void lwc1(const Operand *OpRt, const Operand *OpBase, const Operand *OpOff,
             const RelocOp Reloc);
 
@@ -385,6 +392,11 @@ private:
 
   void bindCfgNodeLabel(const CfgNode *) override;
 
+  /// Emits a nop into the delay slot of the control transfer just emitted,
+  /// unless fillNextDelaySlot() was called.
+  void emitDelaySlot();
+  bool DelaySlotFilled = false;
+
   void emitInst(IValueT Value) {
     AssemblerBuffer::EnsureCapacity _(&Buffer);
     Buffer.emit<IValueT>(Value);
@@ -212,6 +212,17 @@ public:
     TypedEmitGPRGPRImm GPRGPRImm;
   };
 
+  using TypedEmitGPRGPRGPR = void (AssemblerX86Base::*)(Type, GPRRegister,
+                                                        GPRRegister,
+                                                        GPRRegister);
+  using TypedEmitGPRAddrGPR = void (AssemblerX86Base::*)(Type, GPRRegister,
+                                                         const Address &,
+                                                         GPRRegister);
+  struct GPREmitterShiftx {
+    TypedEmitGPRGPRGPR GPRGPRGPR;
+    TypedEmitGPRAddrGPR GPRAddrGPR;
+  };
+
   using TypedEmitAddrGPR = void (AssemblerX86Base::*)(Type, const Address &,
                                                       GPRRegister);
   using TypedEmitAddrImm = void (AssemblerX86Base::*)(Type, const Address &,
@@ -226,9 +237,18 @@ public:
                                                      XmmRegister);
   using TypedEmitXmmAddr = void (AssemblerX86Base::*)(Type, XmmRegister,
                                                       const Address &);
+  using TypedEmitXmmXmmXmm = void (AssemblerX86Base::*)(Type, XmmRegister,
+                                                        XmmRegister,
+                                                        XmmRegister);
+  using TypedEmitXmmXmmAddr = void (AssemblerX86Base::*)(Type, XmmRegister,
+                                                         XmmRegister,
+                                                         const Address &);
   struct XmmEmitterRegOp {
     TypedEmitXmmXmm XmmXmm;
     TypedEmitXmmAddr XmmAddr;
+    // The non-destructive AVX forms, or null if the instruction has none.
+    TypedEmitXmmXmmXmm VexXmmXmmXmm;
+    TypedEmitXmmXmmAddr VexXmmXmmAddr;
   };
 
   using EmitXmmXmm = void (AssemblerX86Base::*)(XmmRegister, XmmRegister);
@@ -521,6 +541,85 @@ public:
   void round(Type Ty, XmmRegister dst, const Address &src,
              const Immediate &mode);
 
+  // AVX forms of the SSE instructions above. They are VEX.128 encoded, take
+  // the first source operand separately from dst, and leave it intact.
+  void vaddps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vaddps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vsubps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vsubps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vmulps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vmulps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vdivps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vdivps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vminps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vminps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vmaxps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vmaxps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vandps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vandps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vandnps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vandnps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vorps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vorps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vxorps(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vxorps(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vaddss(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vaddss(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vsubss(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vsubss(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vmulss(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vmulss(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vdivss(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vdivss(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vminss(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vminss(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vmaxss(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vmaxss(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpadd(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpadd(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpsub(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpsub(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpadds(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpadds(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpsubs(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpsubs(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpaddus(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpaddus(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpsubus(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpsubus(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpand(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpand(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpandn(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpandn(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpor(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpor(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpxor(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpxor(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpmull(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpmull(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpmuludq(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpmuludq(Type Ty, XmmRegister dst, XmmRegister src0,
+                const Address &src1);
+  void vpcmpeq(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpcmpeq(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpcmpgt(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpcmpgt(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpshufb(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpshufb(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpunpckl(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpunpckl(Type Ty, XmmRegister dst, XmmRegister src0,
+                const Address &src1);
+  void vpunpckh(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpunpckh(Type Ty, XmmRegister dst, XmmRegister src0,
+                const Address &src1);
+  void vpackss(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpackss(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  void vpackus(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+  void vpackus(Type Ty, XmmRegister dst, XmmRegister src0, const Address &src1);
+  // Merges the low element of src1 with the upper elements of src0. There is
+  // no such form with a memory operand.
+  void vmovss(Type Ty, XmmRegister dst, XmmRegister src0, XmmRegister src1);
+
   //----------------------------------------------------------------------------
   //
   // Begin: X87 instructions. Only available when Traits::UsesX87.
@@ -681,6 +780,15 @@ public:
   void shrd(Type Ty, GPRRegister dst, GPRRegister src, const Immediate &imm);
   void shrd(Type Ty, const Address &dst, GPRRegister src);
 
+  // BMI2 shifts. They take the count in any register, leave the source intact,
+  // and don't change the flags.
+  void shlx(Type Ty, GPRRegister dst, GPRRegister src, GPRRegister shifter);
+  void shlx(Type Ty, GPRRegister dst, const Address &src, GPRRegister shifter);
+  void shrx(Type Ty, GPRRegister dst, GPRRegister src, GPRRegister shifter);
+  void shrx(Type Ty, GPRRegister dst, const Address &src, GPRRegister shifter);
+  void sarx(Type Ty, GPRRegister dst, GPRRegister src, GPRRegister shifter);
+  void sarx(Type Ty, GPRRegister dst, const Address &src, GPRRegister shifter);
+
   void neg(Type Ty, GPRRegister reg);
   void neg(Type Ty, const Address &addr);
   void notl(GPRRegister reg);
@@ -690,6 +798,15 @@ public:
   void bsr(Type Ty, GPRRegister dst, GPRRegister src);
   void bsr(Type Ty, GPRRegister dst, const Address &src);
 
+  // Unlike bsf and bsr, these are defined for a zero source, for which they
+  // return the operand width in bits and set CF.
+  void popcnt(Type Ty, GPRRegister dst, GPRRegister src);
+  void popcnt(Type Ty, GPRRegister dst, const Address &src);
+  void lzcnt(Type Ty, GPRRegister dst, GPRRegister src);
+  void lzcnt(Type Ty, GPRRegister dst, const Address &src);
+  void tzcnt(Type Ty, GPRRegister dst, GPRRegister src);
+  void tzcnt(Type Ty, GPRRegister dst, const Address &src);
+
   void bswap(Type Ty, GPRRegister reg);
 
   void bt(GPRRegister base, GPRRegister offset);
@@ -709,6 +826,17 @@ public:
 
   void jmp(GPRRegister reg);
   void jmp(Label *label, bool near = kFarJump);
+
+  /// Branch relaxation: these variants emit a forward branch with a rel8
+  /// displacement, unless an earlier emission of the function found that the
+  /// branch does not reach its target, in which case they use a rel32
+  /// displacement. The branch is identified by the instruction that emits it
+  /// (Owner) and its index among that instruction's branches, which stay the
+  /// same when the function is emitted again.
+  void j(BrCond condition, Label *label, const void *Owner, SizeT Index);
+  void jmp(Label *label, const void *Owner, SizeT Index);
+  bool needsReemission() const override { return RelaxationFailed; }
+  void resetForReemission() override;
   void jmp(const ConstantRelocatable *label); // not testable.
   void jmp(const Immediate &abs_address);
 
@@ -772,6 +900,108 @@ private:
   void emitGenericShift(int rm, Type Ty, const Operand &operand,
                         GPRRegister shifter);
 
+  // The F3 0F-prefixed bit counting instructions: popcnt, lzcnt, and tzcnt.
+  void emitBitCount(uint8_t Opcode, Type Ty, GPRRegister dst, GPRRegister src);
+  void emitBitCount(uint8_t Opcode, Type Ty, GPRRegister dst,
+                    const Address &src);
+
+  // The legacy prefix and the escape bytes that the VEX prefix implies, in the
+  // encoding of its pp and mmmmm fields.
+  enum VexPrefix {
+    VexPrefixNone = 0,
+    VexPrefix66 = 1,
+    VexPrefixF3 = 2,
+    VexPrefixF2 = 3
+  };
+  enum VexMap { VexMap0F = 1, VexMap0F38 = 2, VexMap0F3A = 3 };
+
+  // emitVex emits the VEX prefix. R, X, and B extend the ModRM reg, SIB index,
+  // and ModRM rm (or SIB base) fields, as they do in a REX prefix, and Vvvv is
+  // the extra register operand. The two-byte form is used whenever it can
+  // encode the instruction. The VEX prefix replaces the REX prefix, so a VEX
+  // encoded instruction never has both.
+  void emitVex(VexMap Map, VexPrefix Prefix, bool W, bool L, bool R, bool X,
+               bool B, uint8_t Vvvv) {
+    if (Map == VexMap0F && !W && !X && !B) {
+      emitUint8(0xC5);
+      emitUint8((R ? 0x00 : 0x80) | ((~Vvvv & 0x0F) << 3) |
+                (L ? 0x04 : 0x00) | Prefix);
+      return;
+    }
+    emitUint8(0xC4);
+    emitUint8((R ? 0x00 : 0x80) | (X ? 0x00 : 0x40) | (B ? 0x00 : 0x20) |
+              Map);
+    emitUint8((W ? 0x80 : 0x00) | ((~Vvvv & 0x0F) << 3) | (L ? 0x04 : 0x00) |
+              Prefix);
+  }
+
+  // emitVexRB emits the VEX prefix of an instruction with two register
+  // operands in its ModRM byte, and emitVexAddr the one of an instruction with
+  // a register and an address. Vvvv is the full register encoding.
+  template <typename RegType, typename RmType>
+  void emitVexRB(VexMap Map, VexPrefix Prefix, bool W, bool L,
+                 const RegType Reg, uint8_t Vvvv, const RmType Rm) {
+    emitVex(Map, Prefix, W, L, (Reg & 0x08) != 0, false, (Rm & 0x08) != 0,
+            Vvvv);
+  }
+
+  template <typename RegType>
+  void emitVexAddr(VexMap Map, VexPrefix Prefix, bool W, bool L,
+                   const RegType Reg, uint8_t Vvvv, const Address &Addr) {
+    emitVex(Map, Prefix, W, L, (Reg & 0x08) != 0, addrRexX(&Addr),
+            addrRexB(&Addr), Vvvv);
+  }
+
+  template <typename T = Traits>
+  typename std::enable_if<T::Is64Bit, bool>::type
+  addrRexX(const typename T::Address *Addr) {
+    return Addr->rexX() != T::Operand::RexNone;
+  }
+  template <typename T = Traits>
+  typename std::enable_if<!T::Is64Bit, bool>::type
+  addrRexX(const typename T::Address *) {
+    return false;
+  }
+  template <typename T = Traits>
+  typename std::enable_if<T::Is64Bit, bool>::type
+  addrRexB(const typename T::Address *Addr) {
+    return Addr->rexB() != T::Operand::RexNone;
+  }
+  template <typename T = Traits>
+  typename std::enable_if<!T::Is64Bit, bool>::type
+  addrRexB(const typename T::Address *) {
+    return false;
+  }
+
+  // shlx, shrx, and sarx only differ in their implied legacy prefix.
+  void emitGenericShiftx(VexPrefix Prefix, Type Ty, GPRRegister dst,
+                         GPRRegister src, GPRRegister shifter);
+  void emitGenericShiftx(VexPrefix Prefix, Type Ty, GPRRegister dst,
+                         const Address &src, GPRRegister shifter);
+
+  // emitVexXmm emits a VEX.128 encoded XMM instruction, dst := src0 op src1,
+  // with src0 in VEX.vvvv.
+  void emitVexXmm(VexMap Map, VexPrefix Prefix, uint8_t Opcode, XmmRegister dst,
+                  XmmRegister src0, XmmRegister src1);
+  void emitVexXmm(VexMap Map, VexPrefix Prefix, uint8_t Opcode, XmmRegister dst,
+                  XmmRegister src0, const Address &src1);
+  // The VEX.pp field that selects the single or double precision form of the
+  // packed and scalar floating point instructions.
+  static VexPrefix vexPrefixPs(Type Ty) {
+    return isFloat32Asserting32Or64(Ty) ? VexPrefixNone : VexPrefix66;
+  }
+  static VexPrefix vexPrefixSs(Type Ty) {
+    return isFloat32Asserting32Or64(Ty) ? VexPrefixF3 : VexPrefixF2;
+  }
+  // The opcode of the byte, word, or doubleword variant of a packed integer
+  // instruction, for the element type Ty.
+  static uint8_t packedOpcode(Type Ty, uint8_t ByteOpcode, uint8_t WordOpcode,
+                              uint8_t DwordOpcode) {
+    if (isByteSizedArithType(Ty))
+      return ByteOpcode;
+    return Ty == IceType_i16 ? WordOpcode : DwordOpcode;
+  }
+
   using LabelVector = std::vector<Label *>;
   // A vector of pool-allocated x86 labels for CFG nodes.
   LabelVector CfgNodeLabels;
@@ -780,6 +1010,16 @@ private:
 
   Label *getOrCreateLabel(SizeT Number, LabelVector &Labels);
 
+  using RelaxableBranch = std::pair<const void *, SizeT>;
+  /// Relaxable branches that need a rel32 displacement.
+  std::set<RelaxableBranch> LongBranches;
+  /// Maps the position of the rel8 displacement of every relaxable branch to
+  /// a label that is not bound yet to the branch.
+  std::unordered_map<intptr_t, RelaxableBranch> ShortBranchPositions;
+  /// True if a relaxable branch was found not to reach its target during the
+  /// current emission of the function.
+  bool RelaxationFailed = false;
+
   void emitAddrSizeOverridePrefix() {
     if (!Traits::Is64Bit || !EmitAddrSizeOverridePrefix) {
       return;
@@ -2492,6 +2492,525 @@ void AssemblerX86Base<TraitsType>::round(Type Ty, XmmRegister dst,
   emitUint8(static_cast<uint8_t>(mode.value()) | 0x8);
 }
 
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vaddps(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefixNone, 0x58, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vaddps(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefixNone, 0x58, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vsubps(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefixNone, 0x5C, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vsubps(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefixNone, 0x5C, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vmulps(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefixNone, 0x59, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vmulps(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefixNone, 0x59, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vdivps(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefixNone, 0x5E, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vdivps(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefixNone, 0x5E, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vminps(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x5D, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vminps(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x5D, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vmaxps(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x5F, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vmaxps(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x5F, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vandps(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x54, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vandps(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x54, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vandnps(Type Ty, XmmRegister dst,
+                                           XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x55, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vandnps(Type Ty, XmmRegister dst,
+                                           XmmRegister src0,
+                                           const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x55, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vorps(Type Ty, XmmRegister dst,
+                                         XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x56, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vorps(Type Ty, XmmRegister dst,
+                                         XmmRegister src0,
+                                         const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x56, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vxorps(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x57, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vxorps(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixPs(Ty), 0x57, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vaddss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x58, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vaddss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x58, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vsubss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x5C, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vsubss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x5C, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vmulss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x59, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vmulss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x59, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vdivss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x5E, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vdivss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x5E, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vminss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x5D, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vminss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x5D, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vmaxss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x5F, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vmaxss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x5F, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpadd(Type Ty, XmmRegister dst,
+                                         XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, packedOpcode(Ty, 0xFC, 0xFD, 0xFE), dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpadd(Type Ty, XmmRegister dst,
+                                         XmmRegister src0,
+                                         const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, packedOpcode(Ty, 0xFC, 0xFD, 0xFE), dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpsub(Type Ty, XmmRegister dst,
+                                         XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, packedOpcode(Ty, 0xF8, 0xF9, 0xFA), dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpsub(Type Ty, XmmRegister dst,
+                                         XmmRegister src0,
+                                         const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, packedOpcode(Ty, 0xF8, 0xF9, 0xFA), dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpadds(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  assert(isByteSizedArithType(Ty) || Ty == IceType_i16);
+  emitVexXmm(VexMap0F, VexPrefix66, isByteSizedArithType(Ty) ? 0xEC : 0xED, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpadds(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  assert(isByteSizedArithType(Ty) || Ty == IceType_i16);
+  emitVexXmm(VexMap0F, VexPrefix66, isByteSizedArithType(Ty) ? 0xEC : 0xED, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpsubs(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  assert(isByteSizedArithType(Ty) || Ty == IceType_i16);
+  emitVexXmm(VexMap0F, VexPrefix66, isByteSizedArithType(Ty) ? 0xE8 : 0xE9, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpsubs(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  assert(isByteSizedArithType(Ty) || Ty == IceType_i16);
+  emitVexXmm(VexMap0F, VexPrefix66, isByteSizedArithType(Ty) ? 0xE8 : 0xE9, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpaddus(Type Ty, XmmRegister dst,
+                                           XmmRegister src0, XmmRegister src1) {
+  assert(isByteSizedArithType(Ty) || Ty == IceType_i16);
+  emitVexXmm(VexMap0F, VexPrefix66, isByteSizedArithType(Ty) ? 0xDC : 0xDD, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpaddus(Type Ty, XmmRegister dst,
+                                           XmmRegister src0,
+                                           const Address &src1) {
+  assert(isByteSizedArithType(Ty) || Ty == IceType_i16);
+  emitVexXmm(VexMap0F, VexPrefix66, isByteSizedArithType(Ty) ? 0xDC : 0xDD, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpsubus(Type Ty, XmmRegister dst,
+                                           XmmRegister src0, XmmRegister src1) {
+  assert(isByteSizedArithType(Ty) || Ty == IceType_i16);
+  emitVexXmm(VexMap0F, VexPrefix66, isByteSizedArithType(Ty) ? 0xD8 : 0xD9, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpsubus(Type Ty, XmmRegister dst,
+                                           XmmRegister src0,
+                                           const Address &src1) {
+  assert(isByteSizedArithType(Ty) || Ty == IceType_i16);
+  emitVexXmm(VexMap0F, VexPrefix66, isByteSizedArithType(Ty) ? 0xD8 : 0xD9, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpand(Type /* Ty */, XmmRegister dst,
+                                         XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xDB, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpand(Type /* Ty */, XmmRegister dst,
+                                         XmmRegister src0,
+                                         const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xDB, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpandn(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xDF, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpandn(Type /* Ty */, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xDF, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpor(Type /* Ty */, XmmRegister dst,
+                                        XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xEB, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpor(Type /* Ty */, XmmRegister dst,
+                                        XmmRegister src0, const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xEB, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpxor(Type /* Ty */, XmmRegister dst,
+                                         XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xEF, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpxor(Type /* Ty */, XmmRegister dst,
+                                         XmmRegister src0,
+                                         const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xEF, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpmull(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  if (Ty == IceType_i16) {
+    emitVexXmm(VexMap0F, VexPrefix66, 0xD5, dst, src0, src1);
+  } else {
+    assert(Ty == IceType_i32);
+    emitVexXmm(VexMap0F38, VexPrefix66, 0x40, dst, src0, src1);
+  }
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpmull(Type Ty, XmmRegister dst,
+                                          XmmRegister src0,
+                                          const Address &src1) {
+  if (Ty == IceType_i16) {
+    emitVexXmm(VexMap0F, VexPrefix66, 0xD5, dst, src0, src1);
+  } else {
+    assert(Ty == IceType_i32);
+    emitVexXmm(VexMap0F38, VexPrefix66, 0x40, dst, src0, src1);
+  }
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpmuludq(Type /* Ty */, XmmRegister dst,
+                                            XmmRegister src0,
+                                            XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xF4, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpmuludq(Type /* Ty */, XmmRegister dst,
+                                            XmmRegister src0,
+                                            const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, 0xF4, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpcmpeq(Type Ty, XmmRegister dst,
+                                           XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, packedOpcode(Ty, 0x74, 0x75, 0x76), dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpcmpeq(Type Ty, XmmRegister dst,
+                                           XmmRegister src0,
+                                           const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, packedOpcode(Ty, 0x74, 0x75, 0x76), dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpcmpgt(Type Ty, XmmRegister dst,
+                                           XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, packedOpcode(Ty, 0x64, 0x65, 0x66), dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpcmpgt(Type Ty, XmmRegister dst,
+                                           XmmRegister src0,
+                                           const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66, packedOpcode(Ty, 0x64, 0x65, 0x66), dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpshufb(Type /* Ty */, XmmRegister dst,
+                                           XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F38, VexPrefix66, 0x00, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpshufb(Type /* Ty */, XmmRegister dst,
+                                           XmmRegister src0,
+                                           const Address &src1) {
+  emitVexXmm(VexMap0F38, VexPrefix66, 0x00, dst, src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpunpckl(Type Ty, XmmRegister dst,
+                                            XmmRegister src0,
+                                            XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66,
+             packedOpcode(typeElementType(Ty), 0x60, 0x61, 0x62), dst, src0,
+             src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpunpckl(Type Ty, XmmRegister dst,
+                                            XmmRegister src0,
+                                            const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66,
+             packedOpcode(typeElementType(Ty), 0x60, 0x61, 0x62), dst, src0,
+             src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpunpckh(Type Ty, XmmRegister dst,
+                                            XmmRegister src0,
+                                            XmmRegister src1) {
+  emitVexXmm(VexMap0F, VexPrefix66,
+             packedOpcode(typeElementType(Ty), 0x68, 0x69, 0x6A), dst, src0,
+             src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpunpckh(Type Ty, XmmRegister dst,
+                                            XmmRegister src0,
+                                            const Address &src1) {
+  emitVexXmm(VexMap0F, VexPrefix66,
+             packedOpcode(typeElementType(Ty), 0x68, 0x69, 0x6A), dst, src0,
+             src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpackss(Type Ty, XmmRegister dst,
+                                           XmmRegister src0, XmmRegister src1) {
+  assert(Ty == IceType_v4i32 || Ty == IceType_v4f32 || Ty == IceType_v8i16);
+  emitVexXmm(VexMap0F, VexPrefix66, Ty == IceType_v8i16 ? 0x63 : 0x6B, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpackss(Type Ty, XmmRegister dst,
+                                           XmmRegister src0,
+                                           const Address &src1) {
+  assert(Ty == IceType_v4i32 || Ty == IceType_v4f32 || Ty == IceType_v8i16);
+  emitVexXmm(VexMap0F, VexPrefix66, Ty == IceType_v8i16 ? 0x63 : 0x6B, dst,
+             src0, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpackus(Type Ty, XmmRegister dst,
+                                           XmmRegister src0, XmmRegister src1) {
+  if (Ty == IceType_v8i16) {
+    emitVexXmm(VexMap0F, VexPrefix66, 0x67, dst, src0, src1);
+  } else {
+    assert(Ty == IceType_v4i32 || Ty == IceType_v4f32);
+    emitVexXmm(VexMap0F38, VexPrefix66, 0x2B, dst, src0, src1);
+  }
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vpackus(Type Ty, XmmRegister dst,
+                                           XmmRegister src0,
+                                           const Address &src1) {
+  if (Ty == IceType_v8i16) {
+    emitVexXmm(VexMap0F, VexPrefix66, 0x67, dst, src0, src1);
+  } else {
+    assert(Ty == IceType_v4i32 || Ty == IceType_v4f32);
+    emitVexXmm(VexMap0F38, VexPrefix66, 0x2B, dst, src0, src1);
+  }
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::vmovss(Type Ty, XmmRegister dst,
+                                          XmmRegister src0, XmmRegister src1) {
+  emitVexXmm(VexMap0F, vexPrefixSs(Ty), 0x10, dst, src0, src1);
+}
+
 template <typename TraitsType>
 template <typename T, typename>
 void AssemblerX86Base<TraitsType>::fnstcw(const typename T::Address &dst) {
@@ -3379,6 +3898,45 @@ void AssemblerX86Base<TraitsType>::shrd(Type Ty, const Address &dst,
   emitOperand(gprEncoding(src), dst);
 }
 
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::shlx(Type Ty, GPRRegister dst,
+                                        GPRRegister src, GPRRegister shifter) {
+  emitGenericShiftx(VexPrefix66, Ty, dst, src, shifter);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::shlx(Type Ty, GPRRegister dst,
+                                        const Address &src,
+                                        GPRRegister shifter) {
+  emitGenericShiftx(VexPrefix66, Ty, dst, src, shifter);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::shrx(Type Ty, GPRRegister dst,
+                                        GPRRegister src, GPRRegister shifter) {
+  emitGenericShiftx(VexPrefixF2, Ty, dst, src, shifter);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::shrx(Type Ty, GPRRegister dst,
+                                        const Address &src,
+                                        GPRRegister shifter) {
+  emitGenericShiftx(VexPrefixF2, Ty, dst, src, shifter);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::sarx(Type Ty, GPRRegister dst,
+                                        GPRRegister src, GPRRegister shifter) {
+  emitGenericShiftx(VexPrefixF3, Ty, dst, src, shifter);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::sarx(Type Ty, GPRRegister dst,
+                                        const Address &src,
+                                        GPRRegister shifter) {
+  emitGenericShiftx(VexPrefixF3, Ty, dst, src, shifter);
+}
+
 template <typename TraitsType>
 void AssemblerX86Base<TraitsType>::neg(Type Ty, GPRRegister reg) {
   AssemblerBuffer::EnsureCapacity ensured(&Buffer);
@@ -3481,6 +4039,42 @@ void AssemblerX86Base<TraitsType>::bsr(Type Ty, GPRRegister dst,
   emitOperand(gprEncoding(dst), src);
 }
 
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::popcnt(Type Ty, GPRRegister dst,
+                                          GPRRegister src) {
+  emitBitCount(0xB8, Ty, dst, src);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::popcnt(Type Ty, GPRRegister dst,
+                                          const Address &src) {
+  emitBitCount(0xB8, Ty, dst, src);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::lzcnt(Type Ty, GPRRegister dst,
+                                         GPRRegister src) {
+  emitBitCount(0xBD, Ty, dst, src);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::lzcnt(Type Ty, GPRRegister dst,
+                                         const Address &src) {
+  emitBitCount(0xBD, Ty, dst, src);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::tzcnt(Type Ty, GPRRegister dst,
+                                         GPRRegister src) {
+  emitBitCount(0xBC, Ty, dst, src);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::tzcnt(Type Ty, GPRRegister dst,
+                                         const Address &src) {
+  emitBitCount(0xBC, Ty, dst, src);
+}
+
 template <typename TraitsType>
 void AssemblerX86Base<TraitsType>::bt(GPRRegister base, GPRRegister offset) {
   AssemblerBuffer::EnsureCapacity ensured(&Buffer);
@@ -3617,6 +4211,16 @@ void AssemblerX86Base<TraitsType>::j(BrCond condition, Label *label,
   }
 }
 
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::j(BrCond condition, Label *label,
+                                     const void *Owner, SizeT Index) {
+  const RelaxableBranch Branch(Owner, Index);
+  const bool Near = !label->isBound() && LongBranches.count(Branch) == 0;
+  j(condition, label, Near);
+  if (Near && !getPreliminary())
+    ShortBranchPositions[Buffer.size() - 1] = Branch;
+}
+
 template <typename TraitsType>
 void AssemblerX86Base<TraitsType>::j(BrCond condition,
                                      const ConstantRelocatable *label) {
@@ -3662,6 +4266,25 @@ void AssemblerX86Base<TraitsType>::jmp(Label *label, bool near) {
   }
 }
 
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::jmp(Label *label, const void *Owner,
+                                       SizeT Index) {
+  const RelaxableBranch Branch(Owner, Index);
+  const bool Near = !label->isBound() && LongBranches.count(Branch) == 0;
+  jmp(label, Near);
+  if (Near && !getPreliminary())
+    ShortBranchPositions[Buffer.size() - 1] = Branch;
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::resetForReemission() {
+  Assembler::resetForReemission();
+  CfgNodeLabels.clear();
+  LocalLabels.clear();
+  ShortBranchPositions.clear();
+  RelaxationFailed = false;
+}
+
 template <typename TraitsType>
 void AssemblerX86Base<TraitsType>::jmp(const ConstantRelocatable *label) {
   AssemblerBuffer::EnsureCapacity ensured(&Buffer);
@@ -3856,7 +4479,16 @@ void AssemblerX86Base<TraitsType>::bind(Label *L) {
   while (L->hasNear()) {
     intptr_t Position = L->getNearPosition();
     const intptr_t Offset = Bound - (Position + 1);
-    assert(Utils::IsInt(8, Offset));
+    if (!Utils::IsInt(8, Offset)) {
+      // Only relaxable branches may be out of range. Record that this one
+      // needs a rel32 displacement when the function is emitted again.
+      auto Iter = ShortBranchPositions.find(Position);
+      if (Iter == ShortBranchPositions.end())
+        llvm::report_fatal_error("Near branch target out of range");
+      LongBranches.insert(Iter->second);
+      RelaxationFailed = true;
+      continue;
+    }
     Buffer.store<int8_t>(Position, Offset);
   }
   L->bindTo(Bound);
@@ -4027,5 +4659,87 @@ void AssemblerX86Base<TraitsType>::emitGenericShift(int rm, Type Ty,
   emitOperand(rm, operand);
 }
 
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::emitBitCount(uint8_t Opcode, Type Ty,
+                                                GPRRegister dst,
+                                                GPRRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&Buffer);
+  assert(Ty == IceType_i16 || Ty == IceType_i32 ||
+         (Traits::Is64Bit && Ty == IceType_i64));
+  if (Ty == IceType_i16)
+    emitOperandSizeOverride();
+  // The F3 prefix must precede the REX prefix.
+  emitUint8(0xF3);
+  emitRexRB(Ty, dst, src);
+  emitUint8(0x0F);
+  emitUint8(Opcode);
+  emitRegisterOperand(gprEncoding(dst), gprEncoding(src));
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::emitBitCount(uint8_t Opcode, Type Ty,
+                                                GPRRegister dst,
+                                                const Address &src) {
+  AssemblerBuffer::EnsureCapacity ensured(&Buffer);
+  assert(Ty == IceType_i16 || Ty == IceType_i32 ||
+         (Traits::Is64Bit && Ty == IceType_i64));
+  if (Ty == IceType_i16)
+    emitOperandSizeOverride();
+  emitAddrSizeOverridePrefix();
+  emitUint8(0xF3);
+  emitRex(Ty, src, dst);
+  emitUint8(0x0F);
+  emitUint8(Opcode);
+  emitOperand(gprEncoding(dst), src);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::emitVexXmm(VexMap Map, VexPrefix Prefix,
+                                              uint8_t Opcode, XmmRegister dst,
+                                              XmmRegister src0,
+                                              XmmRegister src1) {
+  AssemblerBuffer::EnsureCapacity ensured(&Buffer);
+  emitVexRB(Map, Prefix, false, false, dst, src0, src1);
+  emitUint8(Opcode);
+  emitXmmRegisterOperand(dst, src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::emitVexXmm(VexMap Map, VexPrefix Prefix,
+                                              uint8_t Opcode, XmmRegister dst,
+                                              XmmRegister src0,
+                                              const Address &src1) {
+  AssemblerBuffer::EnsureCapacity ensured(&Buffer);
+  emitAddrSizeOverridePrefix();
+  emitVexAddr(Map, Prefix, false, false, dst, src0, src1);
+  emitUint8(Opcode);
+  emitOperand(gprEncoding(dst), src1);
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::emitGenericShiftx(VexPrefix Prefix, Type Ty,
+                                                     GPRRegister dst,
+                                                     GPRRegister src,
+                                                     GPRRegister shifter) {
+  AssemblerBuffer::EnsureCapacity ensured(&Buffer);
+  assert(Ty == IceType_i32 || (Traits::Is64Bit && Ty == IceType_i64));
+  emitVexRB(VexMap0F38, Prefix, Ty == IceType_i64, false, dst, shifter, src);
+  emitUint8(0xF7);
+  emitRegisterOperand(gprEncoding(dst), gprEncoding(src));
+}
+
+template <typename TraitsType>
+void AssemblerX86Base<TraitsType>::emitGenericShiftx(VexPrefix Prefix, Type Ty,
+                                                     GPRRegister dst,
+                                                     const Address &src,
+                                                     GPRRegister shifter) {
+  AssemblerBuffer::EnsureCapacity ensured(&Buffer);
+  assert(Ty == IceType_i32 || (Traits::Is64Bit && Ty == IceType_i64));
+  emitAddrSizeOverridePrefix();
+  emitVexAddr(VexMap0F38, Prefix, Ty == IceType_i64, false, dst, shifter, src);
+  emitUint8(0xF7);
+  emitOperand(gprEncoding(dst), src);
+}
+
 } // end of namespace X86NAMESPACE
 } // end of namespace Ice
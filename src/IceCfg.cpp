@@ -44,6 +44,8 @@ Cfg::Cfg(GlobalContext *Ctx, uint32_t SequenceNumber)
   Target = TargetLowering::createLowering(getFlags().getTargetArch(), this);
   VMetadata.reset(new VariablesMetadata(this));
   TargetAssembler = Target->createAssembler();
+  if (getFlags().isFunctionReportEnabled())
+    Report = makeUnique<FunctionReport>();
 
   if (getFlags().getRandomizeAndPoolImmediatesOption() == RPI_Randomize) {
     // If -randomize-pool-immediates=randomize, create a random number
@@ -215,10 +217,23 @@ void Cfg::translate() {
   // Cache the possibly-overridden optimization level once translation begins.
   // It would be nicer to do this in the constructor, but we need to wait until
   // after setFunctionName() has a chance to be called.
-  OptimizationLevel =
-      getFlags().matchForceO2(getFunctionName(), getSequenceNumber())
-          ? Opt_2
-          : getFlags().getOptLevel();
+  const bool ForceO2 =
+      getFlags().matchForceO2(getFunctionName(), getSequenceNumber());
+  OptimizationLevel = ForceO2 ? Opt_2 : getFlags().getOptLevel();
+  // Liveness analysis and register allocation scale super-linearly, so
+  // functions that are too big for the -O2 budget are demoted to -Om1 to bound
+  // the translation time. Functions selected by -force-O2 are exempt.
+  if (OptimizationLevel == Opt_2 && !ForceO2 && exceedsO2Budget()) {
+    OptimizationLevel = Opt_m1;
+    getContext()->statsUpdateO2Demotions();
+    if (BuildDefs::dump() && isVerbose(IceV_Status)) {
+      OstreamLocker L(getContext());
+      getContext()->getStrDump()
+          << "Demoting " << getFunctionName() << " to -Om1: "
+          << getNumLiveInsts() << " instructions, " << getNumVariables()
+          << " variables\n";
+    }
+  }
   if (BuildDefs::timers()) {
     if (getFlags().matchTimingFocus(getFunctionName(), getSequenceNumber())) {
       setFocusedTiming();
@@ -235,6 +250,14 @@ void Cfg::translate() {
   }
   TimerMarker T_func(getContext(), getFunctionName().toStringOrEmpty());
   TimerMarker T(TimerStack::TT_translate, this);
+  double StartTime = 0;
+  if (Report != nullptr) {
+    Report->Name = getFunctionName().toStringOrEmpty();
+    Report->SequenceNumber = getSequenceNumber();
+    Report->Thread = getContext()->getThreadName();
+    Report->InstsBefore = getNumLiveInsts();
+    StartTime = TimerStack::timestamp();
+  }
 
   dump("Initial CFG");
 
@@ -267,6 +290,11 @@ void Cfg::translate() {
   // target.
   getTarget()->translate();
 
+  if (Report != nullptr) {
+    Report->InstsAfter = getNumLiveInsts();
+    Report->TranslateTime = TimerStack::timestamp() - StartTime;
+  }
+
   dump("Final output");
   if (getFocusedTiming()) {
     getContext()->dumpLocalTimers(getFunctionName().toString());
@@ -333,9 +361,18 @@ void Cfg::computeInOutEdges() {
 
 void Cfg::renumberInstructions() {
   TimerMarker T(TimerStack::TT_renumberInstructions, this);
+  Ctx->statsUpdateRenumberings();
+  const InstNumberT LastFreshNumber = NextInstNumber;
   NextInstNumber = Inst::NumberInitial;
   for (CfgNode *Node : Nodes)
     Node->renumberInstructions();
+  // New instructions are numbered past any instruction created so far, so that
+  // one created before this renumbering and inserted after it is not mistaken
+  // for a fresh one.
+  NextInstNumber = std::max(NextInstNumber, LastFreshNumber);
+  FirstUnplacedNumber = NextInstNumber;
+  NumUnplacedInsts = 0;
+  InstNumbersUnordered = false;
   // Make sure the entry node is the first node and therefore got the lowest
   // instruction numbers, to facilitate live range computation of function
   // arguments.  We want to model function arguments as being live on entry to
@@ -346,6 +383,56 @@ void Cfg::renumberInstructions() {
   assert(Nodes.empty() || (*Nodes.begin() == getEntryNode()));
 }
 
+InstNumberT Cfg::newInstNumber() {
+  const InstNumberT Number = NextInstNumber;
+  NextInstNumber += Inst::NumberStride;
+  ++NumUnplacedInsts;
+  return Number;
+}
+
+void Cfg::placeInstNumber(CfgNode *Node, Inst *Instr) {
+  // Until the first renumbering, instructions keep their creation order
+  // numbers, which -Om1 relies on because it never renumbers.
+  if (FirstUnplacedNumber == 0)
+    return;
+  // A fresh instruction is counted as unplaced until it gets a number in a gap.
+  // An older one, e.g. one that is moved, keeps its number if that is still in
+  // order.
+  const bool Fresh = Instr->getNumber() >= FirstUnplacedNumber;
+  InstList &Insts = Node->getInsts();
+  auto I = instToIterator(Instr);
+  auto Next = std::next(I);
+  // At the start of the list, the gap before Instr may hold the numbers of
+  // instructions inserted at the end of the previous node.
+  const InstNumberT Prev =
+      (I == Insts.begin()) ? Inst::NumberSentinel : std::prev(I)->getNumber();
+  // Renumbering leaves the instructions on a grid of NumberStride, so the gap
+  // after Prev ends at the next grid point, or earlier at Instr's successor.
+  // Deleted instructions that -keep-deleted-insts left in the list have no
+  // usable number, so don't try to place Instr next to them.
+  InstNumberT Limit = Prev;
+  if (Prev >= Inst::NumberInitial) {
+    Limit = Prev - (Prev - Inst::NumberInitial) % Inst::NumberStride +
+            Inst::NumberStride;
+    if (Next != Insts.end())
+      Limit = std::max(Prev, std::min(Limit, Next->getNumber()));
+  }
+  if (!Fresh && Prev < Instr->getNumber() && Instr->getNumber() < Limit)
+    return;
+  // Take the lowest free number rather than the midpoint, because lowering
+  // inserts runs of instructions, each one after the previous.
+  if (Prev + 1 >= Limit) {
+    if (!Fresh)
+      InstNumbersUnordered = true;
+    return;
+  }
+  Instr->setNumber(Prev + 1);
+  if (Fresh) {
+    assert(NumUnplacedInsts > 0);
+    --NumUnplacedInsts;
+  }
+}
+
 // placePhiLoads() must be called before placePhiStores().
 void Cfg::placePhiLoads() {
   TimerMarker T(TimerStack::TT_placePhiLoads, this);
@@ -392,7 +479,7 @@ void Cfg::advancedPhiLowering() {
     for (auto I = Nodes.begin() + NumNodes, E = Nodes.end(); I != E; ++I) {
       InstNumberT FirstInstNum = getNextInstNumber();
       (*I)->renumberInstructions();
-      InstNumberT LastInstNum = getNextInstNumber() - 1;
+      InstNumberT LastInstNum = getNextInstNumber() - Inst::NumberStride;
       (*I)->liveness(getLiveness());
       (*I)->livenessAddIntervals(getLiveness(), FirstInstNum, LastInstNum);
     }
@@ -902,6 +989,148 @@ void Cfg::floatConstantCSE() {
   }
 }
 
+namespace {
+/// A memory location is identified by a base address operand, a constant byte
+/// offset from it, and the type that is accessed there.
+struct MemoryLocation {
+  Operand *Base = nullptr;
+  int32_t Offset = 0;
+  Type Ty = IceType_void;
+};
+
+/// Splits an address into base and offset if it was computed as "base + C",
+/// which is how GEPs on struct fields and array elements come out of the
+/// bitcode.
+MemoryLocation getMemoryLocation(const VariablesMetadata *VMetadata,
+                                 Operand *Addr, Type Ty) {
+  MemoryLocation Loc;
+  Loc.Base = Addr;
+  Loc.Ty = Ty;
+  auto *Var = llvm::dyn_cast<Variable>(Addr);
+  if (Var == nullptr)
+    return Loc;
+  auto *Arith = llvm::dyn_cast_or_null<InstArithmetic>(
+      VMetadata->getSingleDefinition(Var));
+  if (Arith == nullptr || Arith->getOp() != InstArithmetic::Add)
+    return Loc;
+  for (SizeT I = 0; I < 2; ++I) {
+    auto *Offset = llvm::dyn_cast<ConstantInteger32>(Arith->getSrc(I));
+    Operand *Base = Arith->getSrc(1 - I);
+    if (Offset == nullptr || llvm::isa<Constant>(Base))
+      continue;
+    if (VMetadata->isMultiDef(llvm::cast<Variable>(Base)))
+      return Loc;
+    Loc.Base = Base;
+    Loc.Offset = Offset->getValue();
+    return Loc;
+  }
+  return Loc;
+}
+
+/// Returns true if the two locations can't overlap. Locations with different
+/// bases may always alias.
+bool isDisjoint(const MemoryLocation &A, const MemoryLocation &B) {
+  if (A.Base != B.Base)
+    return false;
+  const int64_t EndA = int64_t(A.Offset) + typeWidthInBytes(A.Ty);
+  const int64_t EndB = int64_t(B.Offset) + typeWidthInBytes(B.Ty);
+  return EndA <= B.Offset || EndB <= A.Offset;
+}
+} // end of anonymous namespace
+
+void Cfg::eliminateRedundantLoads() {
+  // Performs basic-block local redundant load elimination and store-to-load
+  // forwarding. If we have
+  //   store v, addr        or        v = load addr
+  //   ...                            ...
+  //   t = load addr                  t = load addr
+  // with no intervening store that may write to addr, the second load is
+  // replaced by the assignment "t = v".
+  // Points to note:
+  // 1. Assumes SSA, so that v still holds the loaded or stored value. Values
+  //    and addresses that VariablesMetadata finds to be multi-definition are
+  //    not tracked, which keeps it safe if the pass is moved later.
+  // 2. A store invalidates every location that it may overlap, i.e. all of
+  //    them except the ones at a known disjoint offset from the same base.
+  // 3. Calls, and intrinsic calls that write memory or have other side effects
+  //    (e.g. atomics and fences), invalidate everything.
+  TimerMarker T(TimerStack::TT_redundantLoadElim, this);
+  // Each block keeps at most this many locations, so that huge blocks can't
+  // make the search quadratic.
+  static constexpr SizeT MaxEntries = 32;
+  struct Entry {
+    MemoryLocation Loc;
+    Operand *Value;
+    bool FromStore;
+  };
+  const VariablesMetadata *VMetadata = getVMetadata();
+  auto isTracked = [VMetadata](const Operand *Opnd) {
+    auto *Var = llvm::dyn_cast<Variable>(Opnd);
+    return Var == nullptr || !VMetadata->isMultiDef(Var);
+  };
+  uint32_t NumLoads = 0, NumForwards = 0;
+  CfgVector<Entry> Available;
+  for (CfgNode *Node : getNodes()) {
+    Available.clear();
+    auto &Insts = Node->getInsts();
+    for (auto Iter = Insts.begin(), E = Insts.end(); Iter != E; ++Iter) {
+      Inst &Instr = *Iter;
+      if (Instr.isDeleted())
+        continue;
+      if (auto *Load = llvm::dyn_cast<InstLoad>(&Instr)) {
+        Variable *Dest = Load->getDest();
+        Operand *Addr = Load->getSourceAddress();
+        if (!isTracked(Addr) || !isTracked(Dest))
+          continue;
+        const MemoryLocation Loc =
+            getMemoryLocation(VMetadata, Addr, Dest->getType());
+        auto Found = std::find_if(
+            Available.begin(), Available.end(), [&Loc](const Entry &Item) {
+              return Item.Loc.Base == Loc.Base &&
+                     Item.Loc.Offset == Loc.Offset && Item.Loc.Ty == Loc.Ty;
+            });
+        if (Found != Available.end()) {
+          Insts.insert(Iter, InstAssign::create(this, Dest, Found->Value));
+          Load->setDeleted();
+          if (Found->FromStore)
+            ++NumForwards;
+          else
+            ++NumLoads;
+          continue;
+        }
+        if (Available.size() == MaxEntries)
+          Available.erase(Available.begin());
+        Available.push_back({Loc, Dest, false});
+        continue;
+      }
+      if (auto *Store = llvm::dyn_cast<InstStore>(&Instr)) {
+        Operand *Addr = Store->getAddr();
+        Operand *Data = Store->getData();
+        if (!isTracked(Addr)) {
+          Available.clear();
+          continue;
+        }
+        const MemoryLocation Loc =
+            getMemoryLocation(VMetadata, Addr, Data->getType());
+        Available.erase(std::remove_if(Available.begin(), Available.end(),
+                                       [&Loc](const Entry &Item) {
+                                         return !isDisjoint(Item.Loc, Loc);
+                                       }),
+                        Available.end());
+        if (!isTracked(Data) || llvm::isa<ConstantUndef>(Data))
+          continue;
+        if (Available.size() == MaxEntries)
+          Available.erase(Available.begin());
+        Available.push_back({Loc, Data, true});
+        continue;
+      }
+      if (Instr.isMemoryWrite() || Instr.hasSideEffects())
+        Available.clear();
+    }
+  }
+  getContext()->statsUpdateRLE(NumLoads, NumForwards);
+}
+
 void Cfg::doArgLowering() {
   TimerMarker T(TimerStack::TT_doArgLowering, this);
   getTarget()->lowerArguments();
@@ -1804,19 +2033,57 @@ void Cfg::emitIAS() {
   // The emitIAS() routines emit into the internal assembler buffer, so there's
   // no need to lock the streams.
   const bool NeedSandboxing = getFlags().getUseSandboxing();
-  for (CfgNode *Node : Nodes) {
-    if (NeedSandboxing && Node->needsAlignment())
-      getAssembler()->alignCfgNode();
-    Node->emitIAS(this);
+  Assembler *Asm = getAssembler();
+  assert(Asm->getBufferSize() == 0);
+  // The assembler may find that some of the short branches it optimistically
+  // emitted do not reach their targets, in which case the function is emitted
+  // again with those branches in their long form. Branches never get shorter,
+  // so this reaches a fixed point, and because each emission starts from
+  // scratch, the sandboxing alignment and bundle padding stay consistent with
+  // the final branch sizes.
+  while (true) {
+    for (CfgNode *Node : Nodes) {
+      if (NeedSandboxing && Node->needsAlignment())
+        Asm->alignCfgNode();
+      Node->emitIAS(this);
+    }
+    if (!Asm->needsReemission())
+      break;
+    Asm->resetForReemission();
   }
+  for (CfgNode *Node : Nodes)
+    Node->updateEmitStats(this);
   emitJumpTables();
 }
 
-size_t Cfg::getTotalMemoryMB() const {
-  constexpr size_t _1MB = 1024 * 1024;
+size_t Cfg::getTotalMemoryBytes() const {
   assert(Allocator != nullptr);
   assert(CfgAllocatorTraits::current() == Allocator.get());
-  return Allocator->getTotalMemory() / _1MB;
+  return Allocator->getTotalMemory();
+}
+
+size_t Cfg::getTotalMemoryMB() const {
+  constexpr size_t _1MB = 1024 * 1024;
+  return getTotalMemoryBytes() / _1MB;
+}
+
+bool Cfg::exceedsO2Budget() const {
+  const uint32_t MaxVariables = getFlags().getO2MaxVariables();
+  if (MaxVariables != 0 && getNumVariables() > MaxVariables)
+    return true;
+  const uint32_t MaxInsts = getFlags().getO2MaxInsts();
+  return MaxInsts != 0 && getNumLiveInsts() > MaxInsts;
+}
+
+SizeT Cfg::getNumLiveInsts() const {
+  SizeT Count = 0;
+  for (const CfgNode *Node : Nodes) {
+    for (const Inst &I : Node->getPhis())
+      Count += !I.isDeleted();
+    for (const Inst &I : Node->getInsts())
+      Count += !I.isDeleted();
+  }
+  return Count;
 }
 
 size_t Cfg::getLivenessMemoryMB() const {
@@ -19,6 +19,7 @@
 #include "IceAssembler.h"
 #include "IceClFlags.h"
 #include "IceDefs.h"
+#include "IceFunctionReport.h"
 #include "IceGlobalContext.h"
 #include "IceLoopAnalyzer.h"
 #include "IceStringPool.h"
@@ -105,8 +106,21 @@ public:
 
   /// \name Manage instruction numbering.
   /// @{
-  InstNumberT newInstNumber() { return NextInstNumber++; }
+  /// Returns a number past those of all existing instructions. A new
+  /// instruction with such a number is out of layout order wherever it is
+  /// inserted, until placeInstNumber() moves it into a gap.
+  InstNumberT newInstNumber();
   InstNumberT getNextInstNumber() const { return NextInstNumber; }
+  /// Gives the new instruction Instr, just inserted into Node's instruction
+  /// list, a number between those of its neighbors, if the gap after its
+  /// predecessor has room.
+  void placeInstNumber(CfgNode *Node, Inst *Instr);
+  /// Returns true if the instruction numbers are still in layout order since
+  /// the last renumberInstructions(), i.e. every instruction created since then
+  /// was placed with placeInstNumber(), and none was inserted without room.
+  bool hasOrderedInstNumbers() const {
+    return NumUnplacedInsts == 0 && !InstNumbersUnordered;
+  }
   /// @}
 
   /// \name Manage Variables.
@@ -140,6 +154,9 @@ public:
   void addJumpTable(InstJumpTable *JumpTable) {
     JumpTables.emplace_back(JumpTable);
   }
+  const CfgVector<InstJumpTable *> &getJumpTables() const {
+    return JumpTables;
+  }
   /// @}
 
   /// \name Manage the Globals used by this function.
@@ -175,6 +192,9 @@ public:
   bool hasComputedFrame() const;
   bool getFocusedTiming() const { return FocusedTiming; }
   void setFocusedTiming() { FocusedTiming = true; }
+  /// Returns the measurements collected for -function-report, or nullptr if
+  /// the report is disabled.
+  FunctionReport *getReport() const { return Report.get(); }
   uint32_t getConstantBlindingCookie() const { return ConstantBlindingCookie; }
   /// @}
 
@@ -207,6 +227,10 @@ public:
   void floatConstantCSE();
   void shortCircuitJumps();
   void loopInvariantCodeMotion();
+  /// Replaces loads of a location that was loaded or stored earlier in the same
+  /// block by assignments of the value loaded or stored. Requires
+  /// VariablesMetadata for at least VMK_SingleDefs.
+  void eliminateRedundantLoads();
 
   /// Scan allocas to determine whether we need to use a frame pointer.
   /// If SortAndCombine == true, merge all the fixed-size allocas in the
@@ -238,6 +262,7 @@ public:
   /// @}
 
   /// Get the total amount of memory held by the per-Cfg allocator.
+  size_t getTotalMemoryBytes() const;
   size_t getTotalMemoryMB() const;
 
   /// Get the current memory usage due to liveness data structures.
@@ -309,6 +334,11 @@ private:
   findLoopInvariantInstructions(const CfgUnorderedSet<SizeT> &Body);
 
   static ArenaAllocator *createAllocator();
+  /// Returns the number of instructions that are not deleted, including phis.
+  SizeT getNumLiveInsts() const;
+  /// Returns true if the function has more instructions or variables than
+  /// -o2-max-insts or -o2-max-vars allow for -O2 translation.
+  bool exceedsO2Budget() const;
 
   GlobalContext *Ctx;
   uint32_t SequenceNumber; /// output order for emission
@@ -324,6 +354,14 @@ private:
   CfgNode *Entry = nullptr; /// entry basic block
   NodeList Nodes;           /// linearized node list; Entry should be first
   InstNumberT NextInstNumber;
+  /// Number of instructions created since the last renumberInstructions() that
+  /// were not placed into a gap, including ones that were never inserted.
+  SizeT NumUnplacedInsts = 0;
+  /// Instructions numbered at or after FirstUnplacedNumber were created since
+  /// the last renumberInstructions(). It is 0 before the first one.
+  InstNumberT FirstUnplacedNumber = 0;
+  /// Set when an older instruction is inserted where there is no room for it.
+  bool InstNumbersUnordered = false;
   VarList Variables;
   VarList Args;         /// subset of Variables, in argument order
   VarList ImplicitArgs; /// subset of Variables
@@ -344,6 +382,7 @@ private:
   /// should be called to avoid spurious validation failures.
   const CfgNode *CurrentNode = nullptr;
   CfgVector<Loop> LoopInfo;
+  std::unique_ptr<FunctionReport> Report;
 
 public:
   static void TlsInit() { CfgAllocatorTraits::init(); }
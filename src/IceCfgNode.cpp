@@ -68,9 +68,12 @@ void CfgNode::replaceInEdge(CfgNode *Old, CfgNode *New) {
 }
 
 namespace {
+bool shouldRemoveDeleted() {
+  return BuildDefs::minimal() || !getFlags().getKeepDeletedInsts();
+}
+
 template <typename List> void removeDeletedAndRenumber(List *L, Cfg *Func) {
-  const bool DoDelete =
-      BuildDefs::minimal() || !getFlags().getKeepDeletedInsts();
+  const bool DoDelete = shouldRemoveDeleted();
   auto I = L->begin(), E = L->end(), Next = I;
   for (++Next; I != E; I = Next++) {
     if (DoDelete && I->isDeleted()) {
@@ -80,13 +83,29 @@ template <typename List> void removeDeletedAndRenumber(List *L, Cfg *Func) {
     }
   }
 }
+
+template <typename List> void removeDeleted(List *L) {
+  auto I = L->begin(), E = L->end(), Next = I;
+  for (++Next; I != E; I = Next++) {
+    if (I->isDeleted())
+      L->remove(I);
+  }
+}
 } // end of anonymous namespace
 
+void CfgNode::compactInsts() {
+  if (!shouldRemoveDeleted())
+    return;
+  removeDeleted(&Phis);
+  removeDeleted(&Insts);
+}
+
 void CfgNode::renumberInstructions() {
   InstNumberT FirstNumber = Func->getNextInstNumber();
   removeDeletedAndRenumber(&Phis, Func);
   removeDeletedAndRenumber(&Insts, Func);
-  InstCountEstimate = Func->getNextInstNumber() - FirstNumber;
+  InstCountEstimate =
+      (Func->getNextInstNumber() - FirstNumber) / Inst::NumberStride;
 }
 
 // When a node is created, the OutEdges are immediately known, but the InEdges
@@ -651,6 +670,10 @@ void CfgNode::genCode() {
   Context.availabilityReset();
   // Do preliminary lowering of the Phi instructions.
   Target->prelowerPhis();
+  // Lowering deleted every high-level instruction, so drop them now rather
+  // than have every later pass skip them. The numbering stays valid, so they
+  // would otherwise stay until the next renumbering, or for good at -Om1.
+  compactInsts();
 }
 
 void CfgNode::livenessLightweight() {
@@ -1061,15 +1084,22 @@ void updateStats(Cfg *Func, const Inst *I) {
   // Update emitted instruction count, plus fill/spill count for Variable
   // operands without a physical register.
   if (uint32_t Count = I->getEmitInstCount()) {
+    FunctionReport *Report = Func->getReport();
     Func->getContext()->statsUpdateEmitted(Count);
     if (Variable *Dest = I->getDest()) {
-      if (!Dest->hasReg())
+      if (!Dest->hasReg()) {
         Func->getContext()->statsUpdateFills();
+        if (Report != nullptr)
+          ++Report->Fills;
+      }
     }
     for (SizeT S = 0; S < I->getSrcSize(); ++S) {
       if (auto *Src = llvm::dyn_cast<Variable>(I->getSrc(S))) {
-        if (!Src->hasReg())
+        if (!Src->hasReg()) {
           Func->getContext()->statsUpdateSpills();
+          if (Report != nullptr)
+            ++Report->Spills;
+        }
       }
     }
   }
@@ -1290,10 +1320,8 @@ void CfgNode::emitIAS(Cfg *Func) const {
   // Do the simple emission if not sandboxed.
   if (!getFlags().getUseSandboxing()) {
     for (const Inst &I : Insts) {
-      if (!I.isDeleted() && !I.isRedundantAssign()) {
+      if (!I.isDeleted() && !I.isRedundantAssign())
         I.emitIAS(Func);
-        updateStats(Func, &I);
-      }
     }
     return;
   }
@@ -1359,9 +1387,6 @@ void CfgNode::emitIAS(Cfg *Func) const {
     // I points to a non bundle_lock/bundle_unlock instruction.
     if (Helper.isInBundleLockRegion()) {
       I->emitIAS(Func);
-      // Only update stats during the final pass.
-      if (Retrying)
-        updateStats(Func, iteratorToInst(I));
     } else {
       // Treat it as though there were an implicit bundle_lock and
       // bundle_unlock wrapping the instruction.
@@ -1371,7 +1396,6 @@ void CfgNode::emitIAS(Cfg *Func) const {
       Helper.rollback();
       Helper.padToNextBundle();
       I->emitIAS(Func);
-      updateStats(Func, iteratorToInst(I));
       Helper.leaveBundleLockRegion();
     }
   }
@@ -1382,6 +1406,13 @@ void CfgNode::emitIAS(Cfg *Func) const {
   assert(!Retrying);
 }
 
+void CfgNode::updateEmitStats(Cfg *Func) const {
+  for (const Inst &I : Insts) {
+    if (!I.isDeleted() && !I.isRedundantAssign())
+      updateStats(Func, &I);
+  }
+}
+
 void CfgNode::dump(Cfg *Func) const {
   if (!BuildDefs::dump())
     return;
@@ -79,6 +79,9 @@ public:
   const InstList &getInsts() const { return Insts; }
   const PhiList &getPhis() const { return Phis; }
   void appendInst(Inst *Instr);
+  /// Removes the deleted instructions from the lists, without renumbering,
+  /// unless -keep-deleted-insts asks to retain them.
+  void compactInsts();
   void renumberInstructions();
   /// Rough and generally conservative estimate of the number of instructions in
   /// the block. It is updated when an instruction is added, but not when
@@ -112,6 +115,9 @@ public:
   void doBranchOpt(const CfgNode *NextNode);
   void emit(Cfg *Func) const;
   void emitIAS(Cfg *Func) const;
+  /// Counts the node's instructions in the emission stats. This is separate
+  /// from emitIAS(), which may run more than once per function.
+  void updateEmitStats(Cfg *Func) const;
   void dump(Cfg *Func) const;
 
   void profileExecutionCount(VariableDeclaration *Var);
@@ -54,6 +54,8 @@ template <typename T> using list = llvm::cl::list<T>;
 
 using llvm::cl::NotHidden;
 
+using llvm::cl::Optional;
+
 template <typename T> using opt = llvm::cl::opt<T>;
 
 using llvm::cl::ParseCommandLineOptions;
@@ -88,6 +90,8 @@ template <typename... A> llvm::cl::ValuesClass values(A &&... Args) {
 #endif // !defined(clEnumValEnd)
 
 using llvm::cl::value_desc;
+
+using llvm::cl::ZeroOrMore;
 } // end of namespace cl
 
 // cl_type_traits is used to convert between a tuple of <T, cl_detail::*flag> to
@@ -131,6 +135,21 @@ void ClFlags::parseFlags(int argc, const char *const *argv) {
   AppNameObj = argv[0];
 }
 
+namespace {
+template <typename T> void allowRepeatedOccurrences(T &Opt) {
+  // The positional input file can't be repeated, and cl::list options already
+  // accept any number of occurrences.
+  if (!Opt.isPositional() && Opt.getNumOccurrencesFlag() == cl::Optional)
+    Opt.setNumOccurrencesFlag(cl::ZeroOrMore);
+}
+} // end of anonymous namespace
+
+void ClFlags::allowRepeatedFlags() {
+#define X(Name, Type, ClType, ...) allowRepeatedOccurrences(Name##Obj);
+  COMMAND_LINE_FLAGS
+#undef X
+}
+
 namespace {
 // flagInitOrStorageTypeDefault is some template voodoo for peeling off the
 // llvm::cl modifiers from a flag's declaration, until its initial value is
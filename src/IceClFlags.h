@@ -98,6 +98,12 @@ public:
   /// type cl::opt defined in IceClFlags.cpp
   static void parseFlags(int argc, const char *const *argv);
 
+  /// Lets a later parseFlags() give again the flags that were already parsed,
+  /// instead of failing with "may only occur once". The new occurrence of an
+  /// option replaces its value, and the values of a list are appended to. llvm
+  /// can't reset the occurrence counts without also resetting the values.
+  static void allowRepeatedFlags();
+
   /// Reset all configuration options to their nominal values.
   void resetClFlags();
 
@@ -143,8 +149,24 @@ private:
 
 public:
   bool isSequential() const { return NumTranslationThreads == 0; }
+  /// Function blocks are parsed in the translation threads, unless the inliner
+  /// needs to see every parsed function before any is translated.
   bool isParseParallel() const {
-    return getParseParallel() && !isSequential() && getBuildOnRead();
+    return getParseParallel() && !isSequential() && getBuildOnRead() &&
+           !getEnableInlining();
+  }
+  bool isFunctionReportEnabled() const {
+    return BuildDefs::dump() && !getFunctionReportFile().empty();
+  }
+  bool isTimingTraceEnabled() const {
+    return BuildDefs::timers() && !getTimingTraceFile().empty();
+  }
+  /// Whether -timing, -timing-focus, -timing-funcs, or -timing-trace reads the
+  /// timers.
+  bool isTimingEnabled() const {
+    return BuildDefs::timers() &&
+           (getSubzeroTimingEnabled() || !getTimingFocusOnString().empty() ||
+            getTimeEachFunction() || !getTimingTraceFile().empty());
   }
   std::string getAppName() const { return AppName; }
   void setAppName(const std::string &Value) { AppName = Value; }
@@ -39,11 +39,21 @@
 #pragma clang diagnostic pop
 #endif // __clang__
 
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <thread>
 
+#if !PNACL_BROWSER_TRANSLATOR
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // !PNACL_BROWSER_TRANSLATOR
+
 namespace Ice {
 
 namespace {
@@ -89,10 +99,9 @@ TextDataStreamer::create(const std::string &Filename, std::string *Err) {
 size_t TextDataStreamer::GetBytes(unsigned char *Buf, size_t Len) {
   if (Cursor >= BitcodeBuffer.size())
     return 0;
-  size_t Remaining = BitcodeBuffer.size();
+  size_t Remaining = BitcodeBuffer.size() - Cursor;
   Len = std::min(Len, Remaining);
-  for (size_t i = 0; i < Len; ++i)
-    Buf[i] = BitcodeBuffer[Cursor + i];
+  memcpy(Buf, BitcodeBuffer.data() + Cursor, Len);
   Cursor += Len;
   return Len;
 }
@@ -167,6 +176,40 @@ void dumpBuildAttributes(Ostream &Str) {
   Str << "revision_" << getSubzeroRevision() << "\n";
 }
 
+#if !PNACL_BROWSER_TRANSLATOR
+/// Prefix of the line that terminates the reply to a -compile-server request.
+/// It is followed by the request's exit status. A reply without this line
+/// means the request's process died (e.g. in report_fatal_error()).
+constexpr char ServerStatusPrefix[] = "pnacl-sz-status: ";
+
+/// Reads a compile server request from FD. A request is a sequence of
+/// newline-terminated lines: the client's working directory, followed by the
+/// pnacl-sz arguments (one per line), and terminated by an empty line. Returns
+/// false if the connection is closed before the request is complete.
+bool readServerRequest(int FD, std::vector<std::string> *Lines) {
+  std::string Request;
+  char Buffer[4096];
+  while (Request.find("\n\n") == std::string::npos) {
+    ssize_t BytesRead = ::read(FD, Buffer, sizeof(Buffer));
+    if (BytesRead < 0 && errno == EINTR)
+      continue;
+    if (BytesRead <= 0)
+      return false;
+    Request.append(Buffer, BytesRead);
+  }
+  Request.resize(Request.find("\n\n"));
+  size_t Start = 0;
+  while (Start <= Request.size()) {
+    size_t End = Request.find('\n', Start);
+    if (End == std::string::npos)
+      End = Request.size();
+    Lines->emplace_back(Request.substr(Start, End - Start));
+    Start = End + 1;
+  }
+  return true;
+}
+#endif // !PNACL_BROWSER_TRANSLATOR
+
 } // end of anonymous namespace
 
 void CLCompileServer::run() {
@@ -181,6 +224,119 @@ void CLCompileServer::run() {
   ClFlags &Flags = ClFlags::Flags;
   ClFlags::getParsedClFlags(Flags);
 
+  if (!BuildDefs::minimal() && !Flags.getCompileServerSocket().empty())
+    return runServer(Flags.getCompileServerSocket());
+  compile();
+}
+
+void CLCompileServer::runServer(const std::string &SocketPath) {
+#if PNACL_BROWSER_TRANSLATOR
+  (void)SocketPath;
+  llvm::report_fatal_error("-compile-server is not supported in the browser");
+#else  // !PNACL_BROWSER_TRANSLATOR
+  sockaddr_un Addr;
+  std::memset(&Addr, 0, sizeof(Addr));
+  Addr.sun_family = AF_UNIX;
+  if (SocketPath.size() >= sizeof(Addr.sun_path))
+    llvm::report_fatal_error("Compile server socket path too long: " +
+                             SocketPath);
+  std::strncpy(Addr.sun_path, SocketPath.c_str(), sizeof(Addr.sun_path) - 1);
+
+  const int ListenFD = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (ListenFD < 0)
+    llvm::report_fatal_error("Unable to create compile server socket");
+  // Remove a stale socket left behind by an earlier server, but nothing else,
+  // so that a mistyped path can't delete a regular file.
+  struct stat PathStat;
+  if (::lstat(Addr.sun_path, &PathStat) == 0) {
+    if (!S_ISSOCK(PathStat.st_mode)) {
+      ::close(ListenFD);
+      llvm::report_fatal_error(
+          "Compile server socket path exists and is not a socket: " +
+          SocketPath);
+    }
+    ::unlink(Addr.sun_path);
+  }
+  if (::bind(ListenFD, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) < 0 ||
+      ::listen(ListenFD, SOMAXCONN) < 0) {
+    ::close(ListenFD);
+    llvm::report_fatal_error("Unable to listen on compile server socket " +
+                             SocketPath + ": " + std::strerror(errno));
+  }
+  // Let the kernel reap the per-request processes.
+  std::signal(SIGCHLD, SIG_IGN);
+
+  // All the process-wide initialization (loading, static constructors, flag
+  // registration and parsing) has been paid for at this point. Each request is
+  // served by a fork of this process, which gets a pristine copy of that state,
+  // a fresh GlobalContext, and its own worker threads. A crash or a
+  // report_fatal_error() while serving a request only takes down that request.
+  while (true) {
+    const int ConnFD = ::accept(ListenFD, nullptr, nullptr);
+    if (ConnFD < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      break;
+    }
+    const pid_t Pid = ::fork();
+    if (Pid == 0) {
+      ::close(ListenFD);
+      std::signal(SIGCHLD, SIG_DFL);
+      serveRequest(ConnFD);
+      std::exit(getErrorCode().value());
+    }
+    if (Pid < 0) {
+      const std::string Msg = std::string("Unable to fork compile server: ") +
+                              std::strerror(errno) + "\n";
+      ssize_t Written = ::write(ConnFD, Msg.data(), Msg.size());
+      (void)Written; // The client treats a missing status as a failure.
+    }
+    ::close(ConnFD);
+  }
+  ::close(ListenFD);
+  llvm::report_fatal_error("Compile server stopped accepting connections: " +
+                           std::string(std::strerror(errno)));
+#endif // !PNACL_BROWSER_TRANSLATOR
+}
+
+void CLCompileServer::serveRequest(int FD) {
+#if PNACL_BROWSER_TRANSLATOR
+  (void)FD;
+#else  // !PNACL_BROWSER_TRANSLATOR
+  std::vector<std::string> Request;
+  if (!readServerRequest(FD, &Request) || Request.empty() ||
+      ::chdir(Request.front().c_str()) != 0) {
+    ::close(FD);
+    return transferErrorCode(EC_Args);
+  }
+  // The log and stdout output of the request (including "-o -" and
+  // "-log=-"/"-log=/dev/stderr") are sent back over the connection.
+  ::dup2(FD, STDOUT_FILENO);
+  ::dup2(FD, STDERR_FILENO);
+  ::close(FD);
+
+  // Append the request's arguments to the ones the server was started with. A
+  // flag that was already given at startup takes the request's value.
+  std::vector<const char *> Argv;
+  Argv.push_back(argv[0]);
+  for (size_t I = 1; I < Request.size(); ++I)
+    Argv.push_back(Request[I].c_str());
+  ClFlags::allowRepeatedFlags();
+  ClFlags::parseFlags(Argv.size(), Argv.data());
+  ClFlags::getParsedClFlags(ClFlags::Flags);
+  compile();
+
+  std::cout.flush();
+  const std::string Status = ServerStatusPrefix +
+                             std::to_string(getErrorCode().value()) + "\n";
+  ssize_t Written = ::write(STDOUT_FILENO, Status.data(), Status.size());
+  (void)Written; // The client treats a missing status as a failure.
+#endif // !PNACL_BROWSER_TRANSLATOR
+}
+
+void CLCompileServer::compile() {
+  ClFlags &Flags = ClFlags::Flags;
+
   // Override report_fatal_error if we want to exit with 0 status.
   if (Flags.getAlwaysExitSuccess())
     llvm::install_fatal_error_handler(reportFatalErrorThenExitSuccess, this);
@@ -201,6 +357,15 @@ void CLCompileServer::run() {
       *Ls << "Error: writing binary ELF to stdout is unsupported\n";
       return transferErrorCode(getReturnValue(Ice::EC_Args));
     }
+    if (!Flags.getGenerateBuildAtts()) {
+      // Prefer writing the object file through a memory mapping. Nothing is
+      // written to the text stream when emitting ELF.
+      if (auto MmapStr = ELFMmapStreamer::create(Flags.getOutputFilename())) {
+        ELFStr = std::move(MmapStr);
+        Os.reset(new llvm::raw_null_ostream());
+        break;
+      }
+    }
     std::unique_ptr<llvm::raw_fd_ostream> FdOs(new llvm::raw_fd_ostream(
         Flags.getOutputFilename(), EC, llvm::sys::fs::F_None));
     if (EC) {
@@ -35,11 +35,10 @@ namespace Ice {
 /// takes over the current thread to listen to requests, and compile requests
 /// are handled on separate threads.
 ///
-/// Currently, this only handles a single request.
-///
 /// When run on the commandline, it receives and therefore dispatches the
-/// request immediately. When run in the browser, it blocks waiting for a
-/// request.
+/// request immediately, unless -compile-server is given, in which case it
+/// keeps serving requests arriving on a Unix domain socket. When run in the
+/// browser, it blocks waiting for a request.
 class CompileServer {
   CompileServer(const CompileServer &) = delete;
   CompileServer &operator=(const CompileServer &) = delete;
@@ -80,6 +79,16 @@ public:
   void run() final;
 
 private:
+  /// Translates the input named by the already parsed ClFlags::Flags.
+  void compile();
+  /// Listens on SocketPath, and forks a child process from this (already
+  /// initialized) process for each incoming connection. Never returns unless
+  /// the socket cannot be set up.
+  void runServer(const std::string &SocketPath);
+  /// Reads a single compile request from the connection FD, and runs it in
+  /// the current process. Called in the forked child.
+  void serveRequest(int FD);
+
   int argc;
   char **argv;
   std::unique_ptr<GlobalContext> Ctx;
@@ -156,6 +156,7 @@ void Compiler::run(const Ice::ClFlags &Flags, GlobalContext &Ctx,
     return;
   }
 
+  Translator->translatePendingFcns();
   Ctx.waitForWorkerThreads();
   if (Translator->getErrorStatus()) {
     Ctx.getErrorStatus()->assign(Translator->getErrorStatus().value());
@@ -180,6 +181,7 @@ void Compiler::run(const Ice::ClFlags &Flags, GlobalContext &Ctx,
     constexpr bool NoDumpCumulative = false;
     Ctx.dumpTimers(GlobalContext::TSK_Funcs, NoDumpCumulative);
   }
+  Ctx.dumpTimingTrace();
   Ctx.dumpStats();
 }
 
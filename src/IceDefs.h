@@ -61,6 +61,7 @@ class ELFFileStreamer;
 class ELFObjectWriter;
 class ELFStreamer;
 class FunctionDeclaration;
+class FunctionReportWriter;
 class GlobalContext;
 class GlobalDeclaration;
 class Inst;
@@ -74,6 +75,7 @@ class Liveness;
 class Operand;
 class TargetDataLowering;
 class TargetLowering;
+class TranslationCache;
 class Variable;
 class VariableDeclaration;
 class VariablesMetadata;
@@ -330,7 +332,8 @@ enum RegAllocKind {
   RAK_Global,       /// full, global register allocation
   RAK_SecondChance, /// second-chance bin-packing after full regalloc attempt
   RAK_Phi,          /// infinite-weight Variables with active spilling/filling
-  RAK_InfOnly       /// allocation only for infinite-weight Variables
+  RAK_InfOnly,      /// allocation only for infinite-weight Variables
+  RAK_BlockLocal    /// RAK_InfOnly plus Variables local to one basic block
 };
 
 enum VerboseItem {
@@ -0,0 +1,122 @@
+//===- subzero/src/IceELFStreamer.cpp - Low level ELF writing -------------===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Defines the memory mapped ELFStreamer.
+///
+//===----------------------------------------------------------------------===//
+
+#include "IceELFStreamer.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if !PNACL_BROWSER_TRANSLATOR
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // !PNACL_BROWSER_TRANSLATOR
+
+namespace Ice {
+
+namespace {
+
+// The initial size of the mapping. Most objects fit in it, and for larger ones
+// the mapping is doubled each time it fills up.
+constexpr uint64_t InitialCapacity = 1 << 20;
+
+#if !PNACL_BROWSER_TRANSLATOR
+/// Allocates the blocks of the first Capacity bytes of the file, and returns 0
+/// or an errno value. Growing the file with ftruncate() alone would make it
+/// sparse, and a full disk would then raise SIGBUS on a write through the
+/// mapping instead of failing here.
+int reserveFile(int FD, uint64_t Capacity) {
+  return ::posix_fallocate(FD, 0, Capacity);
+}
+
+uint8_t *mapFile(int FD, uint64_t Capacity) {
+  void *Base =
+      ::mmap(nullptr, Capacity, PROT_READ | PROT_WRITE, MAP_SHARED, FD, 0);
+  if (Base == MAP_FAILED)
+    return nullptr;
+  return static_cast<uint8_t *>(Base);
+}
+#endif // !PNACL_BROWSER_TRANSLATOR
+
+} // end of anonymous namespace
+
+std::unique_ptr<ELFMmapStreamer>
+ELFMmapStreamer::create(const std::string &Filename) {
+#if PNACL_BROWSER_TRANSLATOR
+  // The browser translator only writes to the file descriptor it is given.
+  (void)Filename;
+  return nullptr;
+#else  // !PNACL_BROWSER_TRANSLATOR
+  const int FD = ::open(Filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+  if (FD < 0)
+    return nullptr;
+  uint8_t *Base = nullptr;
+  if (reserveFile(FD, InitialCapacity) == 0)
+    Base = mapFile(FD, InitialCapacity);
+  if (Base == nullptr) {
+    ::close(FD);
+    return nullptr;
+  }
+  return std::unique_ptr<ELFMmapStreamer>(
+      new ELFMmapStreamer(Filename, FD, Base, InitialCapacity));
+#endif // !PNACL_BROWSER_TRANSLATOR
+}
+
+ELFMmapStreamer::~ELFMmapStreamer() {
+#if !PNACL_BROWSER_TRANSLATOR
+  ::munmap(Base, Capacity);
+  if (::ftruncate(FD, Size) != 0)
+    fail("Unable to set the size of the output file", errno);
+  ::close(FD);
+#endif // !PNACL_BROWSER_TRANSLATOR
+}
+
+void ELFMmapStreamer::writeBytes(llvm::StringRef Bytes) {
+  const uint64_t End = Position + Bytes.size();
+  if (End > Capacity)
+    grow(End);
+  memcpy(Base + Position, Bytes.data(), Bytes.size());
+  Position = End;
+  Size = std::max(Size, Position);
+}
+
+void ELFMmapStreamer::grow(uint64_t MinCapacity) {
+#if PNACL_BROWSER_TRANSLATOR
+  (void)MinCapacity;
+  llvm::report_fatal_error("ELFMmapStreamer is not supported");
+#else  // !PNACL_BROWSER_TRANSLATOR
+  uint64_t NewCapacity = Capacity;
+  while (NewCapacity < MinCapacity)
+    NewCapacity *= 2;
+  if (const int Err = reserveFile(FD, NewCapacity))
+    fail("Unable to grow the output file", Err);
+  ::munmap(Base, Capacity);
+  Base = mapFile(FD, NewCapacity);
+  if (Base == nullptr)
+    fail("Unable to map the output file", errno);
+  Capacity = NewCapacity;
+#endif // !PNACL_BROWSER_TRANSLATOR
+}
+
+void ELFMmapStreamer::fail(const char *Message, int Err) {
+#if !PNACL_BROWSER_TRANSLATOR
+  // report_fatal_error() exits without running the destructors, so remove the
+  // partially written file here rather than leave a corrupt object behind.
+  ::close(FD);
+  ::unlink(Filename.c_str());
+#endif // !PNACL_BROWSER_TRANSLATOR
+  llvm::report_fatal_error(std::string(Message) + ": " + strerror(Err));
+}
+
+} // end of namespace Ice
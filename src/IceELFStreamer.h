@@ -18,6 +18,8 @@
 
 #include "IceDefs.h"
 
+#include <algorithm>
+
 namespace Ice {
 
 /// Low level writer that can that can handle ELFCLASS32/64. Little endian only
@@ -104,6 +106,57 @@ private:
   Fdstream &Out;
 };
 
+/// Implementation of ELFStreamer writing directly into a shared memory mapping
+/// of the output file. The file is grown (and remapped) in large increments as
+/// needed, with its blocks allocated up front so that a full disk is reported
+/// as an error, and truncated to its final size when the streamer is destroyed.
+/// Compared to ELFFileStreamer, this avoids copying the output through a
+/// stream buffer, and seeking back to patch the headers costs nothing.
+class ELFMmapStreamer : public ELFStreamer {
+  ELFMmapStreamer() = delete;
+  ELFMmapStreamer(const ELFMmapStreamer &) = delete;
+  ELFMmapStreamer &operator=(const ELFMmapStreamer &) = delete;
+
+public:
+  /// Creates (or truncates) Filename and maps it. Returns nullptr if the file
+  /// can't be created, or can't be mapped (e.g. it is a device or a pipe), in
+  /// which case the caller should fall back to ELFFileStreamer.
+  static std::unique_ptr<ELFMmapStreamer> create(const std::string &Filename);
+  ~ELFMmapStreamer() override;
+
+  void write8(uint8_t Value) override {
+    if (Position >= Capacity)
+      grow(Position + 1);
+    Base[Position++] = Value;
+    Size = std::max(Size, Position);
+  }
+
+  void writeBytes(llvm::StringRef Bytes) override;
+
+  uint64_t tell() const override { return Position; }
+
+  void seek(uint64_t Off) override { Position = Off; }
+
+private:
+  ELFMmapStreamer(const std::string &Filename, int FD, uint8_t *Base,
+                  uint64_t Capacity)
+      : Filename(Filename), FD(FD), Base(Base), Capacity(Capacity) {}
+
+  /// Grows the file and its mapping to hold at least MinCapacity bytes.
+  void grow(uint64_t MinCapacity);
+  /// Removes the output file, and reports Message along with the errno value
+  /// Err as a fatal error.
+  LLVM_ATTRIBUTE_NORETURN void fail(const char *Message, int Err);
+
+  const std::string Filename;
+  const int FD;
+  uint8_t *Base;
+  uint64_t Capacity;
+  uint64_t Position = 0;
+  /// The high-water mark of the writes, i.e. the final size of the file.
+  uint64_t Size = 0;
+};
+
 } // end of namespace Ice
 
 #endif // SUBZERO_SRC_ICEELFSTREAMER_H
\ No newline at end of file
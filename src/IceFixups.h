@@ -59,6 +59,10 @@ public:
     ValueIsSymbol = true;
     SymbolValue = Value;
   }
+  const Constant *getConstValue() const {
+    assert(!ValueIsSymbol);
+    return ConstValue;
+  }
   const ELFSym *getSymbolValue() const {
     assert(ValueIsSymbol);
     return SymbolValue;
@@ -0,0 +1,154 @@
+//===- subzero/src/IceFunctionReport.cpp - Per-function report ------------===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implements the per-function compile time and code size report.
+///
+//===----------------------------------------------------------------------===//
+
+#include "IceFunctionReport.h"
+
+#include "IceClFlags.h"
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#endif // __clang__
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif // __clang__
+
+#include <cstring>
+
+namespace Ice {
+
+namespace {
+
+// Writes Str as a CSV field, quoted so that it may contain commas.
+void writeCsvString(Ostream &Out, const std::string &Str) {
+  Out << '"';
+  for (const char C : Str) {
+    if (C == '"')
+      Out << '"';
+    Out << C;
+  }
+  Out << '"';
+}
+
+void writeSeconds(Ostream &Out, double Seconds) {
+  Out << llvm::format("%.6f", Seconds);
+}
+
+} // end of anonymous namespace
+
+void writeJsonString(Ostream &Out, const std::string &Str) {
+  Out << '"';
+  for (const char C : Str) {
+    switch (C) {
+    case '"':
+      Out << "\\\"";
+      break;
+    case '\\':
+      Out << "\\\\";
+      break;
+    default:
+      if (static_cast<unsigned char>(C) < 0x20)
+        Out << llvm::format("\\u%04x", C);
+      else
+        Out << C;
+      break;
+    }
+  }
+  Out << '"';
+}
+
+void FunctionReport::addPassTime(const char *Pass, double Seconds) {
+  // A pass normally runs once, but the time of any repeated run is added to
+  // the first one so that each pass appears once in the report.
+  for (auto &PassTime : PassTimes) {
+    if (std::strcmp(PassTime.first, Pass) == 0) {
+      PassTime.second += Seconds;
+      return;
+    }
+  }
+  PassTimes.emplace_back(Pass, Seconds);
+}
+
+std::unique_ptr<FunctionReportWriter> FunctionReportWriter::create() {
+  if (!getFlags().isFunctionReportEnabled())
+    return nullptr;
+  const std::string &Filename = getFlags().getFunctionReportFile();
+  std::error_code EC;
+  std::unique_ptr<Ostream> Out(
+      new llvm::raw_fd_ostream(Filename, EC, llvm::sys::fs::F_None));
+  if (EC)
+    llvm::report_fatal_error("Unable to open function report file " +
+                             Filename + ": " + EC.message());
+  const bool IsCsv = llvm::StringRef(Filename).endswith(".csv");
+  if (IsCsv)
+    *Out << "name,seq,thread,input_bits,insts_before,insts_after,spills,fills,"
+            "code_bytes,arena_bytes,translate_sec,pass_sec\n";
+  return std::unique_ptr<FunctionReportWriter>(
+      new FunctionReportWriter(std::move(Out), IsCsv));
+}
+
+FunctionReportWriter::FunctionReportWriter(std::unique_ptr<Ostream> Out,
+                                           bool IsCsv)
+    : Out(std::move(Out)), IsCsv(IsCsv) {}
+
+void FunctionReportWriter::write(const FunctionReport &Report) {
+  std::unique_lock<GlobalLockType> _(Lock);
+  Ostream &Str = *Out;
+  if (IsCsv) {
+    writeCsvString(Str, Report.Name);
+    Str << "," << Report.SequenceNumber << ",";
+    writeCsvString(Str, Report.Thread);
+    Str << "," << Report.InputBits << "," << Report.InstsBefore << ","
+        << Report.InstsAfter << "," << Report.Spills << "," << Report.Fills
+        << "," << Report.CodeBytes << "," << Report.ArenaBytes << ",";
+    writeSeconds(Str, Report.TranslateTime);
+    // The pass times go in a single field, as "pass=seconds;pass=seconds".
+    Str << ",\"";
+    const char *Separator = "";
+    for (const auto &PassTime : Report.PassTimes) {
+      Str << Separator << PassTime.first << "=";
+      writeSeconds(Str, PassTime.second);
+      Separator = ";";
+    }
+    Str << "\"\n";
+  } else {
+    Str << "{\"name\":";
+    writeJsonString(Str, Report.Name);
+    Str << ",\"seq\":" << Report.SequenceNumber << ",\"thread\":";
+    writeJsonString(Str, Report.Thread);
+    Str << ",\"input_bits\":" << Report.InputBits
+        << ",\"insts_before\":" << Report.InstsBefore
+        << ",\"insts_after\":" << Report.InstsAfter
+        << ",\"spills\":" << Report.Spills << ",\"fills\":" << Report.Fills
+        << ",\"code_bytes\":" << Report.CodeBytes
+        << ",\"arena_bytes\":" << Report.ArenaBytes << ",\"translate_sec\":";
+    writeSeconds(Str, Report.TranslateTime);
+    Str << ",\"pass_sec\":{";
+    const char *Separator = "";
+    for (const auto &PassTime : Report.PassTimes) {
+      Str << Separator << "\"" << PassTime.first << "\":";
+      writeSeconds(Str, PassTime.second);
+      Separator = ",";
+    }
+    Str << "}}\n";
+  }
+}
+
+} // end of namespace Ice
@@ -0,0 +1,81 @@
+//===- subzero/src/IceFunctionReport.h - Per-function report ----*- C++ -*-===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Declares the FunctionReport and FunctionReportWriter classes, which
+/// record the compile time and code size of each function for
+/// -function-report.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SUBZERO_SRC_ICEFUNCTIONREPORT_H
+#define SUBZERO_SRC_ICEFUNCTIONREPORT_H
+
+#include "IceDefs.h"
+
+#include <mutex>
+#include <utility>
+
+namespace Ice {
+
+/// FunctionReport holds the measurements of one function's translation.
+struct FunctionReport {
+  std::string Name;
+  uint32_t SequenceNumber = 0;
+  /// Size of the function block in the input bitcode, or 0 if unknown.
+  uint64_t InputBits = 0;
+  /// Number of instructions (including phis) before and after lowering.
+  SizeT InstsBefore = 0;
+  SizeT InstsAfter = 0;
+  /// Time spent in each pass of the target's pass pipeline, in seconds.
+  std::vector<std::pair<const char *, double>> PassTimes;
+  /// Time spent in Cfg::translate(), in seconds.
+  double TranslateTime = 0;
+  uint32_t Spills = 0;
+  uint32_t Fills = 0;
+  /// Size of the function's code, or 0 for textual asm output.
+  size_t CodeBytes = 0;
+  /// Size of the Cfg's arena, which only grows, after emission.
+  size_t ArenaBytes = 0;
+  /// Name of the thread that translated the function.
+  std::string Thread;
+
+  void addPassTime(const char *Pass, double Seconds);
+};
+
+/// FunctionReportWriter writes a FunctionReport per translated function to the
+/// -function-report file, as CSV if the file name ends in ".csv", and as JSON
+/// Lines (one JSON object per line) otherwise. Reports are written as the
+/// functions finish, so with several translation threads they are not in
+/// sequence number order.
+class FunctionReportWriter {
+  FunctionReportWriter() = delete;
+  FunctionReportWriter(const FunctionReportWriter &) = delete;
+  FunctionReportWriter &operator=(const FunctionReportWriter &) = delete;
+
+public:
+  /// Returns a new writer if -function-report is given, and nullptr otherwise.
+  static std::unique_ptr<FunctionReportWriter> create();
+
+  void write(const FunctionReport &Report);
+
+private:
+  FunctionReportWriter(std::unique_ptr<Ostream> Out, bool IsCsv);
+
+  GlobalLockType Lock;
+  const std::unique_ptr<Ostream> Out;
+  const bool IsCsv;
+};
+
+/// Writes Str to Out as a JSON string literal.
+void writeJsonString(Ostream &Out, const std::string &Str);
+
+} // end of namespace Ice
+
+#endif // SUBZERO_SRC_ICEFUNCTIONREPORT_H
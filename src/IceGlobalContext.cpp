@@ -20,12 +20,14 @@
 #include "IceClFlags.h"
 #include "IceDefs.h"
 #include "IceELFObjectWriter.h"
+#include "IceFunctionReport.h"
 #include "IceGlobalInits.h"
 #include "IceLiveness.h"
 #include "IceOperand.h"
 #include "IceRevision.h"
 #include "IceTargetLowering.h"
 #include "IceTimerTree.h"
+#include "IceTranslationCache.h"
 #include "IceTypes.def"
 #include "IceTypes.h"
 
@@ -34,13 +36,17 @@
 #pragma clang diagnostic ignored "-Wunused-parameter"
 #endif // __clang__
 
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
 
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif // __clang__
 
 #include <algorithm> // max()
+#include <limits>
 
 namespace std {
 template <> struct hash<Ice::RelocatableTuple> {
@@ -325,7 +331,7 @@ GlobalContext::GlobalContext(Ostream *OsDump, Ostream *OsEmit, Ostream *OsError,
   // Create a new ThreadContext for the current thread.  No need to
   // lock AllThreadContexts at this point since no other threads have
   // access yet to this GlobalContext object.
-  ThreadContext *MyTLS = new ThreadContext();
+  ThreadContext *MyTLS = new ThreadContext("main");
   AllThreadContexts.push_back(MyTLS);
   ICE_TLS_SET_FIELD(TLS, MyTLS);
   // Pre-register built-in stack names.
@@ -344,6 +350,8 @@ GlobalContext::GlobalContext(Ostream *OsDump, Ostream *OsEmit, Ostream *OsError,
   case FT_Iasm:
     break;
   }
+  TCache = TranslationCache::create(this);
+  FReports = FunctionReportWriter::create();
 // Cache up front common constants.
 #define X(tag, sizeLog2, align, elts, elty, str, rcstr)                        \
   ConstZeroForType[IceType_##tag] = getConstantZeroInternal(IceType_##tag);
@@ -381,6 +389,21 @@ void GlobalContext::translateFunctions() {
   TimerMarker Timer(TimerStack::TT_translateFunctions, this);
   while (std::unique_ptr<OptWorkItem> OptItem = optQueueBlockingPop()) {
     std::unique_ptr<EmitterWorkItem> Item;
+    // If the function's code is in the translation cache, skip straight to
+    // emission.
+    TranslationCacheInfo CacheInfo;
+    const bool UseCache =
+        TCache != nullptr && OptItem->getTranslationCacheInfo(&CacheInfo);
+    if (UseCache) {
+      std::unique_ptr<Assembler> Asm = TCache->lookup(CacheInfo);
+      statsUpdateTranslationCache(Asm != nullptr);
+      if (Asm != nullptr) {
+        Item = makeUnique<EmitterWorkItem>(CacheInfo.SequenceNumber,
+                                           std::move(Asm));
+        emitQueueBlockingPush(std::move(Item));
+        continue;
+      }
+    }
     auto Func = OptItem->getParsedCfg();
     // Install Func in TLS for Cfg-specific container allocators.
     CfgLocalAllocatorScope _(Func.get());
@@ -424,12 +447,22 @@ void GlobalContext::translateFunctions() {
         // Dump them before TLS is reset for the next Cfg.
         if (BuildDefs::dump())
           dumpStats(Func.get());
+        if (FReports != nullptr) {
+          const size_t CodeBytes = Func->getAssembler()->getBufferSize();
+          writeFunctionReport(Func.get(), CodeBytes);
+        }
+        // Functions that add their own globals can't be replayed from the
+        // cache, which only holds code.
+        std::unique_ptr<VariableDeclarationList> GlobalInits =
+            Func->getGlobalInits();
+        if (UseCache && GlobalInits == nullptr)
+          TCache->insert(CacheInfo, Func.get());
         auto Asm = Func->releaseAssembler();
         // Copy relevant fields into Asm before Func is deleted.
         Asm->setFunctionName(Func->getFunctionName());
         Item = makeUnique<EmitterWorkItem>(Func->getSequenceNumber(),
                                            std::move(Asm));
-        Item->setGlobalInits(Func->getGlobalInits());
+        Item->setGlobalInits(std::move(GlobalInits));
       } break;
       case FT_Asm:
         // The Cfg has not been emitted yet, so stats are not ready
@@ -689,6 +722,8 @@ void GlobalContext::emitItems() {
         CfgLocalAllocatorScope _(Func.get());
         Func->emit();
         dumpStats(Func.get());
+        if (FReports != nullptr)
+          writeFunctionReport(Func.get(), 0);
       } break;
       }
     }
@@ -935,14 +970,24 @@ TimerIdT GlobalContext::getTimerID(TimerStackIdT StackID,
 }
 
 void GlobalContext::pushTimer(TimerIdT ID, TimerStackIdT StackID) {
-  auto *Timers = &ICE_TLS_GET_FIELD(TLS)->Timers;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  auto *Timers = &Tls->Timers;
   assert(StackID < Timers->size());
   Timers->at(StackID).push(ID);
+  if (Tls->Trace) {
+    constexpr bool IsBegin = true;
+    Tls->Trace->record(ID, StackID, IsBegin);
+  }
 }
 
 void GlobalContext::popTimer(TimerIdT ID, TimerStackIdT StackID) {
-  auto *Timers = &ICE_TLS_GET_FIELD(TLS)->Timers;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  auto *Timers = &Tls->Timers;
   assert(StackID < Timers->size());
+  if (Tls->Trace) {
+    constexpr bool IsBegin = false;
+    Tls->Trace->record(ID, StackID, IsBegin);
+  }
   Timers->at(StackID).pop(ID);
 }
 
@@ -1001,7 +1046,7 @@ std::unique_ptr<EmitterWorkItem> GlobalContext::emitQueueBlockingPop() {
 }
 
 void GlobalContext::initParserThread() {
-  ThreadContext *Tls = new ThreadContext();
+  ThreadContext *Tls = new ThreadContext("parser");
   auto Timers = getTimers();
   Timers->initInto(Tls->Timers);
   AllThreadContexts.push_back(Tls);
@@ -1012,14 +1057,15 @@ void GlobalContext::startWorkerThreads() {
   size_t NumWorkers = getFlags().getNumTranslationThreads();
   auto Timers = getTimers();
   for (size_t i = 0; i < NumWorkers; ++i) {
-    ThreadContext *WorkerTLS = new ThreadContext();
+    ThreadContext *WorkerTLS =
+        new ThreadContext("translator " + std::to_string(i));
     Timers->initInto(WorkerTLS->Timers);
     AllThreadContexts.push_back(WorkerTLS);
     TranslationThreads.push_back(std::thread(
         &GlobalContext::translateFunctionsWrapper, this, WorkerTLS));
   }
   if (NumWorkers) {
-    ThreadContext *WorkerTLS = new ThreadContext();
+    ThreadContext *WorkerTLS = new ThreadContext("emitter");
     Timers->initInto(WorkerTLS->Timers);
     AllThreadContexts.push_back(WorkerTLS);
     EmitterThreads.push_back(
@@ -1090,6 +1136,114 @@ void GlobalContext::statsUpdateRPImms() {
   Tls->StatsCumulative.update(CodeStats::CS_NumRPImms);
 }
 
+void GlobalContext::statsUpdateTranslationCache(bool Hit) {
+  if (!getFlags().getDumpStats())
+    return;
+  const CodeStats::CSTag Tag =
+      Hit ? CodeStats::CS_TCacheHits : CodeStats::CS_TCacheMisses;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  Tls->StatsFunction.update(Tag);
+  Tls->StatsCumulative.update(Tag);
+}
+
+void GlobalContext::statsUpdateDelaySlots(bool Filled) {
+  if (!getFlags().getDumpStats())
+    return;
+  const CodeStats::CSTag Tag = Filled ? CodeStats::CS_DelaySlotsFilled
+                                      : CodeStats::CS_DelaySlotsUnfilled;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  Tls->StatsFunction.update(Tag);
+  Tls->StatsCumulative.update(Tag);
+}
+
+void GlobalContext::statsUpdateInliner(uint32_t Candidates,
+                                       uint32_t InlinedCalls) {
+  if (!getFlags().getDumpStats())
+    return;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  Tls->StatsCumulative.update(CodeStats::CS_InlineCandidates, Candidates);
+  Tls->StatsCumulative.update(CodeStats::CS_InlinedCalls, InlinedCalls);
+}
+
+void GlobalContext::statsUpdateO2Demotions() {
+  if (!getFlags().getDumpStats())
+    return;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  Tls->StatsFunction.update(CodeStats::CS_O2Demotions);
+  Tls->StatsCumulative.update(CodeStats::CS_O2Demotions);
+}
+
+void GlobalContext::statsUpdateRenumberings() {
+  if (!getFlags().getDumpStats())
+    return;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  Tls->StatsFunction.update(CodeStats::CS_Renumberings);
+  Tls->StatsCumulative.update(CodeStats::CS_Renumberings);
+}
+
+void GlobalContext::statsUpdateSCCP(uint32_t Folds, uint32_t DeadInsts,
+                                    uint32_t DeadNodes) {
+  if (!getFlags().getDumpStats())
+    return;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  Tls->StatsFunction.update(CodeStats::CS_SCCPFolds, Folds);
+  Tls->StatsCumulative.update(CodeStats::CS_SCCPFolds, Folds);
+  Tls->StatsFunction.update(CodeStats::CS_SCCPDeadInsts, DeadInsts);
+  Tls->StatsCumulative.update(CodeStats::CS_SCCPDeadInsts, DeadInsts);
+  Tls->StatsFunction.update(CodeStats::CS_SCCPDeadNodes, DeadNodes);
+  Tls->StatsCumulative.update(CodeStats::CS_SCCPDeadNodes, DeadNodes);
+}
+
+void GlobalContext::statsUpdateRLE(uint32_t Loads, uint32_t Forwards) {
+  if (!getFlags().getDumpStats())
+    return;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  Tls->StatsFunction.update(CodeStats::CS_RLELoads, Loads);
+  Tls->StatsCumulative.update(CodeStats::CS_RLELoads, Loads);
+  Tls->StatsFunction.update(CodeStats::CS_RLEForwards, Forwards);
+  Tls->StatsCumulative.update(CodeStats::CS_RLEForwards, Forwards);
+}
+
+void GlobalContext::statsUpdateIfConversion(uint32_t Diamonds,
+                                            uint32_t Triangles) {
+  if (!getFlags().getDumpStats())
+    return;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  Tls->StatsFunction.update(CodeStats::CS_IfConvertedDiamonds, Diamonds);
+  Tls->StatsCumulative.update(CodeStats::CS_IfConvertedDiamonds, Diamonds);
+  Tls->StatsFunction.update(CodeStats::CS_IfConvertedTriangles, Triangles);
+  Tls->StatsCumulative.update(CodeStats::CS_IfConvertedTriangles, Triangles);
+}
+
+void GlobalContext::statsUpdatePeepholeX86(PeepholeX86Kind Kind) {
+  if (!getFlags().getDumpStats())
+    return;
+  ThreadContext *Tls = ICE_TLS_GET_FIELD(TLS);
+  CodeStats::CSTag Tag = CodeStats::CS_NUM;
+  switch (Kind) {
+#define X(str, tag)                                                            \
+  case PK_##tag:                                                               \
+    Tag = CodeStats::CS_##tag;                                                 \
+    break;
+    PEEPHOLEX86_TABLE
+#undef X
+  }
+  Tls->StatsFunction.update(Tag);
+  Tls->StatsCumulative.update(Tag);
+}
+
+const std::string &GlobalContext::getThreadName() const {
+  return ICE_TLS_GET_FIELD(TLS)->Name;
+}
+
+void GlobalContext::writeFunctionReport(const Cfg *Func, size_t CodeBytes) {
+  FunctionReport *Report = Func->getReport();
+  assert(FReports != nullptr && Report != nullptr);
+  Report->CodeBytes = CodeBytes;
+  Report->ArenaBytes = Func->getTotalMemoryBytes();
+  FReports->write(*Report);
+}
+
 void GlobalContext::dumpTimers(TimerStackIdT StackID, bool DumpCumulative) {
   if (!BuildDefs::timers())
     return;
@@ -1118,6 +1272,61 @@ void GlobalContext::dumpLocalTimers(const std::string &TimerNameOverride,
   setTimerName(StackID, OrigName);
 }
 
+void GlobalContext::dumpTimingTrace() {
+  if (!getFlags().isTimingTraceEnabled())
+    return;
+  const std::string &Filename = getFlags().getTimingTraceFile();
+  std::error_code EC;
+  llvm::raw_fd_ostream Out(Filename, EC, llvm::sys::fs::F_None);
+  if (EC)
+    llvm::report_fatal_error("Unable to open timing trace file " + Filename +
+                             ": " + EC.message());
+  // Timestamps are in microseconds, relative to the earliest recorded event.
+  double StartTime = std::numeric_limits<double>::max();
+  for (const ThreadContext *Tls : AllThreadContexts) {
+    Tls->Trace->forEachEvent([&StartTime](const TimerTrace::Event &E) {
+      StartTime = std::min(StartTime, E.Time);
+    });
+  }
+  Out << "{\"traceEvents\":[";
+  bool First = true;
+  auto beginEvent = [&Out, &First]() {
+    Out << (First ? "\n" : ",\n");
+    First = false;
+  };
+  for (SizeT Tid = 0; Tid < AllThreadContexts.size(); ++Tid) {
+    const ThreadContext *Tls = AllThreadContexts[Tid];
+    beginEvent();
+    Out << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << Tid
+        << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+    writeJsonString(Out, Tls->Name);
+    Out << "}}";
+    // If the ring buffer overflowed, the oldest events are lost, so skip ends
+    // whose begins are gone.
+    std::vector<SizeT> Depth(Tls->Timers.size());
+    Tls->Trace->forEachEvent([&](const TimerTrace::Event &E) {
+      if (E.IsBegin) {
+        ++Depth[E.StackID];
+      } else {
+        if (Depth[E.StackID] == 0)
+          return;
+        --Depth[E.StackID];
+      }
+      const TimerStack &Stack = Tls->Timers[E.StackID];
+      beginEvent();
+      Out << "{\"ph\":\"" << (E.IsBegin ? 'B' : 'E')
+          << "\",\"pid\":1,\"tid\":" << Tid << ",\"ts\":"
+          << llvm::format("%.3f", (E.Time - StartTime) * 1e6)
+          << ",\"cat\":";
+      writeJsonString(Out, Stack.getName());
+      Out << ",\"name\":";
+      writeJsonString(Out, Stack.getIDName(E.ID));
+      Out << "}";
+    });
+  }
+  Out << "\n]}\n";
+}
+
 LockedPtr<StringPool>
 GlobalStringPoolTraits::getStrings(const GlobalContext *PoolOwner) {
   return PoolOwner->getStrings();
@@ -1136,7 +1345,8 @@ void TimerMarker::push() {
   switch (StackID) {
   case GlobalContext::TSK_Default:
     Active = getFlags().getSubzeroTimingEnabled() ||
-             !getFlags().getTimingFocusOnString().empty();
+             !getFlags().getTimingFocusOnString().empty() ||
+             getFlags().isTimingTraceEnabled();
     break;
   case GlobalContext::TSK_Funcs:
     Active = getFlags().getTimeEachFunction();
@@ -1150,11 +1360,18 @@ void TimerMarker::push() {
 
 void TimerMarker::pushCfg(const Cfg *Func) {
   Ctx = Func->getContext();
-  Active = Func->getFocusedTiming() || getFlags().getSubzeroTimingEnabled();
+  Active = Func->getFocusedTiming() || getFlags().getSubzeroTimingEnabled() ||
+           getFlags().isTimingTraceEnabled();
   if (Active)
     Ctx->pushTimer(ID, StackID);
 }
 
+GlobalContext::ThreadContext::ThreadContext(const std::string &Name)
+    : Name(Name) {
+  if (getFlags().isTimingTraceEnabled())
+    Trace.reset(new TimerTrace());
+}
+
 ICE_TLS_DEFINE_FIELD(GlobalContext::ThreadContext *, GlobalContext, TLS);
 
 } // end of namespace Ice
@@ -20,6 +20,7 @@
 #include "IceClFlags.h"
 #include "IceInstrumentation.h"
 #include "IceIntrinsics.h"
+#include "IcePeepholeX86.def"
 #include "IceRNG.h"
 #include "IceStringPool.h"
 #include "IceSwitchLowering.h"
@@ -46,6 +47,7 @@ class ConstantPool;
 class EmitterWorkItem;
 class FuncSigType;
 class Instrumentation;
+struct TranslationCacheInfo;
 
 // Runtime helper function IDs
 
@@ -65,6 +67,11 @@ class OptWorkItem {
 public:
   // Get the Cfg for the funtion to translate.
   virtual std::unique_ptr<Cfg> getParsedCfg() = 0;
+  // Fills in Info and returns true if the function's translation can be looked
+  // up in the translation cache before the function is parsed.
+  virtual bool getTranslationCacheInfo(TranslationCacheInfo *) const {
+    return false;
+  }
   virtual ~OptWorkItem() = default;
 
 protected:
@@ -87,7 +94,23 @@ class GlobalContext {
   X("Frame Bytes ", FrameByte)                                                 \
   X("Spills      ", NumSpills)                                                 \
   X("Fills       ", NumFills)                                                  \
-  X("R/P Imms    ", NumRPImms)
+  X("R/P Imms    ", NumRPImms)                                                 \
+  X("TCache Hits ", TCacheHits)                                                \
+  X("TCache Miss ", TCacheMisses)                                              \
+  X("Slots Filled", DelaySlotsFilled)                                          \
+  X("Slots Nop   ", DelaySlotsUnfilled)                                        \
+  X("Inline Cands", InlineCandidates)                                          \
+  X("Inlined Call", InlinedCalls)                                              \
+  X("O2 Demotions", O2Demotions)                                               \
+  X("Renumberings", Renumberings)                                              \
+  X("SCCP Folds  ", SCCPFolds)                                                 \
+  X("SCCP DeadIns", SCCPDeadInsts)                                             \
+  X("SCCP DeadBBs", SCCPDeadNodes)                                             \
+  X("RLE Loads   ", RLELoads)                                                  \
+  X("RLE Forwards", RLEForwards)                                               \
+  X("IfCvt Diamnd", IfConvertedDiamonds)                                       \
+  X("IfCvt Triang", IfConvertedTriangles)                                      \
+  PEEPHOLEX86_TABLE
     //#define X(str, tag)
 
   public:
@@ -155,10 +178,14 @@ class GlobalContext {
     ThreadContext &operator=(const ThreadContext &) = delete;
 
   public:
-    ThreadContext() = default;
+    explicit ThreadContext(const std::string &Name);
+    /// The thread's name in the -timing-trace output.
+    const std::string Name;
     CodeStats StatsFunction;
     CodeStats StatsCumulative;
     TimerList Timers;
+    /// The push and pop events on Timers, if -timing-trace is enabled.
+    std::unique_ptr<TimerTrace> Trace;
   };
 
 public:
@@ -296,6 +323,15 @@ public:
 
   ELFObjectWriter *getObjectWriter() const { return ObjectWriter.get(); }
 
+  /// Returns the translation cache, or nullptr if -translation-cache is not in
+  /// effect.
+  TranslationCache *getTranslationCache() const { return TCache.get(); }
+  /// Returns the name of the calling thread, e.g. "translator 0".
+  const std::string &getThreadName() const;
+  /// Completes Func's -function-report entry with the given code size and the
+  /// Cfg's arena size, and writes it out.
+  void writeFunctionReport(const Cfg *Func, size_t CodeBytes);
+
   /// Reset stats at the beginning of a function.
   void resetStats();
   void dumpStats(const Cfg *Func = nullptr);
@@ -308,6 +344,46 @@ public:
   /// Number of Randomized or Pooled Immediates
   void statsUpdateRPImms();
 
+  /// Number of functions found (Hit) or not found in the translation cache.
+  void statsUpdateTranslationCache(bool Hit);
+
+  /// Number of branch delay slots that were filled with a useful instruction,
+  /// or left with a nop.
+  void statsUpdateDelaySlots(bool Filled);
+
+  /// Number of functions the inliner found small enough to inline, and number
+  /// of call sites it inlined them into. The inliner runs before any function
+  /// is translated, so these only contribute to the cumulative stats.
+  void statsUpdateInliner(uint32_t Candidates, uint32_t InlinedCalls);
+
+  /// Number of functions translated with -Om1 because they exceeded the -O2
+  /// budget.
+  void statsUpdateO2Demotions();
+
+  /// Number of times all of a function's instructions were renumbered, i.e.
+  /// the new instructions could not all be numbered into gaps.
+  void statsUpdateRenumberings();
+
+  /// Number of Variables and branches that constant propagation folded, of
+  /// instructions it deleted as dead, and of nodes it made unreachable.
+  void statsUpdateSCCP(uint32_t Folds, uint32_t DeadInsts, uint32_t DeadNodes);
+
+  /// Number of loads that redundant load elimination replaced by the value of
+  /// an earlier load, or by the value of an earlier store.
+  void statsUpdateRLE(uint32_t Loads, uint32_t Forwards);
+
+  /// Number of diamonds and triangles that if-conversion turned into selects.
+  void statsUpdateIfConversion(uint32_t Diamonds, uint32_t Triangles);
+
+  /// The post-regalloc x86 peephole patterns, whose hits are counted in the
+  /// stats.
+  enum PeepholeX86Kind {
+#define X(str, tag) PK_##tag,
+    PEEPHOLEX86_TABLE
+#undef X
+  };
+  void statsUpdatePeepholeX86(PeepholeX86Kind Kind);
+
   /// These are predefined TimerStackIdT values.
   enum TimerStackKind { TSK_Default = 0, TSK_Funcs, TSK_Num };
 
@@ -322,6 +398,10 @@ public:
   void dumpLocalTimers(const std::string &TimerNameOverride,
                        TimerStackIdT StackID = TSK_Default,
                        bool DumpCumulative = true);
+  /// dumpTimingTrace() writes the timer events recorded by every thread to the
+  /// -timing-trace file, as JSON that chrome://tracing can display. This
+  /// assumes all the worker threads have finished.
+  void dumpTimingTrace();
   /// The following methods affect only the calling thread's TLS timer data.
   TimerIdT getTimerID(TimerStackIdT StackID, const std::string &Name);
   void pushTimer(TimerIdT ID, TimerStackIdT StackID);
@@ -492,6 +572,9 @@ private:
   Intrinsics IntrinsicsInfo;
   // TODO(jpp): move to EmitterContext.
   std::unique_ptr<ELFObjectWriter> ObjectWriter;
+  // Shared by all the translation threads.
+  std::unique_ptr<TranslationCache> TCache;
+  std::unique_ptr<FunctionReportWriter> FReports;
   // Value defining when to wake up the main parse thread.
   const size_t OptQWakeupSize;
   BoundedProducerConsumerQueue<OptWorkItem, MaxOptQSize> OptQ;
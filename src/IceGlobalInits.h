@@ -40,6 +40,7 @@
 #pragma clang diagnostic pop
 #endif // __clang__
 
+#include <cstring>
 #include <memory>
 #include <utility>
 
@@ -249,7 +250,7 @@ public:
                 "Initializer must be trivially destructible.");
 
   /// Models the data in a data initializer.
-  using DataVecType = char *;
+  using DataVecType = const char *;
 
   /// Defines a sequence of byte values as a data initializer.
   class DataInitializer : public Initializer {
@@ -264,6 +265,15 @@ public:
           DataInitializer(VDL, std::forward<Args>(TheArgs)...);
     }
 
+    /// Creates a data initializer that refers to Data instead of copying it.
+    /// Data must stay alive until the globals have been lowered, which is the
+    /// case for initializers that point into the translator's input buffer.
+    static DataInitializer *createReference(VariableDeclarationList *VDL,
+                                            llvm::StringRef Data) {
+      return new (VDL->allocate_initializer<DataInitializer>())
+          DataInitializer(Data);
+    }
+
     const llvm::StringRef getContents() const {
       return llvm::StringRef(Contents, ContentsSize);
     }
@@ -276,25 +286,29 @@ public:
   private:
     DataInitializer(VariableDeclarationList *VDL,
                     const llvm::NaClBitcodeRecord::RecordVector &Values)
-        : Initializer(DataInitializerKind), ContentsSize(Values.size()),
-          // ugh, we should actually do new char[], but this may involve
-          // implementation-specific details. Given that Contents is arena
-          // allocated, and never delete[]d, just use char --
-          // AllocOwner->allocate_array will allocate a buffer with the right
-          // size.
-          Contents(new (VDL->allocate_initializer<char>(ContentsSize)) char) {
+        : Initializer(DataInitializerKind), ContentsSize(Values.size()) {
+      // ugh, we should actually do new char[], but this may involve
+      // implementation-specific details. Given that Contents is arena
+      // allocated, and never delete[]d, just use char --
+      // AllocOwner->allocate_array will allocate a buffer with the right size.
+      char *Buffer = new (VDL->allocate_initializer<char>(ContentsSize)) char;
       for (SizeT I = 0; I < Values.size(); ++I)
-        Contents[I] = static_cast<int8_t>(Values[I]);
+        Buffer[I] = static_cast<int8_t>(Values[I]);
+      Contents = Buffer;
     }
 
     DataInitializer(VariableDeclarationList *VDL, const char *Str,
                     size_t StrLen)
-        : Initializer(DataInitializerKind), ContentsSize(StrLen),
-          Contents(new (VDL->allocate_initializer<char>(ContentsSize)) char) {
-      for (size_t i = 0; i < StrLen; ++i)
-        Contents[i] = Str[i];
+        : Initializer(DataInitializerKind), ContentsSize(StrLen) {
+      char *Buffer = new (VDL->allocate_initializer<char>(ContentsSize)) char;
+      memcpy(Buffer, Str, StrLen);
+      Contents = Buffer;
     }
 
+    explicit DataInitializer(llvm::StringRef Data)
+        : Initializer(DataInitializerKind), ContentsSize(Data.size()),
+          Contents(Data.data()) {}
+
     /// The byte contents of the data initializer.
     const SizeT ContentsSize;
     DataVecType Contents;
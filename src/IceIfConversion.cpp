@@ -0,0 +1,295 @@
+//===- subzero/src/IceIfConversion.cpp - If-conversion --------------------===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implements the if-conversion pass.
+///
+//===----------------------------------------------------------------------===//
+
+#include "IceIfConversion.h"
+
+#include "IceCfg.h"
+#include "IceCfgNode.h"
+#include "IceClFlags.h"
+#include "IceGlobalContext.h"
+#include "IceInst.h"
+#include "IceOperand.h"
+#include "IceTimerTree.h"
+
+#include <algorithm>
+
+namespace Ice {
+
+namespace {
+
+/// Returns true if the instruction can be executed on a path where it was not
+/// executed before, i.e. it has no side effects, it can't fault, and it is not
+/// lowered to a helper call. In particular, loads are never speculated.
+bool isSpeculatable(const Inst *Instr) {
+  if (Instr->getDest() == nullptr || Instr->hasSideEffects())
+    return false;
+  if (const auto *Arith = llvm::dyn_cast<InstArithmetic>(Instr)) {
+    switch (Arith->getOp()) {
+    default:
+      return true;
+    case InstArithmetic::Udiv:
+    case InstArithmetic::Sdiv:
+    case InstArithmetic::Urem:
+    case InstArithmetic::Srem:
+    case InstArithmetic::Frem:
+      return false;
+    }
+  }
+  if (const auto *Cast = llvm::dyn_cast<InstCast>(Instr)) {
+    switch (Cast->getCastKind()) {
+    default:
+      return true;
+    case InstCast::Fptoui:
+    case InstCast::Fptosi:
+    case InstCast::Uitofp:
+    case InstCast::Sitofp:
+      return false;
+    }
+  }
+  return llvm::isa<InstIcmp>(Instr) || llvm::isa<InstFcmp>(Instr) ||
+         llvm::isa<InstAssign>(Instr) || llvm::isa<InstSelect>(Instr);
+}
+
+/// Returns true if a select of type Ty is lowered without a branch. The x86
+/// cmov instruction has no 8-bit or floating point form, and vector selects
+/// need a vector condition.
+bool isSelectableType(Type Ty) {
+  return Ty == IceType_i16 || Ty == IceType_i32 || Ty == IceType_i64;
+}
+
+/// Returns Node's conditional or unconditional branch, or nullptr if it ends
+/// with another terminator.
+InstBr *getBranch(CfgNode *Node) {
+  if (Node->getInsts().empty())
+    return nullptr;
+  return llvm::dyn_cast<InstBr>(&Node->getInsts().back());
+}
+
+class IfConverter {
+  IfConverter() = delete;
+  IfConverter(const IfConverter &) = delete;
+  IfConverter &operator=(const IfConverter &) = delete;
+
+public:
+  explicit IfConverter(Cfg *Func)
+      : Func(Func), MaxInsts(getFlags().getIfConversionMaxInsts()),
+        Merged(Func->getNumNodes()) {}
+
+  void convert();
+  uint32_t getNumDiamonds() const { return NumDiamonds; }
+  uint32_t getNumTriangles() const { return NumTriangles; }
+
+private:
+  /// Returns the target of Arm's unconditional branch if Arm is only entered
+  /// from Head and all of its instructions can be speculated into Head, and
+  /// nullptr otherwise. Adds the number of its instructions to Cost.
+  CfgNode *getArmSuccessor(CfgNode *Arm, const CfgNode *Head,
+                           SizeT *Cost) const;
+  /// Returns true if each phi in Join can become a select.
+  bool canSelectPhis(const CfgNode *Join) const;
+  /// Converts the diamond or triangle that starts with Head's conditional
+  /// branch, if there is one, and returns true if it did.
+  bool tryConvert(CfgNode *Head);
+  /// Appends Join's instructions to Head, and makes Head the predecessor of
+  /// Join's successors.
+  void mergeJoin(CfgNode *Head, CfgNode *Join);
+
+  Cfg *const Func;
+  const SizeT MaxInsts;
+  /// The nodes that were merged into another node, and that become unreachable.
+  CfgVector<bool> Merged;
+  uint32_t NumDiamonds = 0;
+  uint32_t NumTriangles = 0;
+};
+
+CfgNode *IfConverter::getArmSuccessor(CfgNode *Arm, const CfgNode *Head,
+                                      SizeT *Cost) const {
+  if (Arm == Head || Arm == Func->getEntryNode() || Merged[Arm->getIndex()])
+    return nullptr;
+  if (Arm->getInEdges().size() != 1)
+    return nullptr;
+  for (const Inst &Instr : Arm->getPhis()) {
+    if (!Instr.isDeleted())
+      return nullptr;
+  }
+  const InstBr *Br = getBranch(Arm);
+  if (Br == nullptr || !Br->isUnconditional())
+    return nullptr;
+  CfgNode *Succ = Br->getTargetUnconditional();
+  if (Succ == Arm || Succ == Head)
+    return nullptr;
+  SizeT NumInsts = 0;
+  for (const Inst &Instr : Arm->getInsts()) {
+    if (Instr.isDeleted() || &Instr == Br)
+      continue;
+    if (!isSpeculatable(&Instr))
+      return nullptr;
+    ++NumInsts;
+  }
+  *Cost += NumInsts;
+  return Succ;
+}
+
+bool IfConverter::canSelectPhis(const CfgNode *Join) const {
+  for (const Inst &Instr : Join->getPhis()) {
+    if (Instr.isDeleted())
+      continue;
+    if (!isSelectableType(Instr.getDest()->getType()))
+      return false;
+    // The phis are evaluated in parallel, but the selects are not, so a phi
+    // can't use the value of another phi of the same node. This can only
+    // happen in a loop that Join dominates.
+    for (SizeT I = 0; I < Instr.getSrcSize(); ++I) {
+      for (const Inst &Other : Join->getPhis()) {
+        if (!Other.isDeleted() && Instr.getSrc(I) == Other.getDest())
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool IfConverter::tryConvert(CfgNode *Head) {
+  InstBr *Br = getBranch(Head);
+  if (Br == nullptr || Br->isUnconditional())
+    return false;
+  CfgNode *TrueNode = Br->getTargetTrue();
+  CfgNode *FalseNode = Br->getTargetFalse();
+  if (TrueNode == FalseNode)
+    return false;
+
+  // Find the node where the two paths join, and its predecessors on each path.
+  SizeT TrueCost = 0;
+  SizeT FalseCost = 0;
+  CfgNode *TrueSucc = getArmSuccessor(TrueNode, Head, &TrueCost);
+  CfgNode *FalseSucc = getArmSuccessor(FalseNode, Head, &FalseCost);
+  CfgNode *Join = nullptr;
+  CfgNode *TruePred = nullptr;
+  CfgNode *FalsePred = nullptr;
+  SizeT Cost = 0;
+  bool IsDiamond = false;
+  if (TrueSucc != nullptr && TrueSucc == FalseSucc) {
+    Join = TrueSucc;
+    TruePred = TrueNode;
+    FalsePred = FalseNode;
+    Cost = TrueCost + FalseCost;
+    IsDiamond = true;
+  } else if (TrueSucc == FalseNode) {
+    Join = FalseNode;
+    TruePred = TrueNode;
+    FalsePred = Head;
+    Cost = TrueCost;
+  } else if (FalseSucc != nullptr && FalseSucc == TrueNode) {
+    Join = TrueNode;
+    TruePred = Head;
+    FalsePred = FalseNode;
+    Cost = FalseCost;
+  } else {
+    return false;
+  }
+  if (Cost > MaxInsts)
+    return false;
+  // Join must only be entered from the two paths, so that the selects can
+  // replace its phis, and so that it can be merged into Head.
+  const NodeList &JoinPreds = Join->getInEdges();
+  if (JoinPreds.size() != 2 ||
+      std::find(JoinPreds.begin(), JoinPreds.end(), TruePred) ==
+          JoinPreds.end() ||
+      std::find(JoinPreds.begin(), JoinPreds.end(), FalsePred) ==
+          JoinPreds.end())
+    return false;
+  if (!canSelectPhis(Join))
+    return false;
+
+  // Speculate the arms' instructions, leaving their branches behind.
+  InstList &Insts = Head->getInsts();
+  const auto Terminator = instToIterator(Br);
+  for (CfgNode *Arm : {TrueNode, FalseNode}) {
+    if (Arm == Join)
+      continue;
+    InstList &ArmInsts = Arm->getInsts();
+    Insts.splice(Terminator, ArmInsts, ArmInsts.begin(),
+                 std::prev(ArmInsts.end()));
+    Merged[Arm->getIndex()] = true;
+  }
+  // Replace the phis with selects on the branch condition.
+  Operand *Condition = Br->getCondition();
+  for (Inst &Instr : Join->getPhis()) {
+    if (Instr.isDeleted())
+      continue;
+    auto *Phi = llvm::cast<InstPhi>(&Instr);
+    Variable *Dest = Phi->getDest();
+    Operand *TrueValue = Phi->getOperandForTarget(TruePred);
+    Operand *FalseValue = Phi->getOperandForTarget(FalsePred);
+    if (TrueValue == FalseValue) {
+      Insts.insert(Terminator, InstAssign::create(Func, Dest, TrueValue));
+    } else {
+      Insts.insert(Terminator, InstSelect::create(Func, Dest, Condition,
+                                                  TrueValue, FalseValue));
+    }
+  }
+  Join->getPhis().clear();
+  Br->setDeleted();
+  mergeJoin(Head, Join);
+
+  if (IsDiamond)
+    ++NumDiamonds;
+  else
+    ++NumTriangles;
+  return true;
+}
+
+void IfConverter::mergeJoin(CfgNode *Head, CfgNode *Join) {
+  InstList &JoinInsts = Join->getInsts();
+  Head->getInsts().splice(Head->getInsts().end(), JoinInsts);
+  // CfgNode::computeSuccessors() expects every node to have a terminator, even
+  // an unreachable one.
+  JoinInsts.push_back(InstUnreachable::create(Func));
+  Merged[Join->getIndex()] = true;
+  Head->removeAllOutEdges();
+  for (CfgNode *Succ : Join->getOutEdges()) {
+    Head->addOutEdge(Succ);
+    Succ->replaceInEdge(Join, Head);
+  }
+}
+
+void IfConverter::convert() {
+  // Visit the nodes in reverse layout order, so that a diamond nested in an
+  // arm of another is usually converted first. The merged node can then be
+  // speculated as an arm of the enclosing diamond.
+  const NodeList &Nodes = Func->getNodes();
+  for (auto I = Nodes.rbegin(), E = Nodes.rend(); I != E; ++I) {
+    CfgNode *Head = *I;
+    if (Merged[Head->getIndex()])
+      continue;
+    // Head now ends with Join's terminator, which may start another diamond.
+    while (tryConvert(Head)) {
+    }
+  }
+}
+
+} // end of anonymous namespace
+
+void convertIfs(Cfg *Func) {
+  TimerMarker T(TimerStack::TT_ifConvert, Func);
+  IfConverter Converter(Func);
+  Converter.convert();
+  // Recompute the edges, which drops the arms and the merged join nodes.
+  if (Converter.getNumDiamonds() + Converter.getNumTriangles() > 0)
+    Func->computeInOutEdges();
+  Func->getContext()->statsUpdateIfConversion(Converter.getNumDiamonds(),
+                                              Converter.getNumTriangles());
+}
+
+} // end of namespace Ice
@@ -0,0 +1,32 @@
+//===- subzero/src/IceIfConversion.h - If-conversion ------------*- C++ -*-===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Declares the if-conversion pass, which replaces small branch
+/// diamonds and triangles in the high-level ICE IR by select instructions.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SUBZERO_SRC_ICEIFCONVERSION_H
+#define SUBZERO_SRC_ICEIFCONVERSION_H
+
+namespace Ice {
+
+/// Removes the conditional branches around small, side-effect free blocks.
+/// The instructions of such a diamond or triangle are executed
+/// unconditionally, the phis where its paths join become selects on the branch
+/// condition, and the join block is merged into the block that held the
+/// branch.
+///
+/// The Cfg must still be in SSA form, i.e. before phi lowering.
+void convertIfs(class Cfg *Func);
+
+} // end of namespace Ice
+
+#endif // SUBZERO_SRC_ICEIFCONVERSION_H
@@ -0,0 +1,255 @@
+//===- subzero/src/IceInliner.cpp - Module-level inliner ------------------===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implements the module-level inliner.
+///
+//===----------------------------------------------------------------------===//
+
+#include "IceInliner.h"
+
+#include "IceCfg.h"
+#include "IceCfgNode.h"
+#include "IceClFlags.h"
+#include "IceGlobalContext.h"
+#include "IceInst.h"
+#include "IceOperand.h"
+
+#include <map>
+#include <unordered_map>
+
+namespace Ice {
+
+namespace {
+
+/// Returns true if Instr can be copied into a caller by cloneInst().
+bool isClonable(const Inst &Instr) {
+  switch (Instr.getKind()) {
+  default:
+    return false;
+  case Inst::Arithmetic:
+  case Inst::Assign:
+  case Inst::Cast:
+  case Inst::ExtractElement:
+  case Inst::Fcmp:
+  case Inst::Icmp:
+  case Inst::InsertElement:
+  case Inst::Load:
+  case Inst::Select:
+  case Inst::Store:
+    return true;
+  }
+}
+
+/// Returns true if Func is an inlining candidate, i.e. a single basic block
+/// ending in a ret, with no phis, calls, allocas or other control flow, and
+/// sets Size to the number of instructions before the ret.
+bool isInlinable(const Cfg *Func, SizeT *Size) {
+  if (Func->hasError() || Func->getNumNodes() != 1)
+    return false;
+  const CfgNode *Node = Func->getEntryNode();
+  if (!Node->getPhis().empty())
+    return false;
+  *Size = 0;
+  bool SawRet = false;
+  for (const Inst &Instr : Node->getInsts()) {
+    if (Instr.isDeleted())
+      continue;
+    if (SawRet)
+      return false;
+    if (llvm::isa<InstRet>(&Instr)) {
+      SawRet = true;
+      continue;
+    }
+    if (!isClonable(Instr))
+      return false;
+    ++*Size;
+  }
+  return SawRet;
+}
+
+class CallInliner {
+  CallInliner() = delete;
+  CallInliner(const CallInliner &) = delete;
+  CallInliner &operator=(const CallInliner &) = delete;
+
+public:
+  CallInliner(Cfg *Caller, const InstCall *Call, const Cfg *Callee)
+      : Caller(Caller), Call(Call), Callee(Callee) {}
+
+  /// Inserts a copy of the callee's body before Where, with the callee's
+  /// arguments replaced by the call's arguments, and assigns the returned value
+  /// to the call's Dest.
+  void inlineBefore(CfgNode *Node, InstList::iterator Where) {
+    const VarList &Args = Callee->getArgs();
+    for (SizeT I = 0; I < Args.size(); ++I)
+      Map[Args[I]] = Call->getArg(I);
+    for (const Inst &Instr : Callee->getEntryNode()->getInsts()) {
+      if (Instr.isDeleted())
+        continue;
+      if (const auto *Ret = llvm::dyn_cast<InstRet>(&Instr)) {
+        Variable *Dest = Call->getDest();
+        if (Dest != nullptr)
+          Node->getInsts().insert(
+              Where, InstAssign::create(Caller, Dest,
+                                        mapOperand(Ret->getRetValue())));
+        return;
+      }
+      Node->getInsts().insert(Where, cloneInst(Instr));
+    }
+  }
+
+private:
+  Operand *mapOperand(Operand *Src) {
+    auto *Var = llvm::dyn_cast<Variable>(Src);
+    if (Var == nullptr)
+      return Src;
+    auto Iter = Map.find(Var);
+    assert(Iter != Map.end() && "Callee variable used before definition");
+    return Iter->second;
+  }
+
+  Variable *mapDest(const Variable *Dest) {
+    Variable *NewDest = Caller->makeVariable(Dest->getType());
+    Map[Dest] = NewDest;
+    return NewDest;
+  }
+
+  Inst *cloneInst(const Inst &Instr) {
+    auto Src = [this, &Instr](SizeT I) { return mapOperand(Instr.getSrc(I)); };
+    // Sources must be mapped before the Dest, since the Dest is new.
+    switch (Instr.getKind()) {
+    default:
+      llvm::report_fatal_error("Unexpected instruction kind in inlined body");
+    case Inst::Arithmetic: {
+      const auto &Arith = llvm::cast<InstArithmetic>(Instr);
+      Operand *Src0 = Src(0), *Src1 = Src(1);
+      return InstArithmetic::create(Caller, Arith.getOp(),
+                                    mapDest(Instr.getDest()), Src0, Src1);
+    }
+    case Inst::Assign: {
+      Operand *Src0 = Src(0);
+      return InstAssign::create(Caller, mapDest(Instr.getDest()), Src0);
+    }
+    case Inst::Cast: {
+      const auto &Cast = llvm::cast<InstCast>(Instr);
+      Operand *Src0 = Src(0);
+      return InstCast::create(Caller, Cast.getCastKind(),
+                              mapDest(Instr.getDest()), Src0);
+    }
+    case Inst::ExtractElement: {
+      Operand *Src0 = Src(0), *Src1 = Src(1);
+      return InstExtractElement::create(Caller, mapDest(Instr.getDest()), Src0,
+                                        Src1);
+    }
+    case Inst::Fcmp: {
+      const auto &Fcmp = llvm::cast<InstFcmp>(Instr);
+      Operand *Src0 = Src(0), *Src1 = Src(1);
+      return InstFcmp::create(Caller, Fcmp.getCondition(),
+                              mapDest(Instr.getDest()), Src0, Src1);
+    }
+    case Inst::Icmp: {
+      const auto &Icmp = llvm::cast<InstIcmp>(Instr);
+      Operand *Src0 = Src(0), *Src1 = Src(1);
+      return InstIcmp::create(Caller, Icmp.getCondition(),
+                              mapDest(Instr.getDest()), Src0, Src1);
+    }
+    case Inst::InsertElement: {
+      Operand *Src0 = Src(0), *Src1 = Src(1), *Src2 = Src(2);
+      return InstInsertElement::create(Caller, mapDest(Instr.getDest()), Src0,
+                                       Src1, Src2);
+    }
+    case Inst::Load: {
+      Operand *Addr = Src(0);
+      return InstLoad::create(Caller, mapDest(Instr.getDest()), Addr);
+    }
+    case Inst::Select: {
+      Operand *Cond = Src(0), *True = Src(1), *False = Src(2);
+      return InstSelect::create(Caller, mapDest(Instr.getDest()), Cond, True,
+                                False);
+    }
+    case Inst::Store: {
+      const auto &Store = llvm::cast<InstStore>(Instr);
+      return InstStore::create(Caller, mapOperand(Store.getData()),
+                               mapOperand(Store.getAddr()));
+    }
+    }
+  }
+
+  Cfg *const Caller;
+  const InstCall *const Call;
+  const Cfg *const Callee;
+  std::unordered_map<const Variable *, Operand *> Map;
+};
+
+/// Returns the callee of Call if it is a direct call to one of the Candidates
+/// whose signature matches the call.
+const Cfg *
+getInlinableCallee(const InstCall *Call,
+                   const std::map<GlobalString, const Cfg *> &Candidates) {
+  const auto *Target =
+      llvm::dyn_cast<ConstantRelocatable>(Call->getCallTarget());
+  if (Target == nullptr || Target->getOffset() != 0)
+    return nullptr;
+  auto Iter = Candidates.find(Target->getName());
+  if (Iter == Candidates.end())
+    return nullptr;
+  const Cfg *Callee = Iter->second;
+  const VarList &Args = Callee->getArgs();
+  if (Args.size() != Call->getNumArgs())
+    return nullptr;
+  for (SizeT I = 0; I < Args.size(); ++I) {
+    if (Args[I]->getType() != Call->getArg(I)->getType())
+      return nullptr;
+  }
+  const Variable *Dest = Call->getDest();
+  if (Dest != nullptr && Dest->getType() != Callee->getReturnType())
+    return nullptr;
+  return Callee;
+}
+
+} // end of anonymous namespace
+
+void inlineFunctions(GlobalContext *Ctx,
+                     std::vector<std::unique_ptr<Cfg>> &Funcs) {
+  TimerMarker T(TimerStack::TT_inlineFunctions, Ctx);
+  const SizeT Threshold = getFlags().getInlineThreshold();
+  std::map<GlobalString, const Cfg *> Candidates;
+  for (const auto &Func : Funcs) {
+    SizeT Size;
+    if (isInlinable(Func.get(), &Size) && Size <= Threshold)
+      Candidates[Func->getFunctionName()] = Func.get();
+  }
+  uint32_t InlinedCalls = 0;
+  if (!Candidates.empty()) {
+    for (const auto &Func : Funcs) {
+      if (Func->hasError())
+        continue;
+      // Install Func in TLS for its container allocators.
+      CfgLocalAllocatorScope _(Func.get());
+      for (CfgNode *Node : Func->getNodes()) {
+        InstList &Insts = Node->getInsts();
+        for (auto Iter = Insts.begin(), E = Insts.end(); Iter != E; ++Iter) {
+          auto *Call = llvm::dyn_cast<InstCall>(&*Iter);
+          if (Call == nullptr || Call->isDeleted())
+            continue;
+          const Cfg *Callee = getInlinableCallee(Call, Candidates);
+          if (Callee == nullptr)
+            continue;
+          CallInliner(Func.get(), Call, Callee).inlineBefore(Node, Iter);
+          Call->setDeleted();
+          ++InlinedCalls;
+        }
+      }
+    }
+  }
+  Ctx->statsUpdateInliner(Candidates.size(), InlinedCalls);
+}
+
+} // end of namespace Ice
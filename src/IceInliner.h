@@ -0,0 +1,36 @@
+//===- subzero/src/IceInliner.h - Module-level inliner ----------*- C++ -*-===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Declares the module-level inliner, which clones the bodies of small
+/// leaf functions into their call sites before translation.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SUBZERO_SRC_ICEINLINER_H
+#define SUBZERO_SRC_ICEINLINER_H
+
+#include "IceDefs.h"
+
+namespace Ice {
+
+/// Inlines calls among the parsed functions in Funcs. A callee is inlined if it
+/// consists of a single basic block of at most -inline-threshold instructions
+/// that makes no calls and has no allocas; every direct call to it from the
+/// other functions in Funcs is replaced by a copy of its body.
+///
+/// Since the callees are leaves, inlining never changes a callee, and the
+/// result only depends on the contents of Funcs, not on the order in which the
+/// functions are processed.
+void inlineFunctions(GlobalContext *Ctx,
+                     std::vector<std::unique_ptr<Cfg>> &Funcs);
+
+} // end of namespace Ice
+
+#endif // SUBZERO_SRC_ICEINLINER_H
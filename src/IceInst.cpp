@@ -79,7 +79,21 @@ const struct InstIcmpAttributes_ {
 Inst::Inst(Cfg *Func, InstKind Kind, SizeT MaxSrcs, Variable *Dest)
     : Kind(Kind), Number(Func->newInstNumber()), Dest(Dest), MaxSrcs(MaxSrcs),
       LiveRangesEnded(0) {
-  Srcs.reserve(MaxSrcs);
+  if (MaxSrcs > 0)
+    Srcs = Func->allocateArrayOf<Operand *>(MaxSrcs);
+}
+
+void Inst::growSources() {
+  // The old array stays in the arena, which only grows. This is rare, because
+  // nearly every instruction knows its number of operands when it is created.
+  constexpr SizeT MinSrcs = 4;
+  const SizeT NewMaxSrcs = std::max(MinSrcs, 2 * MaxSrcs);
+  assert(CfgAllocatorTraits::current() != nullptr);
+  auto *NewSrcs =
+      CfgAllocatorTraits::current()->Allocate<Operand *>(NewMaxSrcs);
+  std::copy(Srcs, Srcs + NumSrcs, NewSrcs);
+  Srcs = NewSrcs;
+  MaxSrcs = NewMaxSrcs;
 }
 
 const char *Inst::getInstName() const {
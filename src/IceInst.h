@@ -84,12 +84,16 @@ public:
 
   InstNumberT getNumber() const { return Number; }
   void renumber(Cfg *Func);
+  void setNumber(InstNumberT Value) { Number = Value; }
   enum {
     NumberDeleted = -1,
     NumberSentinel = 0,
     NumberInitial = 2,
     NumberExtended = NumberInitial - 1
   };
+  /// Instructions are numbered NumberStride apart, leaving gaps that
+  /// instructions inserted later can take without renumbering the Cfg.
+  static constexpr InstNumberT NumberStride = 16;
 
   bool isDeleted() const { return Deleted; }
   void setDeleted() { Deleted = true; }
@@ -103,7 +107,7 @@ public:
 
   Variable *getDest() const { return Dest; }
 
-  SizeT getSrcSize() const { return Srcs.size(); }
+  SizeT getSrcSize() const { return NumSrcs; }
   Operand *getSrc(SizeT I) const {
     assert(I < getSrcSize());
     return Srcs[I];
@@ -203,13 +207,16 @@ protected:
   Inst(Cfg *Func, InstKind Kind, SizeT MaxSrcs, Variable *Dest);
   void addSource(Operand *Src) {
     assert(Src);
-    Srcs.push_back(Src);
+    if (NumSrcs == MaxSrcs)
+      growSources();
+    Srcs[NumSrcs++] = Src;
   }
   void setLastUse(SizeT VarIndex) {
     if (VarIndex < CHAR_BIT * sizeof(LiveRangesEnded))
       LiveRangesEnded |= (((LREndedBits)1u) << VarIndex);
   }
   void resetLastUses() { LiveRangesEnded = 0; }
+  void growSources();
   /// The destroy() method lets the instruction cleanly release any memory that
   /// was allocated via the Cfg's allocator.
   virtual void destroy(Cfg *) {}
@@ -238,9 +245,14 @@ protected:
   bool IsDestRedefined = false;
 
   Variable *Dest;
-  const SizeT MaxSrcs; // only used for assert
-
-  CfgVector<Operand *> Srcs;
+  /// Srcs holds the source operands. It is allocated by the constructor from
+  /// the Cfg's arena, right after the instruction object that create() has
+  /// just allocated, so the operands are adjacent to the instruction in memory.
+  /// Instructions that are given more than the MaxSrcs operands they were
+  /// created with move their operands to a larger array.
+  Operand **Srcs = nullptr;
+  SizeT NumSrcs = 0;
+  SizeT MaxSrcs;
 
   /// LiveRangesEnded marks which Variables' live ranges end in this
   /// instruction. An instruction can have an arbitrary number of source
@@ -1481,8 +1481,10 @@ InstARM32Push::InstARM32Push(Cfg *Func, const VarList &Srcs)
   }
 }
 
-InstARM32Ret::InstARM32Ret(Cfg *Func, Variable *LR, Variable *Source)
-    : InstARM32(Func, InstARM32::Ret, Source ? 2 : 1, nullptr) {
+InstARM32Ret::InstARM32Ret(Cfg *Func, Variable *LR, Variable *Source,
+                           const ConstantRelocatable *SiblingCallTarget)
+    : InstARM32(Func, InstARM32::Ret, Source ? 2 : 1, nullptr),
+      SiblingCallTarget(SiblingCallTarget) {
   addSource(LR);
   if (Source)
     addSource(Source);
@@ -2722,6 +2724,13 @@ void InstARM32Ret::emit(const Cfg *Func) const {
   assert(LR->hasReg());
   assert(LR->getRegNum() == RegARM32::Reg_lr);
   Ostream &Str = Func->getContext()->getStrEmit();
+  if (SiblingCallTarget != nullptr) {
+    Str << "\t"
+           "b"
+           "\t";
+    SiblingCallTarget->emitWithoutPrefix(Func->getTarget());
+    return;
+  }
   Str << "\t"
          "bx"
          "\t";
@@ -2730,7 +2739,10 @@ void InstARM32Ret::emit(const Cfg *Func) const {
 
 void InstARM32Ret::emitIAS(const Cfg *Func) const {
   auto *Asm = Func->getAssembler<ARM32::AssemblerARM32>();
-  Asm->bx(RegARM32::Encoded_Reg_lr);
+  if (SiblingCallTarget != nullptr)
+    Asm->b(SiblingCallTarget);
+  else
+    Asm->bx(RegARM32::Encoded_Reg_lr);
   if (Asm->needsTextFixup())
     emitUsingTextFixup(Func);
 }
@@ -2740,6 +2752,11 @@ void InstARM32Ret::dump(const Cfg *Func) const {
     return;
   Ostream &Str = Func->getContext()->getStrDump();
   Type Ty = (getSrcSize() == 1 ? IceType_void : getSrc(0)->getType());
+  if (SiblingCallTarget != nullptr) {
+    Str << "b.sibling ";
+    SiblingCallTarget->dump(Func);
+    return;
+  }
   Str << "ret." << Ty << " ";
   dumpSources(Func);
 }
@@ -1289,15 +1289,24 @@ private:
 /// NOTE: Even though "bx" can be predicated, for now leave out the predication
 /// since it's not yet known to be useful for Ret. That may complicate finding
 /// the terminator instruction if it's not guaranteed to be executed.
+///
+/// If a SiblingCallTarget is given, the Ret is emitted as "b SiblingCallTarget"
+/// instead, so that the callee returns (through the restored lr) directly to
+/// this function's caller.
 class InstARM32Ret : public InstARM32 {
   InstARM32Ret() = delete;
   InstARM32Ret(const InstARM32Ret &) = delete;
   InstARM32Ret &operator=(const InstARM32Ret &) = delete;
 
 public:
-  static InstARM32Ret *create(Cfg *Func, Variable *LR,
-                              Variable *Source = nullptr) {
-    return new (Func->allocate<InstARM32Ret>()) InstARM32Ret(Func, LR, Source);
+  static InstARM32Ret *
+  create(Cfg *Func, Variable *LR, Variable *Source = nullptr,
+         const ConstantRelocatable *SiblingCallTarget = nullptr) {
+    return new (Func->allocate<InstARM32Ret>())
+        InstARM32Ret(Func, LR, Source, SiblingCallTarget);
+  }
+  const ConstantRelocatable *getSiblingCallTarget() const {
+    return SiblingCallTarget;
   }
   void emit(const Cfg *Func) const override;
   void emitIAS(const Cfg *Func) const override;
@@ -1305,7 +1314,10 @@ public:
   static bool classof(const Inst *Instr) { return isClassof(Instr, Ret); }
 
 private:
-  InstARM32Ret(Cfg *Func, Variable *LR, Variable *Source);
+  InstARM32Ret(Cfg *Func, Variable *LR, Variable *Source,
+               const ConstantRelocatable *SiblingCallTarget);
+
+  const ConstantRelocatable *SiblingCallTarget;
 };
 
 /// Store instruction. It's important for liveness that there is no Dest operand
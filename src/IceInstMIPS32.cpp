@@ -421,6 +421,86 @@ void InstMIPS32::emitThreeAddrLoHi(const char *Opcode, const InstMIPS32 *Inst,
   Inst->getSrc(1)->emit(Func);
 }
 
+bool InstMIPS32::canFillDelaySlot() const {
+  switch (static_cast<InstKindMIPS32>(getKind())) {
+  default:
+    return false;
+  case Addiu:
+  case Addu:
+  case And:
+  case Andi:
+  case Lui:
+  case Nor:
+  case Or:
+  case Ori:
+  case Sll:
+  case Sllv:
+  case Slt:
+  case Slti:
+  case Sltiu:
+  case Sltu:
+  case Sra:
+  case Srav:
+  case Srl:
+  case Srlv:
+  case Subu:
+  case Xor:
+  case Xori:
+    break;
+  }
+  const Variable *Dest = getDest();
+  if (Dest == nullptr || !Dest->hasReg())
+    return false;
+  for (SizeT I = 0; I < getSrcSize(); ++I) {
+    const Operand *Src = getSrc(I);
+    if (const auto *Var = llvm::dyn_cast<Variable>(Src)) {
+      if (!Var->hasReg())
+        return false;
+    } else if (!llvm::isa<ConstantInteger32>(Src)) {
+      // Relocatable immediates may be expanded by the textual assembler.
+      return false;
+    }
+  }
+  return true;
+}
+
+void InstMIPS32::emitDelaySlotStart(const Cfg *Func) const {
+  if (!BuildDefs::dump() || DelaySlotInst == nullptr)
+    return;
+  Ostream &Str = Func->getContext()->getStrEmit();
+  Str << "\t.set\tnoreorder\n";
+}
+
+void InstMIPS32::emitDelaySlotEnd(const Cfg *Func) const {
+  if (!BuildDefs::dump() || DelaySlotInst == nullptr)
+    return;
+  Ostream &Str = Func->getContext()->getStrEmit();
+  Str << "\n";
+  DelaySlotInst->emit(Func);
+  Str << "\n\t.set\treorder";
+}
+
+void InstMIPS32::emitIASDelaySlotStart(const Cfg *Func) const {
+  if (DelaySlotInst == nullptr)
+    return;
+  Func->getAssembler<MIPS32::AssemblerMIPS32>()->fillNextDelaySlot();
+}
+
+void InstMIPS32::emitIASDelaySlotEnd(const Cfg *Func) const {
+  if (DelaySlotInst == nullptr)
+    return;
+  DelaySlotInst->emitIAS(Func);
+}
+
+void InstMIPS32::dumpDelaySlot(const Cfg *Func) const {
+  if (!BuildDefs::dump() || DelaySlotInst == nullptr)
+    return;
+  Ostream &Str = Func->getContext()->getStrDump();
+  Str << " [delay slot: ";
+  DelaySlotInst->dump(Func);
+  Str << "]";
+}
+
 void InstMIPS32Ret::emit(const Cfg *Func) const {
   if (!BuildDefs::dump())
     return;
@@ -429,14 +509,18 @@ void InstMIPS32Ret::emit(const Cfg *Func) const {
   assert(RA->hasReg());
   assert(RA->getRegNum() == RegMIPS32::Reg_RA);
   Ostream &Str = Func->getContext()->getStrEmit();
+  emitDelaySlotStart(Func);
   Str << "\t"
          "jr"
          "\t";
   RA->emit(Func);
+  emitDelaySlotEnd(Func);
 }
 
 void InstMIPS32Br::emitIAS(const Cfg *Func) const {
   auto *Asm = Func->getAssembler<MIPS32::AssemblerMIPS32>();
+  // Only the first branch's delay slot can be filled.
+  emitIASDelaySlotStart(Func);
   if (Label != nullptr) {
     // Intra-block branches are of kind bcc
     if (isUnconditionalBranch()) {
@@ -466,16 +550,20 @@ void InstMIPS32Br::emitIAS(const Cfg *Func) const {
                Asm->getOrCreateCfgNodeLabel(getTargetFalse()->getIndex()));
       break;
     }
+    emitIASDelaySlotEnd(Func);
     if (getTargetTrue()) {
       Asm->b(Asm->getOrCreateCfgNodeLabel(getTargetTrue()->getIndex()));
     }
+    return;
   }
+  emitIASDelaySlotEnd(Func);
 }
 
 void InstMIPS32Br::emit(const Cfg *Func) const {
   if (!BuildDefs::dump())
     return;
   Ostream &Str = Func->getContext()->getStrEmit();
+  emitDelaySlotStart(Func);
   Str << "\t"
          "b" << InstMIPS32CondAttributes[Predicate].EmitString << "\t";
   if (Label != nullptr) {
@@ -514,13 +602,16 @@ void InstMIPS32Br::emit(const Cfg *Func) const {
       }
       }
       Str << getTargetFalse()->getAsmName();
+      emitDelaySlotEnd(Func);
       if (getTargetTrue()) {
         Str << "\n\t"
             << "b"
             << "\t" << getTargetTrue()->getAsmName();
       }
+      return;
     }
   }
+  emitDelaySlotEnd(Func);
 }
 
 void InstMIPS32Br::dump(const Cfg *Func) const {
@@ -553,6 +644,7 @@ void InstMIPS32Br::dump(const Cfg *Func) const {
       }
     }
   }
+  dumpDelaySlot(Func);
 }
 
 void InstMIPS32Call::emit(const Cfg *Func) const {
@@ -568,16 +660,19 @@ void InstMIPS32Call::emit(const Cfg *Func) const {
                  llvm::dyn_cast<ConstantRelocatable>(getCallTarget())) {
     // Calls only have 26-bits, but the linker should insert veneers to extend
     // the range if needed.
+    emitDelaySlotStart(Func);
     Str << "\t"
            "jal"
            "\t";
     CallTarget->emitWithoutPrefix(Func->getTarget());
   } else {
+    emitDelaySlotStart(Func);
     Str << "\t"
            "jalr"
            "\t";
     getCallTarget()->emit(Func);
   }
+  emitDelaySlotEnd(Func);
 }
 
 void InstMIPS32Call::emitIAS(const Cfg *Func) const {
@@ -587,11 +682,14 @@ void InstMIPS32Call::emitIAS(const Cfg *Func) const {
     llvm::report_fatal_error("MIPS32Call to ConstantInteger32");
   } else if (const auto *CallTarget =
                  llvm::dyn_cast<ConstantRelocatable>(getCallTarget())) {
+    emitIASDelaySlotStart(Func);
     Asm->jal(CallTarget);
   } else {
     const Operand *ImplicitRA = nullptr;
+    emitIASDelaySlotStart(Func);
     Asm->jalr(getCallTarget(), ImplicitRA);
   }
+  emitIASDelaySlotEnd(Func);
 }
 
 void InstMIPS32Call::dump(const Cfg *Func) const {
@@ -604,6 +702,7 @@ void InstMIPS32Call::dump(const Cfg *Func) const {
   }
   Str << "call ";
   getCallTarget()->dump(Func);
+  dumpDelaySlot(Func);
 }
 
 void InstMIPS32Ret::emitIAS(const Cfg *Func) const {
@@ -612,7 +711,9 @@ void InstMIPS32Ret::emitIAS(const Cfg *Func) const {
   assert(RA->hasReg());
   assert(RA->getRegNum() == RegMIPS32::Reg_RA);
   (void)RA;
+  emitIASDelaySlotStart(Func);
   Asm->ret();
+  emitIASDelaySlotEnd(Func);
 }
 
 void InstMIPS32Ret::dump(const Cfg *Func) const {
@@ -622,6 +723,7 @@ void InstMIPS32Ret::dump(const Cfg *Func) const {
   Type Ty = (getSrcSize() == 1 ? IceType_void : getSrc(0)->getType());
   Str << "ret." << Ty << " ";
   dumpSources(Func);
+  dumpDelaySlot(Func);
 }
 
 void InstMIPS32Mov::emit(const Cfg *Func) const {
@@ -919,6 +1021,11 @@ template <> void InstMIPS32Ll::emitIAS(const Cfg *Func) const {
 template <> void InstMIPS32Lw::emitIAS(const Cfg *Func) const {
   auto *Asm = Func->getAssembler<MIPS32::AssemblerMIPS32>();
   auto *Mem = llvm::dyn_cast<OperandMIPS32Mem>(getSrc(0));
+  if (Reloc != RO_No) {
+    // Pooled constants are addressed as %lo(label)(base).
+    Asm->lw(getDest(), Mem->getBase(), Mem->getOffset(), Reloc);
+    return;
+  }
   ConstantInteger32 *Offset = llvm::cast<ConstantInteger32>(Mem->getOffset());
   uint32_t Imm = static_cast<uint32_t>(Offset->getValue());
   Asm->lw(getDest(), Mem->getBase(), Imm);
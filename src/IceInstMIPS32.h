@@ -315,12 +315,34 @@ public:
   static void emitThreeAddrLoHi(const char *Opcode, const InstMIPS32 *Inst,
                                 const Cfg *Func);
 
+  /// Delay slots. A branch, call or return whose delay slot has been filled
+  /// emits DelaySlotInst into it, instead of a nop. The instruction moved into
+  /// the slot is deleted from its original position.
+  void setDelaySlotInst(const InstMIPS32 *Instr) { DelaySlotInst = Instr; }
+  const InstMIPS32 *getDelaySlotInst() const { return DelaySlotInst; }
+  /// Returns true if the instruction may be moved into a delay slot: it must
+  /// be a single, non-trapping instruction operating on registers, which both
+  /// the textual and the integrated assembler emit as is.
+  bool canFillDelaySlot() const;
+
 protected:
   InstMIPS32(Cfg *Func, InstKindMIPS32 Kind, SizeT Maxsrcs, Variable *Dest)
       : InstTarget(Func, static_cast<InstKind>(Kind), Maxsrcs, Dest) {}
   static bool isClassof(const Inst *Inst, InstKindMIPS32 MyKind) {
     return Inst->getKind() == static_cast<InstKind>(MyKind);
   }
+
+  /// Helpers for emitting a control transfer with a filled delay slot. The
+  /// textual form switches the assembler to noreorder mode around the transfer
+  /// and the slot; the integrated assembler is told not to emit the nop.
+  void emitDelaySlotStart(const Cfg *Func) const;
+  void emitDelaySlotEnd(const Cfg *Func) const;
+  void emitIASDelaySlotStart(const Cfg *Func) const;
+  void emitIASDelaySlotEnd(const Cfg *Func) const;
+  void dumpDelaySlot(const Cfg *Func) const;
+
+private:
+  const InstMIPS32 *DelaySlotInst = nullptr;
 };
 
 /// Ret pseudo-instruction. This is actually a "jr" instruction with an "ra"
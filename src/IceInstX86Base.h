@@ -59,6 +59,7 @@ template <typename TraitsType> struct InstImpl {
   using GPREmitterAddrOp = typename Traits::Assembler::GPREmitterAddrOp;
   using GPREmitterRegOp = typename Traits::Assembler::GPREmitterRegOp;
   using GPREmitterShiftD = typename Traits::Assembler::GPREmitterShiftD;
+  using GPREmitterShiftx = typename Traits::Assembler::GPREmitterShiftx;
   using GPREmitterShiftOp = typename Traits::Assembler::GPREmitterShiftOp;
   using GPREmitterOneOp = typename Traits::Assembler::GPREmitterOneOp;
   using XmmEmitterRegOp = typename Traits::Assembler::XmmEmitterRegOp;
@@ -112,6 +113,7 @@ template <typename TraitsType> struct InstImpl {
       Label,
       Lea,
       Load,
+      Lzcnt,
       Mfence,
       Minps,
       Maxps,
@@ -149,6 +151,7 @@ template <typename TraitsType> struct InstImpl {
       Pmaddwd,
       Pmuludq,
       Pop,
+      Popcnt,
       Por,
       Pshufb,
       Pshufd,
@@ -168,13 +171,16 @@ template <typename TraitsType> struct InstImpl {
       Rol,
       Round,
       Sar,
+      Sarx,
       Sbb,
       SbbRMW,
       Setcc,
       Shl,
       Shld,
+      Shlx,
       Shr,
       Shrd,
+      Shrx,
       Shufps,
       Sqrt,
       Store,
@@ -186,6 +192,7 @@ template <typename TraitsType> struct InstImpl {
       Subps,
       Subss,
       Test,
+      Tzcnt,
       Ucomiss,
       UD2,
       Xadd,
@@ -515,11 +522,21 @@ template <typename TraitsType> struct InstImpl {
                                 const Operand *Src,
                                 const XmmEmitterRegOp &Emitter);
 
+  /// Emit the VEX encoded three-operand form Var = Src0 op Src1.
+  static void emitIASVexRegOpTyXMM(const Cfg *Func, Type Ty,
+                                   const Variable *Var, const Variable *Src0,
+                                   const Operand *Src1,
+                                   const XmmEmitterRegOp &Emitter);
+
   static void emitIASGPRShiftDouble(const Cfg *Func, const Variable *Dest,
                                     const Operand *Src1Op,
                                     const Operand *Src2Op,
                                     const GPREmitterShiftD &Emitter);
 
+  static void emitIASGPRShiftx(const Cfg *Func, const Variable *Dest,
+                               const Operand *Src, const Operand *Shifter,
+                               const GPREmitterShiftx &Emitter);
+
   template <typename DReg_t, typename SReg_t, DReg_t (*destEnc)(RegNumT),
             SReg_t (*srcEnc)(RegNumT)>
   static void emitIASCastRegOp(const Cfg *Func, Type DestTy,
@@ -589,7 +606,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -656,7 +673,7 @@ template <typename TraitsType> struct InstImpl {
     }
 
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -719,7 +736,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -761,7 +778,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -806,7 +823,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -847,7 +864,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -898,7 +915,18 @@ template <typename TraitsType> struct InstImpl {
         SuffixString = Traits::TypeAttributes[DestTy].PackString;
         break;
       }
-      this->emitTwoAddress(Func, Opcode, SuffixString);
+      if (!isVexForm()) {
+        this->emitTwoAddress(Func, Opcode, SuffixString);
+        return;
+      }
+      Ostream &Str = Func->getContext()->getStrEmit();
+      assert(this->getSrcSize() == 2);
+      Str << "\tv" << Opcode << SuffixString << "\t";
+      this->getSrc(1)->emit(Func);
+      Str << ", ";
+      this->getSrc(0)->emit(Func);
+      Str << ", ";
+      this->getDest()->emit(Func);
     }
     void emitIAS(const Cfg *Func) const override {
       this->validateVectorAddrMode();
@@ -906,6 +934,12 @@ template <typename TraitsType> struct InstImpl {
       if (NeedsElementType)
         Ty = typeElementType(Ty);
       assert(this->getSrcSize() == 2);
+      if (isVexForm()) {
+        emitIASVexRegOpTyXMM(Func, Ty, this->getDest(),
+                             llvm::cast<Variable>(this->getSrc(0)),
+                             this->getSrc(1), Emitter);
+        return;
+      }
       emitIASRegOpTyXMM(Func, Ty, this->getDest(), this->getSrc(1), Emitter);
     }
     void dump(const Cfg *Func) const override {
@@ -917,7 +951,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -928,6 +962,22 @@ template <typename TraitsType> struct InstImpl {
       this->addSource(Dest);
       this->addSource(Source);
     }
+    /// The three-operand form Dest = Source0 op Source1, which is only
+    /// available with AVX and is emitted with the VEX encoding.
+    InstX86BaseBinopXmm(Cfg *Func, Variable *Dest, Variable *Source0,
+                        Operand *Source1,
+                        Type ArithmeticTypeOverride = IceType_void)
+        : InstX86Base(Func, K, 2, Dest),
+          ArithmeticTypeOverride(ArithmeticTypeOverride) {
+      assert(InstX86Base::getTarget(Func)->getInstructionSet() >=
+             Traits::AVX);
+      this->addSource(Source0);
+      this->addSource(Source1);
+    }
+
+    /// Returns true if the instruction does not overwrite its first source,
+    /// i.e. it was created with the three-operand constructor.
+    bool isVexForm() const { return this->getSrc(0) != this->getDest(); }
 
     const Type ArithmeticTypeOverride;
     static const char *Opcode;
@@ -971,7 +1021,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -1015,7 +1065,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -1062,7 +1112,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -1076,6 +1126,58 @@ template <typename TraitsType> struct InstImpl {
     static const char *Opcode;
   };
 
+  /// Base class for the BMI2 shifts, Dest := Src0 shifted by Src1, where Src1
+  /// is a register.
+  template <typename InstX86Base::InstKindX86 K>
+  class InstX86BaseShiftx : public InstX86Base {
+    InstX86BaseShiftx() = delete;
+    InstX86BaseShiftx(const InstX86BaseShiftx &) = delete;
+    InstX86BaseShiftx &operator=(const InstX86BaseShiftx &) = delete;
+
+  public:
+    using Base = InstX86BaseShiftx<K>;
+
+    void emit(const Cfg *Func) const override {
+      if (!BuildDefs::dump())
+        return;
+      Ostream &Str = Func->getContext()->getStrEmit();
+      assert(this->getSrcSize() == 2);
+      Str << "\t" << Opcode << "\t";
+      this->getSrc(1)->emit(Func);
+      Str << ", ";
+      this->getSrc(0)->emit(Func);
+      Str << ", ";
+      this->getDest()->emit(Func);
+    }
+    void emitIAS(const Cfg *Func) const override {
+      assert(this->getSrcSize() == 2);
+      emitIASGPRShiftx(Func, this->getDest(), this->getSrc(0),
+                       this->getSrc(1), Emitter);
+    }
+    void dump(const Cfg *Func) const override {
+      if (!BuildDefs::dump())
+        return;
+      Ostream &Str = Func->getContext()->getStrDump();
+      this->dumpDest(Func);
+      Str << " = " << Opcode << "." << this->getDest()->getType() << " ";
+      this->dumpSources(Func);
+    }
+    static bool classof(const Inst *Instr) {
+      return InstX86Base::isClassof(Instr, K);
+    }
+
+  protected:
+    InstX86BaseShiftx(Cfg *Func, Variable *Dest, Operand *Source0,
+                      Variable *Source1)
+        : InstX86Base(Func, K, 2, Dest) {
+      this->addSource(Source0);
+      this->addSource(Source1);
+    }
+
+    static const char *Opcode;
+    static const GPREmitterShiftx Emitter;
+  };
+
   /// Base class for assignment instructions
   template <typename InstX86Base::InstKindX86 K>
   class InstX86BaseMovlike : public InstX86Base {
@@ -1119,7 +1221,7 @@ template <typename TraitsType> struct InstImpl {
       this->dumpSources(Func);
     }
     static bool classof(const Inst *Instr) {
-      return InstX86Base::isClassof(Instr, InstX86Base::K);
+      return InstX86Base::isClassof(Instr, K);
     }
 
   protected:
@@ -1180,6 +1282,40 @@ template <typename TraitsType> struct InstImpl {
         : InstX86BaseUnaryopGPR<InstX86Base::Bsr>(Func, Dest, Src) {}
   };
 
+  class InstX86Popcnt : public InstX86BaseUnaryopGPR<InstX86Base::Popcnt> {
+  public:
+    static InstX86Popcnt *create(Cfg *Func, Variable *Dest, Operand *Src) {
+      return new (Func->allocate<InstX86Popcnt>())
+          InstX86Popcnt(Func, Dest, Src);
+    }
+
+  private:
+    InstX86Popcnt(Cfg *Func, Variable *Dest, Operand *Src)
+        : InstX86BaseUnaryopGPR<InstX86Base::Popcnt>(Func, Dest, Src) {}
+  };
+
+  class InstX86Lzcnt : public InstX86BaseUnaryopGPR<InstX86Base::Lzcnt> {
+  public:
+    static InstX86Lzcnt *create(Cfg *Func, Variable *Dest, Operand *Src) {
+      return new (Func->allocate<InstX86Lzcnt>()) InstX86Lzcnt(Func, Dest, Src);
+    }
+
+  private:
+    InstX86Lzcnt(Cfg *Func, Variable *Dest, Operand *Src)
+        : InstX86BaseUnaryopGPR<InstX86Base::Lzcnt>(Func, Dest, Src) {}
+  };
+
+  class InstX86Tzcnt : public InstX86BaseUnaryopGPR<InstX86Base::Tzcnt> {
+  public:
+    static InstX86Tzcnt *create(Cfg *Func, Variable *Dest, Operand *Src) {
+      return new (Func->allocate<InstX86Tzcnt>()) InstX86Tzcnt(Func, Dest, Src);
+    }
+
+  private:
+    InstX86Tzcnt(Cfg *Func, Variable *Dest, Operand *Src)
+        : InstX86BaseUnaryopGPR<InstX86Base::Tzcnt>(Func, Dest, Src) {}
+  };
+
   class InstX86Lea : public InstX86BaseUnaryopGPR<InstX86Base::Lea> {
   public:
     static InstX86Lea *create(Cfg *Func, Variable *Dest, Operand *Src) {
@@ -1378,12 +1514,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Addps>())
           InstX86Addps(Func, Dest, Source);
     }
+    static InstX86Addps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Addps>())
+          InstX86Addps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Addps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Addps, true,
                               InstX86Base::SseSuffix::Packed>(Func, Dest,
                                                               Source) {}
+    InstX86Addps(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Addps, true,
+                              InstX86Base::SseSuffix::Packed>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Adc : public InstX86BaseBinopGPR<InstX86Base::Adc> {
@@ -1418,12 +1563,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Addss>())
           InstX86Addss(Func, Dest, Source);
     }
+    static InstX86Addss *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Addss>())
+          InstX86Addss(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Addss(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Addss, false,
                               InstX86Base::SseSuffix::Scalar>(Func, Dest,
                                                               Source) {}
+    InstX86Addss(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Addss, false,
+                              InstX86Base::SseSuffix::Scalar>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Padd
@@ -1434,12 +1588,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Padd>())
           InstX86Padd(Func, Dest, Source);
     }
+    static InstX86Padd *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                               Operand *Source1) {
+      return new (Func->allocate<InstX86Padd>())
+          InstX86Padd(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Padd(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Padd, true,
                               InstX86Base::SseSuffix::Integral>(Func, Dest,
                                                                 Source) {}
+    InstX86Padd(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Padd, true,
+                              InstX86Base::SseSuffix::Integral>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Padds
@@ -1450,12 +1613,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Padds>())
           InstX86Padds(Func, Dest, Source);
     }
+    static InstX86Padds *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Padds>())
+          InstX86Padds(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Padds(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Padds, true,
                               InstX86Base::SseSuffix::Integral>(Func, Dest,
                                                                 Source) {}
+    InstX86Padds(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Padds, true,
+                              InstX86Base::SseSuffix::Integral>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Paddus
@@ -1466,12 +1638,22 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Paddus>())
           InstX86Paddus(Func, Dest, Source);
     }
+    static InstX86Paddus *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                 Operand *Source1) {
+      return new (Func->allocate<InstX86Paddus>())
+          InstX86Paddus(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Paddus(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Paddus, true,
                               InstX86Base::SseSuffix::Integral>(Func, Dest,
                                                                 Source) {}
+    InstX86Paddus(Cfg *Func, Variable *Dest, Variable *Source0,
+                  Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Paddus, true,
+                              InstX86Base::SseSuffix::Integral>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Sub : public InstX86BaseBinopGPR<InstX86Base::Sub> {
@@ -1506,12 +1688,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Subps>())
           InstX86Subps(Func, Dest, Source);
     }
+    static InstX86Subps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Subps>())
+          InstX86Subps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Subps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Subps, true,
                               InstX86Base::SseSuffix::Packed>(Func, Dest,
                                                               Source) {}
+    InstX86Subps(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Subps, true,
+                              InstX86Base::SseSuffix::Packed>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Subss
@@ -1522,12 +1713,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Subss>())
           InstX86Subss(Func, Dest, Source);
     }
+    static InstX86Subss *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Subss>())
+          InstX86Subss(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Subss(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Subss, false,
                               InstX86Base::SseSuffix::Scalar>(Func, Dest,
                                                               Source) {}
+    InstX86Subss(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Subss, false,
+                              InstX86Base::SseSuffix::Scalar>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Sbb : public InstX86BaseBinopGPR<InstX86Base::Sbb> {
@@ -1562,12 +1762,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Psub>())
           InstX86Psub(Func, Dest, Source);
     }
+    static InstX86Psub *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                               Operand *Source1) {
+      return new (Func->allocate<InstX86Psub>())
+          InstX86Psub(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Psub(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Psub, true,
                               InstX86Base::SseSuffix::Integral>(Func, Dest,
                                                                 Source) {}
+    InstX86Psub(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Psub, true,
+                              InstX86Base::SseSuffix::Integral>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Psubs
@@ -1578,12 +1787,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Psubs>())
           InstX86Psubs(Func, Dest, Source);
     }
+    static InstX86Psubs *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Psubs>())
+          InstX86Psubs(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Psubs(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Psubs, true,
                               InstX86Base::SseSuffix::Integral>(Func, Dest,
                                                                 Source) {}
+    InstX86Psubs(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Psubs, true,
+                              InstX86Base::SseSuffix::Integral>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Psubus
@@ -1594,12 +1812,22 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Psubus>())
           InstX86Psubus(Func, Dest, Source);
     }
+    static InstX86Psubus *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                 Operand *Source1) {
+      return new (Func->allocate<InstX86Psubus>())
+          InstX86Psubus(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Psubus(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Psubus, true,
                               InstX86Base::SseSuffix::Integral>(Func, Dest,
                                                                 Source) {}
+    InstX86Psubus(Cfg *Func, Variable *Dest, Variable *Source0,
+                  Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Psubus, true,
+                              InstX86Base::SseSuffix::Integral>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86And : public InstX86BaseBinopGPR<InstX86Base::And> {
@@ -1621,12 +1849,22 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Andnps>())
           InstX86Andnps(Func, Dest, Source);
     }
+    static InstX86Andnps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                 Operand *Source1) {
+      return new (Func->allocate<InstX86Andnps>())
+          InstX86Andnps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Andnps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Andnps, true,
                               InstX86Base::SseSuffix::Packed>(Func, Dest,
                                                               Source) {}
+    InstX86Andnps(Cfg *Func, Variable *Dest, Variable *Source0,
+                  Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Andnps, true,
+                              InstX86Base::SseSuffix::Packed>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Andps
@@ -1637,12 +1875,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Andps>())
           InstX86Andps(Func, Dest, Source);
     }
+    static InstX86Andps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Andps>())
+          InstX86Andps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Andps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Andps, true,
                               InstX86Base::SseSuffix::Packed>(Func, Dest,
                                                               Source) {}
+    InstX86Andps(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Andps, true,
+                              InstX86Base::SseSuffix::Packed>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86AndRMW : public InstX86BaseBinopRMW<InstX86Base::AndRMW> {
@@ -1665,12 +1912,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Pand>())
           InstX86Pand(Func, Dest, Source);
     }
+    static InstX86Pand *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                               Operand *Source1) {
+      return new (Func->allocate<InstX86Pand>())
+          InstX86Pand(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Pand(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Pand, false,
                               InstX86Base::SseSuffix::None>(Func, Dest,
                                                             Source) {}
+    InstX86Pand(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Pand, false,
+                              InstX86Base::SseSuffix::None>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Pandn
@@ -1681,12 +1937,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Pandn>())
           InstX86Pandn(Func, Dest, Source);
     }
+    static InstX86Pandn *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Pandn>())
+          InstX86Pandn(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Pandn(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Pandn, false,
                               InstX86Base::SseSuffix::None>(Func, Dest,
                                                             Source) {}
+    InstX86Pandn(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Pandn, false,
+                              InstX86Base::SseSuffix::None>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Maxss
@@ -1697,12 +1962,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Maxss>())
           InstX86Maxss(Func, Dest, Source);
     }
+    static InstX86Maxss *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Maxss>())
+          InstX86Maxss(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Maxss(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Maxss, true,
                               InstX86Base::SseSuffix::Scalar>(Func, Dest,
                                                               Source) {}
+    InstX86Maxss(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Maxss, true,
+                              InstX86Base::SseSuffix::Scalar>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Minss
@@ -1713,12 +1987,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Minss>())
           InstX86Minss(Func, Dest, Source);
     }
+    static InstX86Minss *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Minss>())
+          InstX86Minss(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Minss(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Minss, true,
                               InstX86Base::SseSuffix::Scalar>(Func, Dest,
                                                               Source) {}
+    InstX86Minss(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Minss, true,
+                              InstX86Base::SseSuffix::Scalar>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Maxps
@@ -1729,12 +2012,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Maxps>())
           InstX86Maxps(Func, Dest, Source);
     }
+    static InstX86Maxps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Maxps>())
+          InstX86Maxps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Maxps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Maxps, true,
                               InstX86Base::SseSuffix::None>(Func, Dest,
                                                             Source) {}
+    InstX86Maxps(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Maxps, true,
+                              InstX86Base::SseSuffix::None>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Minps
@@ -1745,12 +2037,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Minps>())
           InstX86Minps(Func, Dest, Source);
     }
+    static InstX86Minps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Minps>())
+          InstX86Minps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Minps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Minps, true,
                               InstX86Base::SseSuffix::None>(Func, Dest,
                                                             Source) {}
+    InstX86Minps(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Minps, true,
+                              InstX86Base::SseSuffix::None>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Or : public InstX86BaseBinopGPR<InstX86Base::Or> {
@@ -1772,12 +2073,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Orps>())
           InstX86Orps(Func, Dest, Source);
     }
+    static InstX86Orps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                               Operand *Source1) {
+      return new (Func->allocate<InstX86Orps>())
+          InstX86Orps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Orps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Orps, true,
                               InstX86Base::SseSuffix::Packed>(Func, Dest,
                                                               Source) {}
+    InstX86Orps(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Orps, true,
+                              InstX86Base::SseSuffix::Packed>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86OrRMW : public InstX86BaseBinopRMW<InstX86Base::OrRMW> {
@@ -1799,12 +2109,21 @@ template <typename TraitsType> struct InstImpl {
     static InstX86Por *create(Cfg *Func, Variable *Dest, Operand *Source) {
       return new (Func->allocate<InstX86Por>()) InstX86Por(Func, Dest, Source);
     }
+    static InstX86Por *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                              Operand *Source1) {
+      return new (Func->allocate<InstX86Por>())
+          InstX86Por(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Por(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Por, false,
                               InstX86Base::SseSuffix::None>(Func, Dest,
                                                             Source) {}
+    InstX86Por(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Por, false,
+                              InstX86Base::SseSuffix::None>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Xor : public InstX86BaseBinopGPR<InstX86Base::Xor> {
@@ -1826,12 +2145,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Xorps>())
           InstX86Xorps(Func, Dest, Source);
     }
+    static InstX86Xorps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Xorps>())
+          InstX86Xorps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Xorps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Xorps, true,
                               InstX86Base::SseSuffix::Packed>(Func, Dest,
                                                               Source) {}
+    InstX86Xorps(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Xorps, true,
+                              InstX86Base::SseSuffix::Packed>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86XorRMW : public InstX86BaseBinopRMW<InstX86Base::XorRMW> {
@@ -1854,12 +2182,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Pxor>())
           InstX86Pxor(Func, Dest, Source);
     }
+    static InstX86Pxor *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                               Operand *Source1) {
+      return new (Func->allocate<InstX86Pxor>())
+          InstX86Pxor(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Pxor(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Pxor, false,
                               InstX86Base::SseSuffix::None>(Func, Dest,
                                                             Source) {}
+    InstX86Pxor(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Pxor, false,
+                              InstX86Base::SseSuffix::None>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Imul : public InstX86BaseBinopGPR<InstX86Base::Imul> {
@@ -1896,6 +2233,45 @@ template <typename TraitsType> struct InstImpl {
                                                           Source1) {}
   };
 
+  class InstX86Shlx : public InstX86BaseShiftx<InstX86Base::Shlx> {
+  public:
+    static InstX86Shlx *create(Cfg *Func, Variable *Dest, Operand *Source0,
+                               Variable *Source1) {
+      return new (Func->allocate<InstX86Shlx>())
+          InstX86Shlx(Func, Dest, Source0, Source1);
+    }
+
+  private:
+    InstX86Shlx(Cfg *Func, Variable *Dest, Operand *Source0, Variable *Source1)
+        : InstX86BaseShiftx<InstX86Base::Shlx>(Func, Dest, Source0, Source1) {}
+  };
+
+  class InstX86Shrx : public InstX86BaseShiftx<InstX86Base::Shrx> {
+  public:
+    static InstX86Shrx *create(Cfg *Func, Variable *Dest, Operand *Source0,
+                               Variable *Source1) {
+      return new (Func->allocate<InstX86Shrx>())
+          InstX86Shrx(Func, Dest, Source0, Source1);
+    }
+
+  private:
+    InstX86Shrx(Cfg *Func, Variable *Dest, Operand *Source0, Variable *Source1)
+        : InstX86BaseShiftx<InstX86Base::Shrx>(Func, Dest, Source0, Source1) {}
+  };
+
+  class InstX86Sarx : public InstX86BaseShiftx<InstX86Base::Sarx> {
+  public:
+    static InstX86Sarx *create(Cfg *Func, Variable *Dest, Operand *Source0,
+                               Variable *Source1) {
+      return new (Func->allocate<InstX86Sarx>())
+          InstX86Sarx(Func, Dest, Source0, Source1);
+    }
+
+  private:
+    InstX86Sarx(Cfg *Func, Variable *Dest, Operand *Source0, Variable *Source1)
+        : InstX86BaseShiftx<InstX86Base::Sarx>(Func, Dest, Source0, Source1) {}
+  };
+
   class InstX86Mulps
       : public InstX86BaseBinopXmm<InstX86Base::Mulps, true,
                                    InstX86Base::SseSuffix::Packed> {
@@ -1904,12 +2280,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Mulps>())
           InstX86Mulps(Func, Dest, Source);
     }
+    static InstX86Mulps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Mulps>())
+          InstX86Mulps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Mulps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Mulps, true,
                               InstX86Base::SseSuffix::Packed>(Func, Dest,
                                                               Source) {}
+    InstX86Mulps(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Mulps, true,
+                              InstX86Base::SseSuffix::Packed>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Mulss
@@ -1920,12 +2305,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Mulss>())
           InstX86Mulss(Func, Dest, Source);
     }
+    static InstX86Mulss *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Mulss>())
+          InstX86Mulss(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Mulss(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Mulss, false,
                               InstX86Base::SseSuffix::Scalar>(Func, Dest,
                                                               Source) {}
+    InstX86Mulss(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Mulss, false,
+                              InstX86Base::SseSuffix::Scalar>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Pmull
@@ -1946,12 +2340,31 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Pmull>())
           InstX86Pmull(Func, Dest, Source);
     }
+    static InstX86Pmull *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      bool TypesAreValid =
+          Dest->getType() == IceType_v4i32 || Dest->getType() == IceType_v8i16;
+      auto *Target = InstX86Base::getTarget(Func);
+      bool InstructionSetIsValid =
+          Dest->getType() == IceType_v8i16 ||
+          Target->getInstructionSet() >= Traits::SSE4_1;
+      (void)TypesAreValid;
+      (void)InstructionSetIsValid;
+      assert(TypesAreValid);
+      assert(InstructionSetIsValid);
+      return new (Func->allocate<InstX86Pmull>())
+          InstX86Pmull(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Pmull(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Pmull, true,
                               InstX86Base::SseSuffix::Integral>(Func, Dest,
                                                                 Source) {}
+    InstX86Pmull(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Pmull, true,
+                              InstX86Base::SseSuffix::Integral>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Pmulhw
@@ -2018,12 +2431,25 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Pmuludq>())
           InstX86Pmuludq(Func, Dest, Source);
     }
+    static InstX86Pmuludq *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                  Operand *Source1) {
+      assert(Dest->getType() == IceType_v4i32 &&
+             Source0->getType() == IceType_v4i32 &&
+             Source1->getType() == IceType_v4i32);
+      return new (Func->allocate<InstX86Pmuludq>())
+          InstX86Pmuludq(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Pmuludq(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Pmuludq, false,
                               InstX86Base::SseSuffix::None>(Func, Dest,
                                                             Source) {}
+    InstX86Pmuludq(Cfg *Func, Variable *Dest, Variable *Source0,
+                   Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Pmuludq, false,
+                              InstX86Base::SseSuffix::None>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Divps
@@ -2034,12 +2460,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Divps>())
           InstX86Divps(Func, Dest, Source);
     }
+    static InstX86Divps *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Divps>())
+          InstX86Divps(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Divps(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Divps, true,
                               InstX86Base::SseSuffix::Packed>(Func, Dest,
                                                               Source) {}
+    InstX86Divps(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Divps, true,
+                              InstX86Base::SseSuffix::Packed>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Divss
@@ -2050,12 +2485,21 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Divss>())
           InstX86Divss(Func, Dest, Source);
     }
+    static InstX86Divss *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                Operand *Source1) {
+      return new (Func->allocate<InstX86Divss>())
+          InstX86Divss(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Divss(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Divss, false,
                               InstX86Base::SseSuffix::Scalar>(Func, Dest,
                                                               Source) {}
+    InstX86Divss(Cfg *Func, Variable *Dest, Variable *Source0, Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Divss, false,
+                              InstX86Base::SseSuffix::Scalar>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Rol : public InstX86BaseBinopGPRShift<InstX86Base::Rol> {
@@ -2161,6 +2605,11 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Pcmpeq>())
           InstX86Pcmpeq(Func, Dest, Source, ArithmeticTypeOverride);
     }
+    static InstX86Pcmpeq *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                 Operand *Source1) {
+      return new (Func->allocate<InstX86Pcmpeq>())
+          InstX86Pcmpeq(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Pcmpeq(Cfg *Func, Variable *Dest, Operand *Source,
@@ -2168,6 +2617,11 @@ template <typename TraitsType> struct InstImpl {
         : InstX86BaseBinopXmm<InstX86Base::Pcmpeq, true,
                               InstX86Base::SseSuffix::Integral>(
               Func, Dest, Source, ArithmeticTypeOverride) {}
+    InstX86Pcmpeq(Cfg *Func, Variable *Dest, Variable *Source0,
+                  Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Pcmpeq, true,
+                              InstX86Base::SseSuffix::Integral>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Pcmpgt
@@ -2181,12 +2635,25 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Pcmpgt>())
           InstX86Pcmpgt(Func, Dest, Source);
     }
+    static InstX86Pcmpgt *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                 Operand *Source1) {
+      assert(Dest->getType() != IceType_f64 ||
+             InstX86Base::getTarget(Func)->getInstructionSet() >=
+                 Traits::SSE4_1);
+      return new (Func->allocate<InstX86Pcmpgt>())
+          InstX86Pcmpgt(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Pcmpgt(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Pcmpgt, true,
                               InstX86Base::SseSuffix::Integral>(Func, Dest,
                                                                 Source) {}
+    InstX86Pcmpgt(Cfg *Func, Variable *Dest, Variable *Source0,
+                  Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Pcmpgt, true,
+                              InstX86Base::SseSuffix::Integral>(
+              Func, Dest, Source0, Source1) {}
   };
 
   /// movss is only a binary operation when the source and dest operands are
@@ -2204,6 +2671,11 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86MovssRegs>())
           InstX86MovssRegs(Func, Dest, Source);
     }
+    static InstX86MovssRegs *create(Cfg *Func, Variable *Dest,
+                                    Variable *Source0, Operand *Source1) {
+      return new (Func->allocate<InstX86MovssRegs>())
+          InstX86MovssRegs(Func, Dest, Source0, Source1);
+    }
 
     void emitIAS(const Cfg *Func) const override;
 
@@ -2212,6 +2684,11 @@ template <typename TraitsType> struct InstImpl {
         : InstX86BaseBinopXmm<InstX86Base::MovssRegs, false,
                               InstX86Base::SseSuffix::None>(Func, Dest,
                                                             Source) {}
+    InstX86MovssRegs(Cfg *Func, Variable *Dest, Variable *Source0,
+                     Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::MovssRegs, false,
+                              InstX86Base::SseSuffix::None>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Idiv : public InstX86BaseTernop<InstX86Base::Idiv> {
@@ -2964,8 +3441,17 @@ template <typename TraitsType> struct InstImpl {
     InstX86Ret &operator=(const InstX86Ret &) = delete;
 
   public:
-    static InstX86Ret *create(Cfg *Func, Variable *Source = nullptr) {
-      return new (Func->allocate<InstX86Ret>()) InstX86Ret(Func, Source);
+    /// If SiblingCallTarget is given, the return is a sibling call: after the
+    /// epilog, control is transferred with a jmp to SiblingCallTarget, which
+    /// then returns directly to this function's caller.
+    static InstX86Ret *
+    create(Cfg *Func, Variable *Source = nullptr,
+           const ConstantRelocatable *SiblingCallTarget = nullptr) {
+      return new (Func->allocate<InstX86Ret>())
+          InstX86Ret(Func, Source, SiblingCallTarget);
+    }
+    const ConstantRelocatable *getSiblingCallTarget() const {
+      return SiblingCallTarget;
     }
     void emit(const Cfg *Func) const override;
     void emitIAS(const Cfg *Func) const override;
@@ -2975,7 +3461,10 @@ template <typename TraitsType> struct InstImpl {
     }
 
   private:
-    InstX86Ret(Cfg *Func, Variable *Source);
+    InstX86Ret(Cfg *Func, Variable *Source,
+               const ConstantRelocatable *SiblingCallTarget);
+
+    const ConstantRelocatable *SiblingCallTarget;
   };
 
   /// Conditional set-byte instruction.
@@ -3109,12 +3598,22 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Pshufb>())
           InstX86Pshufb(Func, Dest, Source);
     }
+    static InstX86Pshufb *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                 Operand *Source1) {
+      return new (Func->allocate<InstX86Pshufb>())
+          InstX86Pshufb(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Pshufb(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Pshufb, false,
                               InstX86Base::SseSuffix::None>(Func, Dest,
                                                             Source) {}
+    InstX86Pshufb(Cfg *Func, Variable *Dest, Variable *Source0,
+                  Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Pshufb, false,
+                              InstX86Base::SseSuffix::None>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Punpckl
@@ -3125,12 +3624,22 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Punpckl>())
           InstX86Punpckl(Func, Dest, Source);
     }
+    static InstX86Punpckl *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                  Operand *Source1) {
+      return new (Func->allocate<InstX86Punpckl>())
+          InstX86Punpckl(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Punpckl(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Punpckl, false,
                               InstX86Base::SseSuffix::Unpack>(Func, Dest,
                                                               Source) {}
+    InstX86Punpckl(Cfg *Func, Variable *Dest, Variable *Source0,
+                   Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Punpckl, false,
+                              InstX86Base::SseSuffix::Unpack>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Punpckh
@@ -3141,12 +3650,22 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Punpckh>())
           InstX86Punpckh(Func, Dest, Source);
     }
+    static InstX86Punpckh *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                  Operand *Source1) {
+      return new (Func->allocate<InstX86Punpckh>())
+          InstX86Punpckh(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Punpckh(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Punpckh, false,
                               InstX86Base::SseSuffix::Unpack>(Func, Dest,
                                                               Source) {}
+    InstX86Punpckh(Cfg *Func, Variable *Dest, Variable *Source0,
+                   Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Punpckh, false,
+                              InstX86Base::SseSuffix::Unpack>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Packss
@@ -3157,12 +3676,22 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Packss>())
           InstX86Packss(Func, Dest, Source);
     }
+    static InstX86Packss *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                 Operand *Source1) {
+      return new (Func->allocate<InstX86Packss>())
+          InstX86Packss(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Packss(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Packss, false,
                               InstX86Base::SseSuffix::Pack>(Func, Dest,
                                                             Source) {}
+    InstX86Packss(Cfg *Func, Variable *Dest, Variable *Source0,
+                  Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Packss, false,
+                              InstX86Base::SseSuffix::Pack>(
+              Func, Dest, Source0, Source1) {}
   };
 
   class InstX86Packus
@@ -3173,12 +3702,22 @@ template <typename TraitsType> struct InstImpl {
       return new (Func->allocate<InstX86Packus>())
           InstX86Packus(Func, Dest, Source);
     }
+    static InstX86Packus *create(Cfg *Func, Variable *Dest, Variable *Source0,
+                                 Operand *Source1) {
+      return new (Func->allocate<InstX86Packus>())
+          InstX86Packus(Func, Dest, Source0, Source1);
+    }
 
   private:
     InstX86Packus(Cfg *Func, Variable *Dest, Operand *Source)
         : InstX86BaseBinopXmm<InstX86Base::Packus, false,
                               InstX86Base::SseSuffix::Pack>(Func, Dest,
                                                             Source) {}
+    InstX86Packus(Cfg *Func, Variable *Dest, Variable *Source0,
+                  Operand *Source1)
+        : InstX86BaseBinopXmm<InstX86Base::Packus, false,
+                              InstX86Base::SseSuffix::Pack>(
+              Func, Dest, Source0, Source1) {}
   };
 
 }; // struct InstImpl
@@ -3200,6 +3739,9 @@ template <typename TraitsType> struct Insts {
   using Neg = typename InstImpl<TraitsType>::InstX86Neg;
   using Bsf = typename InstImpl<TraitsType>::InstX86Bsf;
   using Bsr = typename InstImpl<TraitsType>::InstX86Bsr;
+  using Popcnt = typename InstImpl<TraitsType>::InstX86Popcnt;
+  using Lzcnt = typename InstImpl<TraitsType>::InstX86Lzcnt;
+  using Tzcnt = typename InstImpl<TraitsType>::InstX86Tzcnt;
   using Lea = typename InstImpl<TraitsType>::InstX86Lea;
   using Cbwdq = typename InstImpl<TraitsType>::InstX86Cbwdq;
   using Movsx = typename InstImpl<TraitsType>::InstX86Movsx;
@@ -3248,6 +3790,9 @@ template <typename TraitsType> struct Insts {
   using Minps = typename InstImpl<TraitsType>::InstX86Minps;
   using Imul = typename InstImpl<TraitsType>::InstX86Imul;
   using ImulImm = typename InstImpl<TraitsType>::InstX86ImulImm;
+  using Shlx = typename InstImpl<TraitsType>::InstX86Shlx;
+  using Shrx = typename InstImpl<TraitsType>::InstX86Shrx;
+  using Sarx = typename InstImpl<TraitsType>::InstX86Sarx;
   using Mulps = typename InstImpl<TraitsType>::InstX86Mulps;
   using Mulss = typename InstImpl<TraitsType>::InstX86Mulss;
   using Pmull = typename InstImpl<TraitsType>::InstX86Pmull;
@@ -3345,6 +3890,15 @@ template <typename TraitsType> struct Insts {
   const char *InstImpl<TraitsType>::InstX86Bsr::Base::Opcode = "bsr";          \
   template <>                                                                  \
   template <>                                                                  \
+  const char *InstImpl<TraitsType>::InstX86Popcnt::Base::Opcode = "popcnt";    \
+  template <>                                                                  \
+  template <>                                                                  \
+  const char *InstImpl<TraitsType>::InstX86Lzcnt::Base::Opcode = "lzcnt";      \
+  template <>                                                                  \
+  template <>                                                                  \
+  const char *InstImpl<TraitsType>::InstX86Tzcnt::Base::Opcode = "tzcnt";      \
+  template <>                                                                  \
+  template <>                                                                  \
   const char *InstImpl<TraitsType>::InstX86Lea::Base::Opcode = "lea";          \
   template <>                                                                  \
   template <>                                                                  \
@@ -3578,6 +4132,15 @@ template <typename TraitsType> struct Insts {
   const char *InstImpl<TraitsType>::InstX86Pextr::Base::Opcode = "pextr";      \
   template <>                                                                  \
   template <>                                                                  \
+  const char *InstImpl<TraitsType>::InstX86Shlx::Base::Opcode = "shlx";        \
+  template <>                                                                  \
+  template <>                                                                  \
+  const char *InstImpl<TraitsType>::InstX86Shrx::Base::Opcode = "shrx";        \
+  template <>                                                                  \
+  template <>                                                                  \
+  const char *InstImpl<TraitsType>::InstX86Sarx::Base::Opcode = "sarx";        \
+  template <>                                                                  \
+  template <>                                                                  \
   const char *InstImpl<TraitsType>::InstX86Pshufd::Base::Opcode = "pshufd";    \
   template <>                                                                  \
   template <>                                                                  \
@@ -3629,6 +4192,24 @@ template <typename TraitsType> struct Insts {
           &InstImpl<TraitsType>::Assembler::bsr, nullptr};                     \
   template <>                                                                  \
   template <>                                                                  \
+  const InstImpl<TraitsType>::Assembler::GPREmitterRegOp                       \
+      InstImpl<TraitsType>::InstX86Popcnt::Base::Emitter = {                   \
+          &InstImpl<TraitsType>::Assembler::popcnt,                            \
+          &InstImpl<TraitsType>::Assembler::popcnt, nullptr};                  \
+  template <>                                                                  \
+  template <>                                                                  \
+  const InstImpl<TraitsType>::Assembler::GPREmitterRegOp                       \
+      InstImpl<TraitsType>::InstX86Lzcnt::Base::Emitter = {                    \
+          &InstImpl<TraitsType>::Assembler::lzcnt,                             \
+          &InstImpl<TraitsType>::Assembler::lzcnt, nullptr};                   \
+  template <>                                                                  \
+  template <>                                                                  \
+  const InstImpl<TraitsType>::Assembler::GPREmitterRegOp                       \
+      InstImpl<TraitsType>::InstX86Tzcnt::Base::Emitter = {                    \
+          &InstImpl<TraitsType>::Assembler::tzcnt,                             \
+          &InstImpl<TraitsType>::Assembler::tzcnt, nullptr};                   \
+  template <>                                                                  \
+  template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::GPREmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Lea::Base::Emitter = {                      \
           /* reg/reg and reg/imm are illegal */ nullptr,                       \
@@ -3781,6 +4362,24 @@ template <typename TraitsType> struct Insts {
       InstImpl<TraitsType>::InstX86Shr::Base::Emitter = {                      \
           &InstImpl<TraitsType>::Assembler::shr,                               \
           &InstImpl<TraitsType>::Assembler::shr};                              \
+  template <>                                                                  \
+  template <>                                                                  \
+  const InstImpl<TraitsType>::Assembler::GPREmitterShiftx                      \
+      InstImpl<TraitsType>::InstX86Shlx::Base::Emitter = {                     \
+          &InstImpl<TraitsType>::Assembler::shlx,                              \
+          &InstImpl<TraitsType>::Assembler::shlx};                             \
+  template <>                                                                  \
+  template <>                                                                  \
+  const InstImpl<TraitsType>::Assembler::GPREmitterShiftx                      \
+      InstImpl<TraitsType>::InstX86Shrx::Base::Emitter = {                     \
+          &InstImpl<TraitsType>::Assembler::shrx,                              \
+          &InstImpl<TraitsType>::Assembler::shrx};                             \
+  template <>                                                                  \
+  template <>                                                                  \
+  const InstImpl<TraitsType>::Assembler::GPREmitterShiftx                      \
+      InstImpl<TraitsType>::InstX86Sarx::Base::Emitter = {                     \
+          &InstImpl<TraitsType>::Assembler::sarx,                              \
+          &InstImpl<TraitsType>::Assembler::sarx};                             \
                                                                                \
   /* Binary XMM ops */                                                         \
   template <>                                                                  \
@@ -3793,85 +4392,113 @@ template <typename TraitsType> struct Insts {
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Addss::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::addss,                             \
-          &InstImpl<TraitsType>::Assembler::addss};                            \
+          &InstImpl<TraitsType>::Assembler::addss,                             \
+          &InstImpl<TraitsType>::Assembler::vaddss,                            \
+          &InstImpl<TraitsType>::Assembler::vaddss};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Addps::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::addps,                             \
-          &InstImpl<TraitsType>::Assembler::addps};                            \
+          &InstImpl<TraitsType>::Assembler::addps,                             \
+          &InstImpl<TraitsType>::Assembler::vaddps,                            \
+          &InstImpl<TraitsType>::Assembler::vaddps};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Divss::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::divss,                             \
-          &InstImpl<TraitsType>::Assembler::divss};                            \
+          &InstImpl<TraitsType>::Assembler::divss,                             \
+          &InstImpl<TraitsType>::Assembler::vdivss,                            \
+          &InstImpl<TraitsType>::Assembler::vdivss};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Divps::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::divps,                             \
-          &InstImpl<TraitsType>::Assembler::divps};                            \
+          &InstImpl<TraitsType>::Assembler::divps,                             \
+          &InstImpl<TraitsType>::Assembler::vdivps,                            \
+          &InstImpl<TraitsType>::Assembler::vdivps};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Mulss::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::mulss,                             \
-          &InstImpl<TraitsType>::Assembler::mulss};                            \
+          &InstImpl<TraitsType>::Assembler::mulss,                             \
+          &InstImpl<TraitsType>::Assembler::vmulss,                            \
+          &InstImpl<TraitsType>::Assembler::vmulss};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Mulps::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::mulps,                             \
-          &InstImpl<TraitsType>::Assembler::mulps};                            \
+          &InstImpl<TraitsType>::Assembler::mulps,                             \
+          &InstImpl<TraitsType>::Assembler::vmulps,                            \
+          &InstImpl<TraitsType>::Assembler::vmulps};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Padd::Base::Emitter = {                     \
           &InstImpl<TraitsType>::Assembler::padd,                              \
-          &InstImpl<TraitsType>::Assembler::padd};                             \
+          &InstImpl<TraitsType>::Assembler::padd,                              \
+          &InstImpl<TraitsType>::Assembler::vpadd,                             \
+          &InstImpl<TraitsType>::Assembler::vpadd};                            \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Padds::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::padds,                             \
-          &InstImpl<TraitsType>::Assembler::padds};                            \
+          &InstImpl<TraitsType>::Assembler::padds,                             \
+          &InstImpl<TraitsType>::Assembler::vpadds,                            \
+          &InstImpl<TraitsType>::Assembler::vpadds};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Paddus::Base::Emitter = {                   \
           &InstImpl<TraitsType>::Assembler::paddus,                            \
-          &InstImpl<TraitsType>::Assembler::paddus};                           \
+          &InstImpl<TraitsType>::Assembler::paddus,                            \
+          &InstImpl<TraitsType>::Assembler::vpaddus,                           \
+          &InstImpl<TraitsType>::Assembler::vpaddus};                          \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Pand::Base::Emitter = {                     \
           &InstImpl<TraitsType>::Assembler::pand,                              \
-          &InstImpl<TraitsType>::Assembler::pand};                             \
+          &InstImpl<TraitsType>::Assembler::pand,                              \
+          &InstImpl<TraitsType>::Assembler::vpand,                             \
+          &InstImpl<TraitsType>::Assembler::vpand};                            \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Pandn::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::pandn,                             \
-          &InstImpl<TraitsType>::Assembler::pandn};                            \
+          &InstImpl<TraitsType>::Assembler::pandn,                             \
+          &InstImpl<TraitsType>::Assembler::vpandn,                            \
+          &InstImpl<TraitsType>::Assembler::vpandn};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Pcmpeq::Base::Emitter = {                   \
           &InstImpl<TraitsType>::Assembler::pcmpeq,                            \
-          &InstImpl<TraitsType>::Assembler::pcmpeq};                           \
+          &InstImpl<TraitsType>::Assembler::pcmpeq,                            \
+          &InstImpl<TraitsType>::Assembler::vpcmpeq,                           \
+          &InstImpl<TraitsType>::Assembler::vpcmpeq};                          \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Pcmpgt::Base::Emitter = {                   \
           &InstImpl<TraitsType>::Assembler::pcmpgt,                            \
-          &InstImpl<TraitsType>::Assembler::pcmpgt};                           \
+          &InstImpl<TraitsType>::Assembler::pcmpgt,                            \
+          &InstImpl<TraitsType>::Assembler::vpcmpgt,                           \
+          &InstImpl<TraitsType>::Assembler::vpcmpgt};                          \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Pmull::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::pmull,                             \
-          &InstImpl<TraitsType>::Assembler::pmull};                            \
+          &InstImpl<TraitsType>::Assembler::pmull,                             \
+          &InstImpl<TraitsType>::Assembler::vpmull,                            \
+          &InstImpl<TraitsType>::Assembler::vpmull};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
@@ -3895,97 +4522,129 @@ template <typename TraitsType> struct Insts {
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Pmuludq::Base::Emitter = {                  \
           &InstImpl<TraitsType>::Assembler::pmuludq,                           \
-          &InstImpl<TraitsType>::Assembler::pmuludq};                          \
+          &InstImpl<TraitsType>::Assembler::pmuludq,                           \
+          &InstImpl<TraitsType>::Assembler::vpmuludq,                          \
+          &InstImpl<TraitsType>::Assembler::vpmuludq};                         \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Por::Base::Emitter = {                      \
           &InstImpl<TraitsType>::Assembler::por,                               \
-          &InstImpl<TraitsType>::Assembler::por};                              \
+          &InstImpl<TraitsType>::Assembler::por,                               \
+          &InstImpl<TraitsType>::Assembler::vpor,                              \
+          &InstImpl<TraitsType>::Assembler::vpor};                             \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Psub::Base::Emitter = {                     \
           &InstImpl<TraitsType>::Assembler::psub,                              \
-          &InstImpl<TraitsType>::Assembler::psub};                             \
+          &InstImpl<TraitsType>::Assembler::psub,                              \
+          &InstImpl<TraitsType>::Assembler::vpsub,                             \
+          &InstImpl<TraitsType>::Assembler::vpsub};                            \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Psubs::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::psubs,                             \
-          &InstImpl<TraitsType>::Assembler::psubs};                            \
+          &InstImpl<TraitsType>::Assembler::psubs,                             \
+          &InstImpl<TraitsType>::Assembler::vpsubs,                            \
+          &InstImpl<TraitsType>::Assembler::vpsubs};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Psubus::Base::Emitter = {                   \
           &InstImpl<TraitsType>::Assembler::psubus,                            \
-          &InstImpl<TraitsType>::Assembler::psubus};                           \
+          &InstImpl<TraitsType>::Assembler::psubus,                            \
+          &InstImpl<TraitsType>::Assembler::vpsubus,                           \
+          &InstImpl<TraitsType>::Assembler::vpsubus};                          \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Pxor::Base::Emitter = {                     \
           &InstImpl<TraitsType>::Assembler::pxor,                              \
-          &InstImpl<TraitsType>::Assembler::pxor};                             \
+          &InstImpl<TraitsType>::Assembler::pxor,                              \
+          &InstImpl<TraitsType>::Assembler::vpxor,                             \
+          &InstImpl<TraitsType>::Assembler::vpxor};                            \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Subss::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::subss,                             \
-          &InstImpl<TraitsType>::Assembler::subss};                            \
+          &InstImpl<TraitsType>::Assembler::subss,                             \
+          &InstImpl<TraitsType>::Assembler::vsubss,                            \
+          &InstImpl<TraitsType>::Assembler::vsubss};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Subps::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::subps,                             \
-          &InstImpl<TraitsType>::Assembler::subps};                            \
+          &InstImpl<TraitsType>::Assembler::subps,                             \
+          &InstImpl<TraitsType>::Assembler::vsubps,                            \
+          &InstImpl<TraitsType>::Assembler::vsubps};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Andnps::Base::Emitter = {                   \
           &InstImpl<TraitsType>::Assembler::andnps,                            \
-          &InstImpl<TraitsType>::Assembler::andnps};                           \
+          &InstImpl<TraitsType>::Assembler::andnps,                            \
+          &InstImpl<TraitsType>::Assembler::vandnps,                           \
+          &InstImpl<TraitsType>::Assembler::vandnps};                          \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Andps::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::andps,                             \
-          &InstImpl<TraitsType>::Assembler::andps};                            \
+          &InstImpl<TraitsType>::Assembler::andps,                             \
+          &InstImpl<TraitsType>::Assembler::vandps,                            \
+          &InstImpl<TraitsType>::Assembler::vandps};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Maxss::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::maxss,                             \
-          &InstImpl<TraitsType>::Assembler::maxss};                            \
+          &InstImpl<TraitsType>::Assembler::maxss,                             \
+          &InstImpl<TraitsType>::Assembler::vmaxss,                            \
+          &InstImpl<TraitsType>::Assembler::vmaxss};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Minss::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::minss,                             \
-          &InstImpl<TraitsType>::Assembler::minss};                            \
+          &InstImpl<TraitsType>::Assembler::minss,                             \
+          &InstImpl<TraitsType>::Assembler::vminss,                            \
+          &InstImpl<TraitsType>::Assembler::vminss};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Maxps::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::maxps,                             \
-          &InstImpl<TraitsType>::Assembler::maxps};                            \
+          &InstImpl<TraitsType>::Assembler::maxps,                             \
+          &InstImpl<TraitsType>::Assembler::vmaxps,                            \
+          &InstImpl<TraitsType>::Assembler::vmaxps};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Minps::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::minps,                             \
-          &InstImpl<TraitsType>::Assembler::minps};                            \
+          &InstImpl<TraitsType>::Assembler::minps,                             \
+          &InstImpl<TraitsType>::Assembler::vminps,                            \
+          &InstImpl<TraitsType>::Assembler::vminps};                           \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Orps::Base::Emitter = {                     \
           &InstImpl<TraitsType>::Assembler::orps,                              \
-          &InstImpl<TraitsType>::Assembler::orps};                             \
+          &InstImpl<TraitsType>::Assembler::orps,                              \
+          &InstImpl<TraitsType>::Assembler::vorps,                             \
+          &InstImpl<TraitsType>::Assembler::vorps};                            \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Xorps::Base::Emitter = {                    \
           &InstImpl<TraitsType>::Assembler::xorps,                             \
-          &InstImpl<TraitsType>::Assembler::xorps};                            \
+          &InstImpl<TraitsType>::Assembler::xorps,                             \
+          &InstImpl<TraitsType>::Assembler::vxorps,                            \
+          &InstImpl<TraitsType>::Assembler::vxorps};                           \
                                                                                \
   /* Binary XMM Shift ops */                                                   \
   template <>                                                                  \
@@ -4014,31 +4673,41 @@ template <typename TraitsType> struct Insts {
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Pshufb::Base::Emitter = {                   \
           &InstImpl<TraitsType>::Assembler::pshufb,                            \
-          &InstImpl<TraitsType>::Assembler::pshufb};                           \
+          &InstImpl<TraitsType>::Assembler::pshufb,                            \
+          &InstImpl<TraitsType>::Assembler::vpshufb,                           \
+          &InstImpl<TraitsType>::Assembler::vpshufb};                          \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Punpckl::Base::Emitter = {                  \
           &InstImpl<TraitsType>::Assembler::punpckl,                           \
-          &InstImpl<TraitsType>::Assembler::punpckl};                          \
+          &InstImpl<TraitsType>::Assembler::punpckl,                           \
+          &InstImpl<TraitsType>::Assembler::vpunpckl,                          \
+          &InstImpl<TraitsType>::Assembler::vpunpckl};                         \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Punpckh::Base::Emitter = {                  \
           &InstImpl<TraitsType>::Assembler::punpckh,                           \
-          &InstImpl<TraitsType>::Assembler::punpckh};                          \
+          &InstImpl<TraitsType>::Assembler::punpckh,                           \
+          &InstImpl<TraitsType>::Assembler::vpunpckh,                          \
+          &InstImpl<TraitsType>::Assembler::vpunpckh};                         \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Packss::Base::Emitter = {                   \
           &InstImpl<TraitsType>::Assembler::packss,                            \
-          &InstImpl<TraitsType>::Assembler::packss};                           \
+          &InstImpl<TraitsType>::Assembler::packss,                            \
+          &InstImpl<TraitsType>::Assembler::vpackss,                           \
+          &InstImpl<TraitsType>::Assembler::vpackss};                          \
   template <>                                                                  \
   template <>                                                                  \
   const InstImpl<TraitsType>::Assembler::XmmEmitterRegOp                       \
       InstImpl<TraitsType>::InstX86Packus::Base::Emitter = {                   \
           &InstImpl<TraitsType>::Assembler::packus,                            \
-          &InstImpl<TraitsType>::Assembler::packus};                           \
+          &InstImpl<TraitsType>::Assembler::packus,                            \
+          &InstImpl<TraitsType>::Assembler::vpackus,                           \
+          &InstImpl<TraitsType>::Assembler::vpackus};                          \
   }                                                                            \
   }
 
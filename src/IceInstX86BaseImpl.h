@@ -355,8 +355,10 @@ InstImpl<TraitsType>::InstX86Push::InstX86Push(Cfg *Func, InstX86Label *L)
     : InstX86Base(Func, InstX86Base::Push, 0, nullptr), Label(L) {}
 
 template <typename TraitsType>
-InstImpl<TraitsType>::InstX86Ret::InstX86Ret(Cfg *Func, Variable *Source)
-    : InstX86Base(Func, InstX86Base::Ret, Source ? 1 : 0, nullptr) {
+InstImpl<TraitsType>::InstX86Ret::InstX86Ret(
+    Cfg *Func, Variable *Source, const ConstantRelocatable *SiblingCallTarget)
+    : InstX86Base(Func, InstX86Base::Ret, Source ? 1 : 0, nullptr),
+      SiblingCallTarget(SiblingCallTarget) {
   if (Source)
     this->addSource(Source);
 }
@@ -508,24 +510,32 @@ void InstImpl<TraitsType>::InstX86Br::emit(const Cfg *Func) const {
 template <typename TraitsType>
 void InstImpl<TraitsType>::InstX86Br::emitIAS(const Cfg *Func) const {
   Assembler *Asm = Func->getAssembler<Assembler>();
+  // Far branches are left to branch relaxation, which picks the short form
+  // whenever the target is in range.
   if (Label) {
     auto *L = Asm->getOrCreateLocalLabel(Label->getLabelNumber());
-    if (Condition == Cond::Br_None) {
-      Asm->jmp(L, isNear());
+    if (isNear()) {
+      if (Condition == Cond::Br_None) {
+        Asm->jmp(L, Assembler::kNearJump);
+      } else {
+        Asm->j(Condition, L, Assembler::kNearJump);
+      }
+    } else if (Condition == Cond::Br_None) {
+      Asm->jmp(L, this, 0);
     } else {
-      Asm->j(Condition, L, isNear());
+      Asm->j(Condition, L, this, 0);
     }
   } else {
     if (Condition == Cond::Br_None) {
       auto *L = Asm->getOrCreateCfgNodeLabel(getTargetFalse()->getIndex());
       assert(!getTargetTrue());
-      Asm->jmp(L, isNear());
+      Asm->jmp(L, this, 0);
     } else {
       auto *L = Asm->getOrCreateCfgNodeLabel(getTargetTrue()->getIndex());
-      Asm->j(Condition, L, isNear());
+      Asm->j(Condition, L, this, 0);
       if (getTargetFalse()) {
         auto *L2 = Asm->getOrCreateCfgNodeLabel(getTargetFalse()->getIndex());
-        Asm->jmp(L2, isNear());
+        Asm->jmp(L2, this, 1);
       }
     }
   }
@@ -847,6 +857,39 @@ void InstImpl<TraitsType>::emitIASGPRShift(const Cfg *Func, Type Ty,
   }
 }
 
+template <typename TraitsType>
+void InstImpl<TraitsType>::emitIASGPRShiftx(const Cfg *Func,
+                                            const Variable *Dest,
+                                            const Operand *Src,
+                                            const Operand *Shifter,
+                                            const GPREmitterShiftx &Emitter) {
+  auto *Target = InstX86Base::getTarget(Func);
+  Assembler *Asm = Func->getAssembler<Assembler>();
+  assert(Target->getInstructionSet() >= Traits::BMI2);
+  // Dest and the shift count must be registers, while Src may be memory.
+  assert(Dest->hasReg());
+  const Type Ty = Dest->getType();
+  GPRRegister DestReg = Traits::getEncodedGPR(Dest->getRegNum());
+  const auto *ShifterVar = llvm::cast<Variable>(Shifter);
+  assert(ShifterVar->hasReg());
+  GPRRegister ShifterReg = Traits::getEncodedGPR(ShifterVar->getRegNum());
+  if (const auto *SrcVar = llvm::dyn_cast<Variable>(Src)) {
+    if (SrcVar->hasReg()) {
+      GPRRegister SrcReg = Traits::getEncodedGPR(SrcVar->getRegNum());
+      (Asm->*(Emitter.GPRGPRGPR))(Ty, DestReg, SrcReg, ShifterReg);
+    } else {
+      Address SrcStackAddr = Target->stackVarToAsmOperand(SrcVar);
+      (Asm->*(Emitter.GPRAddrGPR))(Ty, DestReg, SrcStackAddr, ShifterReg);
+    }
+  } else if (const auto *Mem = llvm::dyn_cast<X86OperandMem>(Src)) {
+    Mem->emitSegmentOverride(Asm);
+    (Asm->*(Emitter.GPRAddrGPR))(Ty, DestReg, Mem->toAsmAddress(Asm, Target),
+                                 ShifterReg);
+  } else {
+    llvm_unreachable("Unexpected operand type");
+  }
+}
+
 template <typename TraitsType>
 void InstImpl<TraitsType>::emitIASGPRShiftDouble(
     const Cfg *Func, const Variable *Dest, const Operand *Src1Op,
@@ -925,6 +968,37 @@ void InstImpl<TraitsType>::emitIASRegOpTyXMM(const Cfg *Func, Type Ty,
   }
 }
 
+template <typename TraitsType>
+void InstImpl<TraitsType>::emitIASVexRegOpTyXMM(
+    const Cfg *Func, Type Ty, const Variable *Var, const Variable *Src0,
+    const Operand *Src1, const XmmEmitterRegOp &Emitter) {
+  auto *Target = InstX86Base::getTarget(Func);
+  Assembler *Asm = Func->getAssembler<Assembler>();
+  assert(Emitter.VexXmmXmmXmm != nullptr && Emitter.VexXmmXmmAddr != nullptr);
+  assert(Var->hasReg());
+  assert(Src0->hasReg());
+  XmmRegister VarReg = Traits::getEncodedXmm(Var->getRegNum());
+  XmmRegister Src0Reg = Traits::getEncodedXmm(Src0->getRegNum());
+  if (const auto *SrcVar = llvm::dyn_cast<Variable>(Src1)) {
+    if (SrcVar->hasReg()) {
+      XmmRegister SrcReg = Traits::getEncodedXmm(SrcVar->getRegNum());
+      (Asm->*(Emitter.VexXmmXmmXmm))(Ty, VarReg, Src0Reg, SrcReg);
+    } else {
+      Address SrcStackAddr = Target->stackVarToAsmOperand(SrcVar);
+      (Asm->*(Emitter.VexXmmXmmAddr))(Ty, VarReg, Src0Reg, SrcStackAddr);
+    }
+  } else if (const auto *Mem = llvm::dyn_cast<X86OperandMem>(Src1)) {
+    assert(Mem->getSegmentRegister() == X86OperandMem::DefaultSegment);
+    (Asm->*(Emitter.VexXmmXmmAddr))(Ty, VarReg, Src0Reg,
+                                    Mem->toAsmAddress(Asm, Target));
+  } else if (const auto *Imm = llvm::dyn_cast<Constant>(Src1)) {
+    (Asm->*(Emitter.VexXmmXmmAddr))(Ty, VarReg, Src0Reg,
+                                    Traits::Address::ofConstPool(Asm, Imm));
+  } else {
+    llvm_unreachable("Unexpected operand type");
+  }
+}
+
 template <typename TraitsType>
 template <typename DReg_t, typename SReg_t, DReg_t (*destEnc)(RegNumT),
           SReg_t (*srcEnc)(RegNumT)>
@@ -2459,10 +2533,18 @@ void InstImpl<TraitsType>::InstX86MovssRegs::emitIAS(const Cfg *Func) const {
   // part of the Dest register is untouched.
   assert(this->getSrcSize() == 2);
   const Variable *Dest = this->getDest();
-  assert(Dest == this->getSrc(0));
   const auto *SrcVar = llvm::cast<Variable>(this->getSrc(1));
   assert(Dest->hasReg() && SrcVar->hasReg());
   Assembler *Asm = Func->getAssembler<Assembler>();
+  if (this->isVexForm()) {
+    // The upper lanes come from Src0 rather than from Dest.
+    const auto *Src0Var = llvm::cast<Variable>(this->getSrc(0));
+    assert(Src0Var->hasReg());
+    Asm->vmovss(IceType_f32, Traits::getEncodedXmm(Dest->getRegNum()),
+                Traits::getEncodedXmm(Src0Var->getRegNum()),
+                Traits::getEncodedXmm(SrcVar->getRegNum()));
+    return;
+  }
   Asm->movss(IceType_f32, Traits::getEncodedXmm(Dest->getRegNum()),
              Traits::getEncodedXmm(SrcVar->getRegNum()));
 }
@@ -2916,6 +2998,13 @@ void InstImpl<TraitsType>::InstX86Ret::emit(const Cfg *Func) const {
   if (!BuildDefs::dump())
     return;
   Ostream &Str = Func->getContext()->getStrEmit();
+  if (SiblingCallTarget != nullptr) {
+    Str << "\t"
+           "jmp"
+           "\t";
+    SiblingCallTarget->emitWithoutPrefix(InstX86Base::getTarget(Func));
+    return;
+  }
   Str << "\t"
          "ret";
 }
@@ -2923,6 +3012,10 @@ void InstImpl<TraitsType>::InstX86Ret::emit(const Cfg *Func) const {
 template <typename TraitsType>
 void InstImpl<TraitsType>::InstX86Ret::emitIAS(const Cfg *Func) const {
   Assembler *Asm = Func->getAssembler<Assembler>();
+  if (SiblingCallTarget != nullptr) {
+    Asm->jmp(SiblingCallTarget);
+    return;
+  }
   Asm->ret();
 }
 
@@ -2933,6 +3026,11 @@ void InstImpl<TraitsType>::InstX86Ret::dump(const Cfg *Func) const {
   Ostream &Str = Func->getContext()->getStrDump();
   Type Ty =
       (this->getSrcSize() == 0 ? IceType_void : this->getSrc(0)->getType());
+  if (SiblingCallTarget != nullptr) {
+    Str << "jmp.sibling ";
+    SiblingCallTarget->dump(Func);
+    return;
+  }
   Str << "ret." << Ty << " ";
   this->dumpSources(Func);
 }
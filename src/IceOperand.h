@@ -345,6 +345,10 @@ public:
     HasOffset = true;
   }
 
+  /// Forgets the offset, so that the label can be bound again when its function
+  /// is re-emitted.
+  void resetOffset() { HasOffset = false; }
+
 private:
   RelocOffset() = default;
   explicit RelocOffset(RelocOffsetT Offset) { setOffset(Offset); }
@@ -0,0 +1,285 @@
+//===- subzero/src/IcePassPipeline.cpp - Optimization pipelines -----------===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implements the PassPipeline class and the passes that all targets
+/// share.
+///
+//===----------------------------------------------------------------------===//
+
+#include "IcePassPipeline.h"
+
+#include "IceCfg.h"
+#include "IceClFlags.h"
+#include "IceGlobalContext.h"
+#include "IceIfConversion.h"
+#include "IceOperand.h"
+#include "IceRangeSpec.h"
+#include "IceSCCP.h"
+#include "IceTargetLowering.h"
+
+#include <unordered_map>
+
+namespace Ice {
+
+PassPipeline::Pass &PassPipeline::add(const char *Name,
+                                      PassAnalysisMask Requires,
+                                      PassAnalysisMask Invalidates,
+                                      std::function<void()> Run) {
+  Passes.emplace_back(
+      makeUnique<Pass>(Name, Requires, Invalidates, std::move(Run)));
+  return *Passes.back();
+}
+
+PassPipeline::Pass &PassPipeline::addSCCP() {
+  // Constant propagation works on the SSA form, so it has to run before phi
+  // lowering, and it runs before the target helper calls are generated so
+  // that folded operations don't become calls.
+  Cfg *Func = this->Func;
+  return add("sccp", PA_None, PA_All, [Func]() { propagateConstants(Func); })
+      .dump("After constant propagation")
+      .enabledIf(getFlags().getEnableSCCP());
+}
+
+PassPipeline::Pass &PassPipeline::addIfConversion() {
+  // The phis at the join points become selects, so this works on the SSA form,
+  // after constant propagation has removed the branches it could fold.
+  Cfg *Func = this->Func;
+  return add("ifConvert", PA_None, PA_All, [Func]() { convertIfs(Func); })
+      .dump("After if-conversion")
+      .enabledIf(getFlags().getEnableIfConversion());
+}
+
+PassPipeline::Pass &PassPipeline::addRedundantLoadElim() {
+  // The forwarded values are only known to be unchanged while the Cfg is in
+  // SSA form, so this runs before phi lowering.
+  Cfg *Func = this->Func;
+  return add("rle", PA_VMetadataSingleDefs, PA_All,
+             [Func]() { Func->eliminateRedundantLoads(); })
+      .dump("After redundant load elimination")
+      .enabledIf(getFlags().getEnableRLE());
+}
+
+PassPipeline::Pass &PassPipeline::addPhiLowering() {
+  Cfg *Func = this->Func;
+  return add("phiLowering", PA_None, PA_All,
+             [Func]() {
+               Func->placePhiLoads();
+               if (Func->hasError())
+                 return;
+               Func->placePhiStores();
+               if (Func->hasError())
+                 return;
+               Func->deletePhis();
+             })
+      .dump("After Phi lowering")
+      .enabledIf(!getFlags().getEnablePhiEdgeSplit())
+      .required();
+}
+
+PassPipeline::Pass &PassPipeline::addAddressOpt() {
+  Cfg *Func = this->Func;
+  return add("addressOpt", PA_VMetadataSingleDefs, PA_All,
+             [Func]() { Func->doAddressOpt(); });
+}
+
+PassPipeline::Pass &PassPipeline::addArgLowering() {
+  Cfg *Func = this->Func;
+  return add("argLowering", PA_None, PA_All,
+             [Func]() { Func->doArgLowering(); })
+      .required();
+}
+
+PassPipeline::Pass &PassPipeline::addGenCode() {
+  // Target lowering. This requires liveness analysis for some parts of the
+  // lowering decisions, such as compare/branch fusing.
+  // TODO: It should be sufficient to use the fastest liveness calculation,
+  // i.e. livenessLightweight(). However, for some reason that slows down the
+  // rest of the translation. Investigate.
+  Cfg *Func = this->Func;
+  return add("genCode", PA_LivenessBasic, PA_AllButNumbering,
+             [Func]() { Func->genCode(); })
+      .required();
+}
+
+PassPipeline::Pass &PassPipeline::addRegAlloc() {
+  // Register allocation. This requires instruction renumbering and full
+  // liveness analysis.
+  Cfg *Func = this->Func;
+  return add("regAlloc", PA_LivenessIntervals | PA_VMetadataAll, PA_All,
+             [Func]() { Func->getTarget()->regAlloc(RAK_Global); })
+      .dump("After linear scan regalloc")
+      .required();
+}
+
+PassPipeline::Pass &PassPipeline::addAdvancedPhiLowering() {
+  Cfg *Func = this->Func;
+  return add("advancedPhiLowering", PA_None, PA_All,
+             [Func]() { Func->advancedPhiLowering(); })
+      .dump("After advanced Phi lowering")
+      .enabledIf(getFlags().getEnablePhiEdgeSplit())
+      .required();
+}
+
+PassPipeline::Pass &PassPipeline::addGenFrame() {
+  // Stack frame mapping.
+  Cfg *Func = this->Func;
+  return add("genFrame", PA_None, PA_All, [Func]() { Func->genFrame(); })
+      .dump("After stack frame mapping")
+      .required();
+}
+
+PassPipeline::Pass &PassPipeline::addNodeLayout() {
+  Cfg *Func = this->Func;
+  return add("nodeLayout", PA_None, PA_All, [Func]() {
+    Func->contractEmptyNodes();
+    Func->reorderNodes();
+  });
+}
+
+PassPipeline::Pass &PassPipeline::addBranchOpt() {
+  // Branch optimization. This needs to be done just before code emission. In
+  // particular, no transformations that insert or reorder CfgNodes should be
+  // done after branch optimization. We go ahead and do it before nop insertion
+  // to reduce the amount of work needed for searching for opportunities.
+  Cfg *Func = this->Func;
+  return add("branchOpt", PA_None, PA_All, [Func]() { Func->doBranchOpt(); })
+      .dump("After branch optimization");
+}
+
+PassPipeline::Pass &PassPipeline::addNopInsertion() {
+  Cfg *Func = this->Func;
+  return add("nopInsertion", PA_None, PA_All,
+             [Func]() { Func->doNopInsertion(); })
+      .enabledIf(getFlags().getShouldDoNopInsertion());
+}
+
+std::vector<const PassPipeline::Pass *> PassPipeline::getOrder() const {
+  std::vector<const Pass *> Result;
+  if (Order.empty()) {
+    for (const auto &P : Passes) {
+      if (P->IsEnabled)
+        Result.emplace_back(P.get());
+    }
+    return Result;
+  }
+
+  std::unordered_map<std::string, const Pass *> ByName;
+  std::string Names;
+  for (const auto &P : Passes) {
+    ByName[P->Name] = P.get();
+    Names += (Names.empty() ? "" : ",") + std::string(P->Name);
+  }
+  std::unordered_map<const Pass *, bool> Listed;
+  for (const std::string &Name :
+       RangeSpec::tokenize(Order, RangeSpec::DELIM_LIST)) {
+    if (Name.empty())
+      continue;
+    auto Iter = ByName.find(Name);
+    if (Iter == ByName.end()) {
+      llvm::report_fatal_error("Unknown pass '" + Name +
+                               "' in pass order; this target's passes are: " +
+                               Names);
+    }
+    Result.emplace_back(Iter->second);
+    Listed[Iter->second] = true;
+  }
+  for (const auto &P : Passes) {
+    if (P->IsRequired && P->IsEnabled && !Listed[P.get()]) {
+      llvm::report_fatal_error("Pass '" + std::string(P->Name) +
+                               "' is required but missing from pass order");
+    }
+  }
+  return Result;
+}
+
+void PassPipeline::establish(PassAnalysisMask Requires) {
+  // Liveness needs the instructions to be numbered. Interval liveness subsumes
+  // basic liveness, and complete VariablesMetadata subsumes the single
+  // definition kind.
+  if (Requires & (PA_LivenessBasic | PA_LivenessIntervals))
+    Requires |= PA_Numbering;
+  if (Valid & PA_LivenessIntervals)
+    Valid |= PA_LivenessBasic;
+  if (Valid & PA_VMetadataAll)
+    Valid |= PA_VMetadataSingleDefs;
+  if (!Func->hasOrderedInstNumbers())
+    Valid &= ~PA_Numbering;
+  const PassAnalysisMask Missing = Requires & ~Valid;
+  if (Missing == PA_None)
+    return;
+
+  if (Missing & PA_Numbering) {
+    Func->renumberInstructions();
+    if (Func->hasError())
+      return;
+    // Live ranges refer to instruction numbers.
+    Valid &= ~PA_LivenessIntervals;
+    Valid |= PA_Numbering;
+  }
+  if (Requires & ~Valid & (PA_LivenessBasic | PA_LivenessIntervals)) {
+    const bool Intervals = (Requires & PA_LivenessIntervals) != 0;
+    Func->liveness(Intervals ? Liveness_Intervals : Liveness_Basic);
+    if (Func->hasError())
+      return;
+    // Liveness analysis resets the VariablesMetadata to VMK_Uses.
+    Valid &= ~(PA_VMetadataSingleDefs | PA_VMetadataAll);
+    Valid |= PA_LivenessBasic;
+    if (Intervals) {
+      Valid |= PA_LivenessIntervals;
+      // The dump is done here, after liveness analysis and associated cleanup,
+      // to make it cleaner and more useful.
+      Func->dump("After liveness analysis");
+      // Validate the live range computations. The expensive validation call is
+      // deliberately only made when assertions are enabled.
+      assert(Func->validateLiveness());
+    }
+  }
+  if (Requires & ~Valid & (PA_VMetadataSingleDefs | PA_VMetadataAll)) {
+    const bool All = (Requires & PA_VMetadataAll) != 0;
+    Func->getVMetadata()->init(All ? VMK_All : VMK_SingleDefs);
+    Valid |= PA_VMetadataSingleDefs;
+    if (All)
+      Valid |= PA_VMetadataAll;
+  }
+}
+
+void PassPipeline::runPass(const Pass &P) {
+  TimerIdT ID = 0;
+  if (BuildDefs::timers() &&
+      (Func->getFocusedTiming() || getFlags().getSubzeroTimingEnabled() ||
+       getFlags().isTimingTraceEnabled())) {
+    ID = Func->getContext()->getTimerID(GlobalContext::TSK_Default,
+                                        std::string("pass.") + P.Name);
+  }
+  TimerMarker T(ID, Func);
+  establish(P.Requires);
+  if (Func->hasError())
+    return;
+  FunctionReport *Report = Func->getReport();
+  const double StartTime = Report ? TimerStack::timestamp() : 0;
+  P.Run();
+  if (Report != nullptr)
+    Report->addPassTime(P.Name, TimerStack::timestamp() - StartTime);
+  Valid &= ~P.Invalidates;
+  if (Func->hasError())
+    return;
+  if (P.DumpMessage != nullptr)
+    Func->dump(P.DumpMessage);
+}
+
+void PassPipeline::run() {
+  for (const Pass *P : getOrder()) {
+    runPass(*P);
+    if (Func->hasError())
+      return;
+  }
+}
+
+} // end of namespace Ice
@@ -0,0 +1,141 @@
+//===- subzero/src/IcePassPipeline.h - Optimization pipelines ---*- C++ -*-===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Declares the PassPipeline class, which runs a target's sequence of
+/// translation passes and keeps the analyses they depend on up to date.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SUBZERO_SRC_ICEPASSPIPELINE_H
+#define SUBZERO_SRC_ICEPASSPIPELINE_H
+
+#include "IceDefs.h"
+
+#include <functional>
+
+namespace Ice {
+
+/// The analyses a pass can depend on, and that passes can invalidate.
+enum PassAnalysis : uint32_t {
+  PA_None = 0,
+  /// Instructions are numbered in layout order (renumberInstructions()). A pass
+  /// that only inserts instructions through the LoweringContext can leave this
+  /// out of its invalidation mask, because the new instructions are numbered
+  /// into the gaps between the old ones; the pipeline still renumbers if
+  /// Cfg::hasOrderedInstNumbers() says that didn't work out.
+  PA_Numbering = 1 << 0,
+  /// Liveness_Basic information, i.e. live-in/live-out sets and last uses.
+  PA_LivenessBasic = 1 << 1,
+  /// Liveness_Intervals information, which includes PA_LivenessBasic.
+  PA_LivenessIntervals = 1 << 2,
+  /// VariablesMetadata computed with VMK_SingleDefs.
+  PA_VMetadataSingleDefs = 1 << 3,
+  /// VariablesMetadata computed with VMK_All, which includes
+  /// PA_VMetadataSingleDefs.
+  PA_VMetadataAll = 1 << 4,
+  PA_All = ~PA_None,
+  PA_AllButNumbering = PA_All & ~PA_Numbering
+};
+using PassAnalysisMask = uint32_t;
+
+/// PassPipeline is an ordered list of named translation passes. Each pass
+/// declares the analyses it requires and the ones it invalidates; before a pass
+/// runs, the pipeline (re)computes only the required analyses that are not
+/// already valid, so renumbering and liveness are never recomputed needlessly.
+/// Each pass is timed under "pass.<name>".
+///
+/// The default order is the order in which the passes were added. For tuning
+/// experiments, a comma-separated Order (e.g. from -o2-pass-order) replaces it
+/// with the listed passes, which are run in the given order whether or not they
+/// are enabled by default.
+class PassPipeline {
+  PassPipeline() = delete;
+  PassPipeline(const PassPipeline &) = delete;
+  PassPipeline &operator=(const PassPipeline &) = delete;
+
+public:
+  class Pass {
+    Pass() = delete;
+
+  public:
+    Pass(const char *Name, PassAnalysisMask Requires,
+         PassAnalysisMask Invalidates, std::function<void()> Run)
+        : Name(Name), Requires(Requires), Invalidates(Invalidates),
+          Run(std::move(Run)) {}
+    /// Dumps the Cfg with the given message after the pass.
+    Pass &dump(const char *Message) {
+      DumpMessage = Message;
+      return *this;
+    }
+    /// Only runs the pass (in the default order) if Enabled.
+    Pass &enabledIf(bool Enabled) {
+      IsEnabled = Enabled;
+      return *this;
+    }
+    /// Marks the pass as necessary for correct code when it is enabled, so that
+    /// it can't be left out of -o2-pass-order.
+    Pass &required() {
+      IsRequired = true;
+      return *this;
+    }
+
+  private:
+    friend class PassPipeline;
+    const char *const Name;
+    const PassAnalysisMask Requires;
+    const PassAnalysisMask Invalidates;
+    const std::function<void()> Run;
+    const char *DumpMessage = nullptr;
+    bool IsEnabled = true;
+    bool IsRequired = false;
+  };
+
+  PassPipeline(Cfg *Func, const std::string &Order)
+      : Func(Func), Order(Order) {}
+
+  /// Appends a pass that runs after the passes added so far.
+  Pass &add(const char *Name, PassAnalysisMask Requires,
+            PassAnalysisMask Invalidates, std::function<void()> Run);
+
+  /// The passes that every target's O2 pipeline shares.
+  /// @{
+  Pass &addSCCP();
+  Pass &addIfConversion();
+  Pass &addRedundantLoadElim();
+  Pass &addPhiLowering();
+  Pass &addAddressOpt();
+  Pass &addArgLowering();
+  Pass &addGenCode();
+  Pass &addRegAlloc();
+  Pass &addAdvancedPhiLowering();
+  Pass &addGenFrame();
+  Pass &addNodeLayout();
+  Pass &addBranchOpt();
+  Pass &addNopInsertion();
+  /// @}
+
+  /// Runs the passes, stopping at the first one that sets an error on the Cfg.
+  void run();
+
+private:
+  std::vector<const Pass *> getOrder() const;
+  /// Computes the analyses in Requires that are not currently valid.
+  void establish(PassAnalysisMask Requires);
+  void runPass(const Pass &P);
+
+  Cfg *const Func;
+  const std::string Order;
+  std::vector<std::unique_ptr<Pass>> Passes;
+  PassAnalysisMask Valid = PA_None;
+};
+
+} // end of namespace Ice
+
+#endif // SUBZERO_SRC_ICEPASSPIPELINE_H
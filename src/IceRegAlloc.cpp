@@ -137,13 +137,17 @@ void LinearScan::initForGlobal() {
     }
   }
 
-  // Build the (ordered) list of FakeKill instruction numbers.
   Kills.clear();
   // Phi lowering should not be creating new call instructions, so there should
   // be no infinite-weight not-yet-colored live ranges that span a call
   // instruction, hence no need to construct the Kills list.
   if (Kind == RAK_Phi)
     return;
+  initKills();
+}
+
+// Build the (ordered) list of FakeKill instruction numbers.
+void LinearScan::initKills() {
   for (CfgNode *Node : Func->getNodes()) {
     for (Inst &I : Node->getInsts()) {
       if (auto *Kill = llvm::dyn_cast<InstFakeKill>(&I)) {
@@ -183,15 +187,21 @@ bool LinearScan::livenessValidateIntervals(
 }
 
 // Prepare for very simple register allocation of only infinite-weight Variables
-// while respecting pre-colored Variables. Some properties we take advantage of:
+// while respecting pre-colored Variables, and under RAK_BlockLocal, of the
+// Variables whose references are all in a single basic block. Some properties
+// we take advantage of:
 //
-// * Live ranges of interest consist of a single segment.
+// * Live ranges of interest consist of a single segment. For a block-local
+//   Variable, the segment runs from its first definition to its last use, and
+//   is exact since nothing else in the function references the Variable.
 //
-// * Live ranges of interest never span a call instruction.
+// * Live ranges of infinite-weight Variables never span a call instruction.
+//   Block-local Variables may, so the Kills list is built for them.
 //
 // * Phi instructions are not considered because either phis have already been
 //   lowered, or they don't contain any pre-colored or infinite-weight
-//   Variables.
+//   Variables. Phi lowering makes the phi destinations multi-block, so they
+//   are never block-local.
 //
 // * We don't need to renumber instructions before computing live ranges because
 //   all the high-level ICE instructions are deleted prior to lowering, and the
@@ -205,16 +215,32 @@ bool LinearScan::livenessValidateIntervals(
 //   empty, and the live range trimming operation is unnecessary.
 //
 // * Calculating overlap of single-segment live ranges could be optimized a bit.
-void LinearScan::initForInfOnly() {
+void LinearScan::initForSingleSegment() {
   TimerMarker T(TimerStack::TT_initUnhandled, Func);
   FindPreference = false;
   FindOverlap = false;
   SizeT NumVars = 0;
 
+  // Block-local Variables must have been found by VariablesMetadata, which
+  // counts definitions as uses.
+  const bool BlockLocal = (Kind == RAK_BlockLocal);
+  const VariablesMetadata *VMetadata = Func->getVMetadata();
+  auto IsRequired = [](const Variable *Var) {
+    return Var->hasReg() || Var->mustHaveReg();
+  };
+  auto IsCandidate = [BlockLocal, VMetadata, &IsRequired](const Variable *Var) {
+    if (IsRequired(Var))
+      return true;
+    return BlockLocal && !Var->mustNotHaveReg() && !Var->getIsArg() &&
+           VMetadata->isTracked(Var) && !VMetadata->isMultiBlock(Var);
+  };
+
   // Iterate across all instructions and record the begin and end of the live
-  // range for each variable that is pre-colored or infinite weight.
+  // range for each candidate Variable. A block-local Variable that is used
+  // before it is defined is left on the stack rather than being diagnosed.
   CfgVector<InstNumberT> LRBegin(Vars.size(), Inst::NumberSentinel);
   CfgVector<InstNumberT> LREnd(Vars.size(), Inst::NumberSentinel);
+  BitVector UsedBeforeDef(BlockLocal ? Vars.size() : 0);
   DefUseErrorList DefsWithoutUses, UsesBeforeDefs;
   for (CfgNode *Node : Func->getNodes()) {
     for (Inst &Instr : Node->getInsts()) {
@@ -223,16 +249,19 @@ void LinearScan::initForInfOnly() {
       FOREACH_VAR_IN_INST(Var, Instr) {
         if (Var->getIgnoreLiveness())
           continue;
-        if (Var->hasReg() || Var->mustHaveReg()) {
+        if (IsCandidate(Var)) {
           SizeT VarNum = Var->getIndex();
           LREnd[VarNum] = Instr.getNumber();
-          if (!Var->getIsArg() && LRBegin[VarNum] == Inst::NumberSentinel)
-            UsesBeforeDefs.push_back(VarNum);
+          if (!Var->getIsArg() && LRBegin[VarNum] == Inst::NumberSentinel) {
+            if (IsRequired(Var))
+              UsesBeforeDefs.push_back(VarNum);
+            else
+              UsedBeforeDef[VarNum] = true;
+          }
         }
       }
       if (const Variable *Var = Instr.getDest()) {
-        if (!Var->getIgnoreLiveness() &&
-            (Var->hasReg() || Var->mustHaveReg())) {
+        if (!Var->getIgnoreLiveness() && IsCandidate(Var)) {
           if (LRBegin[Var->getIndex()] == Inst::NumberSentinel) {
             LRBegin[Var->getIndex()] = Instr.getNumber();
             ++NumVars;
@@ -249,10 +278,16 @@ void LinearScan::initForInfOnly() {
     if (Var->isRematerializable())
       continue;
     if (LRBegin[i] != Inst::NumberSentinel) {
+      --NumVars;
       if (LREnd[i] == Inst::NumberSentinel) {
-        DefsWithoutUses.push_back(i);
+        // A block-local definition without a use is dead, and needs no
+        // register.
+        if (IsRequired(Var))
+          DefsWithoutUses.push_back(i);
         continue;
       }
+      if (BlockLocal && UsedBeforeDef[i])
+        continue;
       Unhandled.push_back(Var);
       Var->resetLiveRange();
       Var->addLiveRange(LRBegin[i], LREnd[i]);
@@ -262,40 +297,21 @@ void LinearScan::initForInfOnly() {
         Var->setMustHaveReg();
         UnhandledPrecolored.push_back(Var);
       }
-      --NumVars;
     }
   }
 
   if (!livenessValidateIntervals(DefsWithoutUses, UsesBeforeDefs, LRBegin,
                                  LREnd)) {
-    llvm::report_fatal_error("initForInfOnly: Liveness error");
+    llvm::report_fatal_error("initForSingleSegment: Liveness error");
     return;
   }
-
-  if (!DefsWithoutUses.empty() || !UsesBeforeDefs.empty()) {
-    if (BuildDefs::dump()) {
-      OstreamLocker L(Ctx);
-      Ostream &Str = Ctx->getStrDump();
-      for (SizeT VarNum : DefsWithoutUses) {
-        Variable *Var = Vars[VarNum];
-        Str << "LR def without use, instruction " << LRBegin[VarNum]
-            << ", variable " << Var->getName() << "\n";
-      }
-      for (SizeT VarNum : UsesBeforeDefs) {
-        Variable *Var = Vars[VarNum];
-        Str << "LR use before def, instruction " << LREnd[VarNum]
-            << ", variable " << Var->getName() << "\n";
-      }
-    }
-    llvm::report_fatal_error("initForInfOnly: Liveness error");
-  }
   // This isn't actually a fatal condition, but it would be nice to know if we
   // somehow pre-calculated Unhandled's size wrong.
   assert(NumVars == 0);
 
-  // Don't build up the list of Kills because we know that no infinite-weight
-  // Variable has a live range spanning a call.
   Kills.clear();
+  if (BlockLocal)
+    initKills();
 }
 
 void LinearScan::initForSecondChance() {
@@ -351,7 +367,8 @@ void LinearScan::init(RegAllocKind Kind, CfgSet<Variable *> ExcludeVars) {
     initForGlobal();
     break;
   case RAK_InfOnly:
-    initForInfOnly();
+  case RAK_BlockLocal:
+    initForSingleSegment();
     break;
   case RAK_SecondChance:
     initForSecondChance();
@@ -371,6 +388,7 @@ void LinearScan::init(RegAllocKind Kind, CfgSet<Variable *> ExcludeVars) {
   std::sort(Unhandled.rbegin(), Unhandled.rend(), CompareRanges);
   std::sort(UnhandledPrecolored.rbegin(), UnhandledPrecolored.rend(),
             CompareRanges);
+  initVarTable();
 
   Handled.reserve(Unhandled.size());
   Inactive.reserve(Unhandled.size());
@@ -378,6 +396,21 @@ void LinearScan::init(RegAllocKind Kind, CfgSet<Variable *> ExcludeVars) {
   Evicted.reserve(Unhandled.size());
 }
 
+void LinearScan::initVarTable() {
+  const SizeT NumVars = Func->getNumVariables();
+  VarRangeStart.assign(NumVars, Inst::NumberSentinel);
+  VarRangeEnd.assign(NumVars, Inst::NumberSentinel);
+  VarWeight.assign(NumVars, RegWeight());
+  VarRegNumTmp.assign(NumVars, RegNumT());
+  for (const Variable *Var : Unhandled) {
+    const SizeT Index = Var->getIndex();
+    VarRangeStart[Index] = Var->getLiveRange().getStart();
+    VarRangeEnd[Index] = Var->getLiveRange().getEnd();
+    VarWeight[Index] = Var->getWeight(Func);
+    VarRegNumTmp[Index] = Var->getRegNumTmp();
+  }
+}
+
 // This is called when Cur must be allocated a register but no registers are
 // available across Cur's live range. To handle this, we find a register that is
 // not explicitly used during Cur's live range, spill that register to a stack
@@ -432,7 +465,7 @@ void LinearScan::addSpillFill(IterationState &Iter) {
   ++FillPoint;
   // TODO(stichnot): Randomize instead of *.begin() which maps to find_first().
   const RegNumT RegNum = *RegNumBVIter(Iter.RegMask).begin();
-  Iter.Cur->setRegNumTmp(RegNum);
+  setRegNumTmp(Iter.Cur, RegNum);
   Variable *Preg = Target->getPhysicalRegister(RegNum, Iter.Cur->getType());
   // TODO(stichnot): Add SpillLoc to VariablesMetadata tracking so that SpillLoc
   // is correctly identified as !isMultiBlock(), reducing stack frame size.
@@ -451,7 +484,7 @@ void LinearScan::handleActiveRangeExpiredOrInactive(const Variable *Cur) {
     Variable *Item = Active[Index];
     Item->trimLiveRange(Cur->getLiveRange().getStart());
     bool Moved = false;
-    if (Item->rangeEndsBefore(Cur)) {
+    if (rangeEndsBefore(Item, Cur)) {
       // Move Item from Active to Handled list.
       dumpLiveRangeTrace("Expiring     ", Item);
       moveItem(Active, Index, Handled);
@@ -465,7 +498,7 @@ void LinearScan::handleActiveRangeExpiredOrInactive(const Variable *Cur) {
     if (Moved) {
       // Decrement Item from RegUses[].
       assert(Item->hasRegTmp());
-      const auto &Aliases = *RegAliases[Item->getRegNumTmp()];
+      const auto &Aliases = *RegAliases[getRegNumTmp(Item)];
       for (RegNumT RegAlias : RegNumBVIter(Aliases)) {
         --RegUses[RegAlias];
         assert(RegUses[RegAlias] >= 0);
@@ -479,7 +512,7 @@ void LinearScan::handleInactiveRangeExpiredOrReactivated(const Variable *Cur) {
     const SizeT Index = I - 1;
     Variable *Item = Inactive[Index];
     Item->trimLiveRange(Cur->getLiveRange().getStart());
-    if (Item->rangeEndsBefore(Cur)) {
+    if (rangeEndsBefore(Item, Cur)) {
       // Move Item from Inactive to Handled list.
       dumpLiveRangeTrace("Expiring     ", Item);
       moveItem(Inactive, Index, Handled);
@@ -489,7 +522,7 @@ void LinearScan::handleInactiveRangeExpiredOrReactivated(const Variable *Cur) {
       moveItem(Inactive, Index, Active);
       // Increment Item in RegUses[].
       assert(Item->hasRegTmp());
-      const auto &Aliases = *RegAliases[Item->getRegNumTmp()];
+      const auto &Aliases = *RegAliases[getRegNumTmp(Item)];
       for (RegNumT RegAlias : RegNumBVIter(Aliases)) {
         assert(RegUses[RegAlias] >= 0);
         ++RegUses[RegAlias];
@@ -568,7 +601,7 @@ void LinearScan::filterFreeWithInactiveRanges(IterationState &Iter) {
   for (const Variable *Item : Inactive) {
     if (!Item->rangeOverlaps(Iter.Cur))
       continue;
-    const auto &Aliases = *RegAliases[Item->getRegNumTmp()];
+    const auto &Aliases = *RegAliases[getRegNumTmp(Item)];
     for (RegNumT RegAlias : RegNumBVIter(Aliases)) {
       // Don't assert(Iter.Free[RegAlias]) because in theory (though probably
       // never in practice) there could be two inactive variables that were
@@ -596,7 +629,7 @@ void LinearScan::filterFreeWithPrecoloredRanges(IterationState &Iter) {
   // to restrict the number of overlap comparisons needed.
   for (Variable *Item : reverse_range(UnhandledPrecolored)) {
     assert(Item->hasReg());
-    if (Iter.Cur->rangeEndsBefore(Item))
+    if (rangeEndsBefore(Iter.Cur, Item))
       break;
     if (!Item->rangeOverlaps(Iter.Cur))
       continue;
@@ -620,7 +653,7 @@ void LinearScan::filterFreeWithPrecoloredRanges(IterationState &Iter) {
 void LinearScan::allocatePrecoloredRegister(Variable *Cur) {
   const auto RegNum = Cur->getRegNum();
   // RegNumTmp should have already been set above.
-  assert(Cur->getRegNumTmp() == RegNum);
+  assert(getRegNumTmp(Cur) == RegNum);
   dumpLiveRangeTrace("Precoloring  ", Cur);
   Active.push_back(Cur);
   const auto &Aliases = *RegAliases[RegNum];
@@ -634,7 +667,7 @@ void LinearScan::allocatePrecoloredRegister(Variable *Cur) {
 }
 
 void LinearScan::allocatePreferredRegister(IterationState &Iter) {
-  Iter.Cur->setRegNumTmp(Iter.PreferReg);
+  setRegNumTmp(Iter.Cur, Iter.PreferReg);
   dumpLiveRangeTrace("Preferring   ", Iter.Cur);
   const auto &Aliases = *RegAliases[Iter.PreferReg];
   for (RegNumT RegAlias : RegNumBVIter(Aliases)) {
@@ -647,7 +680,7 @@ void LinearScan::allocatePreferredRegister(IterationState &Iter) {
 void LinearScan::allocateFreeRegister(IterationState &Iter, bool Filtered) {
   const RegNumT RegNum =
       *RegNumBVIter(Filtered ? Iter.Free : Iter.FreeUnfiltered).begin();
-  Iter.Cur->setRegNumTmp(RegNum);
+  setRegNumTmp(Iter.Cur, RegNum);
   if (Filtered)
     dumpLiveRangeTrace("Allocating Y ", Iter.Cur);
   else
@@ -665,11 +698,11 @@ void LinearScan::handleNoFreeRegisters(IterationState &Iter) {
   for (const Variable *Item : Active) {
     assert(Item->rangeOverlaps(Iter.Cur));
     assert(Item->hasRegTmp());
-    const auto &Aliases = *RegAliases[Item->getRegNumTmp()];
+    const auto &Aliases = *RegAliases[getRegNumTmp(Item)];
     // We add the Item's weight to each alias/subregister to represent that,
     // should we decide to pick any of them, then we would incur that many
     // memory accesses.
-    RegWeight W = Item->getWeight(Func);
+    const RegWeight &W = getWeight(Item);
     for (RegNumT RegAlias : RegNumBVIter(Aliases)) {
       Iter.Weights[RegAlias].addWeight(W);
     }
@@ -679,8 +712,8 @@ void LinearScan::handleNoFreeRegisters(IterationState &Iter) {
     if (!Item->rangeOverlaps(Iter.Cur))
       continue;
     assert(Item->hasRegTmp());
-    const auto &Aliases = *RegAliases[Item->getRegNumTmp()];
-    RegWeight W = Item->getWeight(Func);
+    const auto &Aliases = *RegAliases[getRegNumTmp(Item)];
+    const RegWeight &W = getWeight(Item);
     for (RegNumT RegAlias : RegNumBVIter(Aliases)) {
       Iter.Weights[RegAlias].addWeight(W);
     }
@@ -690,7 +723,7 @@ void LinearScan::handleNoFreeRegisters(IterationState &Iter) {
   int32_t MinWeightIndex = findMinWeightIndex(Iter.RegMask, Iter.Weights);
 
   if (MinWeightIndex < 0 ||
-      Iter.Cur->getWeight(Func) <= Iter.Weights[MinWeightIndex]) {
+      getWeight(Iter.Cur) <= Iter.Weights[MinWeightIndex]) {
     if (!Iter.Cur->mustHaveReg()) {
       // Iter.Cur doesn't have priority over any other live ranges, so don't
       // allocate any register to it, and move it to the Handled state.
@@ -719,7 +752,7 @@ void LinearScan::handleNoFreeRegisters(IterationState &Iter) {
       // variable was previously assigned an alias of such a register.
       MinWeightIndex = findMinWeightIndex(Iter.RegMaskUnfiltered, Iter.Weights);
     }
-    if (Iter.Cur->getWeight(Func) <= Iter.Weights[MinWeightIndex]) {
+    if (getWeight(Iter.Cur) <= Iter.Weights[MinWeightIndex]) {
       dumpLiveRangeTrace("Failing      ", Iter.Cur);
       Func->setError("Unable to find a physical register for an "
                      "infinite-weight live range "
@@ -738,7 +771,7 @@ void LinearScan::handleNoFreeRegisters(IterationState &Iter) {
   for (SizeT I = Active.size(); I > 0; --I) {
     const SizeT Index = I - 1;
     Variable *Item = Active[Index];
-    const auto RegNum = Item->getRegNumTmp();
+    const auto RegNum = getRegNumTmp(Item);
     if (Aliases[RegNum]) {
       dumpLiveRangeTrace("Evicting A   ", Item);
       const auto &Aliases = *RegAliases[RegNum];
@@ -746,7 +779,7 @@ void LinearScan::handleNoFreeRegisters(IterationState &Iter) {
         --RegUses[RegAlias];
         assert(RegUses[RegAlias] >= 0);
       }
-      Item->setRegNumTmp(RegNumT());
+      setRegNumTmp(Item, RegNumT());
       moveItem(Active, Index, Handled);
       Evicted.push_back(Item);
     }
@@ -762,15 +795,15 @@ void LinearScan::handleNoFreeRegisters(IterationState &Iter) {
     // evicting an infinite-weight but currently-inactive live range. The most
     // common situation for this would be a scratch register kill set for call
     // instructions.
-    if (Aliases[Item->getRegNumTmp()] && Item->rangeOverlaps(Iter.Cur)) {
+    if (Aliases[getRegNumTmp(Item)] && Item->rangeOverlaps(Iter.Cur)) {
       dumpLiveRangeTrace("Evicting I   ", Item);
-      Item->setRegNumTmp(RegNumT());
+      setRegNumTmp(Item, RegNumT());
       moveItem(Inactive, Index, Handled);
       Evicted.push_back(Item);
     }
   }
   // Assign the register to Cur.
-  Iter.Cur->setRegNumTmp(RegNumT::fromInt(MinWeightIndex));
+  setRegNumTmp(Iter.Cur, RegNumT::fromInt(MinWeightIndex));
   for (RegNumT RegAlias : RegNumBVIter(Aliases)) {
     assert(RegUses[RegAlias] >= 0);
     ++RegUses[RegAlias];
@@ -913,7 +946,7 @@ void LinearScan::scan(const SmallBitVector &RegMaskFull, bool Randomized) {
     if (Iter.AllowOverlap) {
       const auto &Aliases = *RegAliases[Iter.PreferReg];
       for (const Variable *Item : Active) {
-        const RegNumT RegNum = Item->getRegNumTmp();
+        const RegNumT RegNum = getRegNumTmp(Item);
         if (Item != Iter.Prefer && Aliases[RegNum] &&
             overlapsDefs(Func, Iter.Cur, Item)) {
           Iter.AllowOverlap = false;
@@ -76,7 +76,8 @@ private:
                                  const CfgVector<InstNumberT> &LRBegin,
                                  const CfgVector<InstNumberT> &LREnd) const;
   void initForGlobal();
-  void initForInfOnly();
+  void initForSingleSegment();
+  void initKills();
   void initForSecondChance();
   /// Move an item from the From set to the To set. From[Index] is pushed onto
   /// the end of To[], then the item is efficiently removed from From[] by
@@ -110,6 +111,26 @@ private:
                             bool Randomized);
   /// @}
 
+  /// \name Accessors for the dense side table.
+  /// @{
+  void initVarTable();
+  /// Like Item->rangeEndsBefore(Other), for Variables in the table.
+  bool rangeEndsBefore(const Variable *Item, const Variable *Other) const {
+    return VarRangeEnd[Item->getIndex()] <= VarRangeStart[Other->getIndex()];
+  }
+  RegNumT getRegNumTmp(const Variable *Var) const {
+    assert(Var->getRegNumTmp() == VarRegNumTmp[Var->getIndex()]);
+    return VarRegNumTmp[Var->getIndex()];
+  }
+  void setRegNumTmp(Variable *Var, RegNumT RegNum) {
+    Var->setRegNumTmp(RegNum);
+    VarRegNumTmp[Var->getIndex()] = RegNum;
+  }
+  const RegWeight &getWeight(const Variable *Var) const {
+    return VarWeight[Var->getIndex()];
+  }
+  /// @}
+
   void dumpLiveRangeTrace(const char *Label, const Variable *Item);
 
   Cfg *const Func;
@@ -134,6 +155,18 @@ private:
   const bool Verbose;
   const bool UseReserve;
   CfgVector<Variable *> Vars;
+  /// Dense copies of the Variable fields that the scan loop reads most often,
+  /// indexed by Variable::getIndex(), so that the walks over the Active,
+  /// Inactive, and UnhandledPrecolored lists read contiguous arrays instead of
+  /// scattered Variable objects. They are filled in by init() for the
+  /// Variables on the Unhandled list, and the Variables themselves stay
+  /// authoritative: setRegNumTmp() updates both. VarRangeStart is the untrimmed
+  /// start, and VarWeight caches Variable::getWeight(), which otherwise
+  /// consults VariablesMetadata on every call.
+  CfgVector<InstNumberT> VarRangeStart;
+  CfgVector<InstNumberT> VarRangeEnd;
+  CfgVector<RegWeight> VarWeight;
+  CfgVector<RegNumT> VarRegNumTmp;
 };
 
 } // end of namespace Ice
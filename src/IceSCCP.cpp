@@ -0,0 +1,708 @@
+//===- subzero/src/IceSCCP.cpp - Sparse conditional constant prop ---------===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implements the sparse conditional constant propagation pass.
+///
+//===----------------------------------------------------------------------===//
+
+#include "IceSCCP.h"
+
+#include "IceCfg.h"
+#include "IceCfgNode.h"
+#include "IceGlobalContext.h"
+#include "IceInst.h"
+#include "IceOperand.h"
+#include "IceTimerTree.h"
+
+#include <cmath>
+
+namespace Ice {
+
+namespace {
+
+/// The lattice value of a Variable. Unknown means that no executable definition
+/// has been seen yet, and Overdefined means that the Variable may hold more
+/// than one value at run time.
+struct LatticeValue {
+  enum StateKind { Unknown, Const, Overdefined };
+  StateKind State = Unknown;
+  Constant *Value = nullptr;
+};
+
+/// Returns true if the instruction only computes its Dest from its sources, so
+/// that it can be deleted when Dest is unused.
+bool isPure(const Inst *Instr) {
+  if (Instr->getDest() == nullptr || Instr->hasSideEffects())
+    return false;
+  return llvm::isa<InstArithmetic>(Instr) || llvm::isa<InstIcmp>(Instr) ||
+         llvm::isa<InstFcmp>(Instr) || llvm::isa<InstCast>(Instr) ||
+         llvm::isa<InstAssign>(Instr) || llvm::isa<InstSelect>(Instr) ||
+         llvm::isa<InstPhi>(Instr);
+}
+
+/// Returns true if Opnd is a constant whose value the folder understands.
+/// Relocatables and undef are treated as unknown values at run time.
+bool isFoldableConstant(const Operand *Opnd) {
+  return llvm::isa<ConstantInteger32>(Opnd) ||
+         llvm::isa<ConstantInteger64>(Opnd) ||
+         llvm::isa<ConstantFloat>(Opnd) || llvm::isa<ConstantDouble>(Opnd);
+}
+
+uint64_t widthMask(SizeT Width) {
+  return Width >= 64 ? ~uint64_t(0) : (uint64_t(1) << Width) - 1;
+}
+
+/// Returns the value of an integer constant, zero-extended from its width.
+uint64_t getUnsigned(const Constant *C) {
+  const SizeT Width = getScalarIntBitWidth(C->getType());
+  if (auto *C64 = llvm::dyn_cast<ConstantInteger64>(C))
+    return uint64_t(C64->getValue()) & widthMask(Width);
+  return uint64_t(llvm::cast<ConstantInteger32>(C)->getValue()) &
+         widthMask(Width);
+}
+
+int64_t signExtend(uint64_t Value, SizeT Width) {
+  if (Width >= 64)
+    return int64_t(Value);
+  const uint64_t SignBit = uint64_t(1) << (Width - 1);
+  Value &= widthMask(Width);
+  return int64_t((Value ^ SignBit) - SignBit);
+}
+
+/// Returns the value of an integer constant, sign-extended from its width.
+int64_t getSigned(const Constant *C) {
+  return signExtend(getUnsigned(C), getScalarIntBitWidth(C->getType()));
+}
+
+double getFloating(const Constant *C) {
+  if (auto *F = llvm::dyn_cast<ConstantFloat>(C))
+    return F->getValue();
+  return llvm::cast<ConstantDouble>(C)->getValue();
+}
+
+class ConstantPropagation {
+  ConstantPropagation() = delete;
+  ConstantPropagation(const ConstantPropagation &) = delete;
+  ConstantPropagation &operator=(const ConstantPropagation &) = delete;
+
+public:
+  explicit ConstantPropagation(Cfg *Func)
+      : Func(Func), Ctx(Func->getContext()),
+        Values(Func->getNumVariables()), Users(Func->getNumVariables()),
+        Executable(Func->getNumNodes()),
+        FeasibleSuccs(Func->getNumNodes()) {}
+
+  void solve();
+  /// Rewrites the Cfg according to the solution. Returns the number of folded
+  /// Variables and branches.
+  uint32_t rewrite();
+  /// Deletes the pure instructions whose results are unused, and returns their
+  /// number.
+  uint32_t deleteDeadCode();
+
+private:
+  struct Use {
+    Inst *Instr;
+    CfgNode *Node;
+  };
+
+  void initDefs();
+  void markEdgeFeasible(CfgNode *Pred, CfgNode *Succ);
+  bool isEdgeFeasible(const CfgNode *Pred, const CfgNode *Succ) const;
+  void visitNode(CfgNode *Node);
+  void visitInst(Inst *Instr, CfgNode *Node);
+  void visitTerminator(Inst *Instr, CfgNode *Node);
+  LatticeValue getValue(Operand *Opnd) const;
+  void setValue(Variable *Dest, const LatticeValue &Value);
+  LatticeValue evaluate(const Inst *Instr, const CfgNode *Node) const;
+  Constant *foldArithmetic(InstArithmetic::OpKind Op, Type Ty, Constant *A,
+                           Constant *B) const;
+  Constant *foldIcmp(InstIcmp::ICond Cond, Constant *A, Constant *B) const;
+  Constant *foldFcmp(InstFcmp::FCond Cond, Constant *A, Constant *B) const;
+  Constant *foldCast(InstCast::OpKind Kind, Type DestTy, Constant *Src) const;
+  /// Returns the constant value of a branch condition or switch comparison, or
+  /// nullptr if it is not known to be constant.
+  Constant *getConstantCondition(Operand *Opnd) const {
+    const LatticeValue Value = getValue(Opnd);
+    return Value.State == LatticeValue::Const ? Value.Value : nullptr;
+  }
+  CfgNode *getSwitchTarget(const InstSwitch *Switch, Constant *Cmp) const;
+
+  Cfg *const Func;
+  GlobalContext *const Ctx;
+  /// Lattice values, indexed by Variable::getIndex().
+  CfgVector<LatticeValue> Values;
+  /// The instructions that use each Variable, indexed by Variable::getIndex().
+  CfgVector<CfgVector<Use>> Users;
+  /// Whether each node, indexed by CfgNode::getIndex(), has been reached.
+  CfgVector<bool> Executable;
+  /// The successors each node can branch to, indexed by CfgNode::getIndex().
+  CfgVector<NodeList> FeasibleSuccs;
+  /// Nodes whose phis must be revisited because of a new feasible in-edge, and
+  /// nodes reached for the first time.
+  CfgVector<CfgNode *> NodeWorklist;
+  /// Variables whose lattice value was lowered.
+  CfgVector<Variable *> VarWorklist;
+};
+
+void ConstantPropagation::initDefs() {
+  // Function arguments, Variables with more than one definition, and the
+  // Variables that instructions other than the pure ones define can hold
+  // anything.
+  CfgVector<SizeT> NumDefs(Func->getNumVariables());
+  for (Variable *Arg : Func->getArgs())
+    Values[Arg->getIndex()].State = LatticeValue::Overdefined;
+  for (CfgNode *Node : Func->getNodes()) {
+    auto Visit = [this, Node, &NumDefs](Inst &Instr) {
+      if (Instr.isDeleted())
+        return;
+      for (SizeT I = 0; I < Instr.getSrcSize(); ++I) {
+        if (auto *Var = llvm::dyn_cast<Variable>(Instr.getSrc(I)))
+          Users[Var->getIndex()].push_back({&Instr, Node});
+      }
+      if (Variable *Dest = Instr.getDest()) {
+        ++NumDefs[Dest->getIndex()];
+        if (!isPure(&Instr))
+          Values[Dest->getIndex()].State = LatticeValue::Overdefined;
+      }
+    };
+    for (Inst &Instr : Node->getPhis())
+      Visit(Instr);
+    for (Inst &Instr : Node->getInsts())
+      Visit(Instr);
+  }
+  for (SizeT Index = 0; Index < NumDefs.size(); ++Index) {
+    if (NumDefs[Index] > 1)
+      Values[Index].State = LatticeValue::Overdefined;
+  }
+}
+
+void ConstantPropagation::markEdgeFeasible(CfgNode *Pred, CfgNode *Succ) {
+  NodeList &Succs = FeasibleSuccs[Pred->getIndex()];
+  if (std::find(Succs.begin(), Succs.end(), Succ) != Succs.end())
+    return;
+  Succs.push_back(Succ);
+  // Either the node is reached for the first time, or its phis have a new
+  // incoming value.
+  NodeWorklist.push_back(Succ);
+}
+
+bool ConstantPropagation::isEdgeFeasible(const CfgNode *Pred,
+                                         const CfgNode *Succ) const {
+  const NodeList &Succs = FeasibleSuccs[Pred->getIndex()];
+  return std::find(Succs.begin(), Succs.end(), Succ) != Succs.end();
+}
+
+LatticeValue ConstantPropagation::getValue(Operand *Opnd) const {
+  LatticeValue Result;
+  if (auto *Var = llvm::dyn_cast<Variable>(Opnd))
+    return Values[Var->getIndex()];
+  if (isFoldableConstant(Opnd)) {
+    Result.State = LatticeValue::Const;
+    Result.Value = llvm::cast<Constant>(Opnd);
+  } else {
+    Result.State = LatticeValue::Overdefined;
+  }
+  return Result;
+}
+
+void ConstantPropagation::setValue(Variable *Dest, const LatticeValue &Value) {
+  LatticeValue &Current = Values[Dest->getIndex()];
+  // Values only move down the lattice, from Unknown to a constant and from a
+  // constant to Overdefined.
+  if (Current.State == LatticeValue::Overdefined ||
+      Value.State == LatticeValue::Unknown)
+    return;
+  if (Current.State == LatticeValue::Const &&
+      Value.State == LatticeValue::Const && Current.Value == Value.Value)
+    return;
+  if (Current.State == LatticeValue::Const ||
+      Value.State == LatticeValue::Overdefined) {
+    Current.State = LatticeValue::Overdefined;
+    Current.Value = nullptr;
+  } else {
+    Current = Value;
+  }
+  VarWorklist.push_back(Dest);
+}
+
+Constant *ConstantPropagation::foldArithmetic(InstArithmetic::OpKind Op,
+                                              Type Ty, Constant *A,
+                                              Constant *B) const {
+  // Floating point arithmetic is left to the target, so that the result does
+  // not depend on the host's floating point environment.
+  if (!isScalarIntegerType(Ty))
+    return nullptr;
+  const SizeT Width = getScalarIntBitWidth(Ty);
+  const uint64_t UA = getUnsigned(A), UB = getUnsigned(B);
+  const int64_t SA = getSigned(A), SB = getSigned(B);
+  uint64_t Result = 0;
+  switch (Op) {
+  default:
+    return nullptr;
+  case InstArithmetic::Add:
+    Result = UA + UB;
+    break;
+  case InstArithmetic::Sub:
+    Result = UA - UB;
+    break;
+  case InstArithmetic::Mul:
+    Result = UA * UB;
+    break;
+  case InstArithmetic::And:
+    Result = UA & UB;
+    break;
+  case InstArithmetic::Or:
+    Result = UA | UB;
+    break;
+  case InstArithmetic::Xor:
+    Result = UA ^ UB;
+    break;
+  // Shifting by the width or more, dividing by zero, and overflowing a signed
+  // division are undefined, so the instruction is left for the target to
+  // lower as it would without this pass.
+  case InstArithmetic::Shl:
+    if (UB >= Width)
+      return nullptr;
+    Result = UA << UB;
+    break;
+  case InstArithmetic::Lshr:
+    if (UB >= Width)
+      return nullptr;
+    Result = UA >> UB;
+    break;
+  case InstArithmetic::Ashr:
+    if (UB >= Width)
+      return nullptr;
+    Result = uint64_t(SA >> UB);
+    break;
+  case InstArithmetic::Udiv:
+  case InstArithmetic::Urem:
+    if (UB == 0)
+      return nullptr;
+    Result = (Op == InstArithmetic::Udiv) ? UA / UB : UA % UB;
+    break;
+  case InstArithmetic::Sdiv:
+  case InstArithmetic::Srem:
+    if (SB == 0 || (SB == -1 && SA == signExtend(uint64_t(1) << (Width - 1),
+                                                 Width)))
+      return nullptr;
+    Result = uint64_t((Op == InstArithmetic::Sdiv) ? SA / SB : SA % SB);
+    break;
+  }
+  return Ctx->getConstantInt(Ty, signExtend(Result, Width));
+}
+
+Constant *ConstantPropagation::foldIcmp(InstIcmp::ICond Cond, Constant *A,
+                                        Constant *B) const {
+  if (!isScalarIntegerType(A->getType()))
+    return nullptr;
+  const uint64_t UA = getUnsigned(A), UB = getUnsigned(B);
+  const int64_t SA = getSigned(A), SB = getSigned(B);
+  bool Result = false;
+  switch (Cond) {
+  default:
+    return nullptr;
+  case InstIcmp::Eq:
+    Result = UA == UB;
+    break;
+  case InstIcmp::Ne:
+    Result = UA != UB;
+    break;
+  case InstIcmp::Ugt:
+    Result = UA > UB;
+    break;
+  case InstIcmp::Uge:
+    Result = UA >= UB;
+    break;
+  case InstIcmp::Ult:
+    Result = UA < UB;
+    break;
+  case InstIcmp::Ule:
+    Result = UA <= UB;
+    break;
+  case InstIcmp::Sgt:
+    Result = SA > SB;
+    break;
+  case InstIcmp::Sge:
+    Result = SA >= SB;
+    break;
+  case InstIcmp::Slt:
+    Result = SA < SB;
+    break;
+  case InstIcmp::Sle:
+    Result = SA <= SB;
+    break;
+  }
+  return Ctx->getConstantInt1(Result);
+}
+
+Constant *ConstantPropagation::foldFcmp(InstFcmp::FCond Cond, Constant *A,
+                                        Constant *B) const {
+  if (!isScalarFloatingType(A->getType()))
+    return nullptr;
+  const double FA = getFloating(A), FB = getFloating(B);
+  const bool Unordered = std::isnan(FA) || std::isnan(FB);
+  bool Result = false;
+  switch (Cond) {
+  default:
+    return nullptr;
+  case InstFcmp::False:
+    Result = false;
+    break;
+  case InstFcmp::Oeq:
+    Result = !Unordered && FA == FB;
+    break;
+  case InstFcmp::Ogt:
+    Result = !Unordered && FA > FB;
+    break;
+  case InstFcmp::Oge:
+    Result = !Unordered && FA >= FB;
+    break;
+  case InstFcmp::Olt:
+    Result = !Unordered && FA < FB;
+    break;
+  case InstFcmp::Ole:
+    Result = !Unordered && FA <= FB;
+    break;
+  case InstFcmp::One:
+    Result = !Unordered && FA != FB;
+    break;
+  case InstFcmp::Ord:
+    Result = !Unordered;
+    break;
+  case InstFcmp::Ueq:
+    Result = Unordered || FA == FB;
+    break;
+  case InstFcmp::Ugt:
+    Result = Unordered || FA > FB;
+    break;
+  case InstFcmp::Uge:
+    Result = Unordered || FA >= FB;
+    break;
+  case InstFcmp::Ult:
+    Result = Unordered || FA < FB;
+    break;
+  case InstFcmp::Ule:
+    Result = Unordered || FA <= FB;
+    break;
+  case InstFcmp::Une:
+    Result = Unordered || FA != FB;
+    break;
+  case InstFcmp::Uno:
+    Result = Unordered;
+    break;
+  case InstFcmp::True:
+    Result = true;
+    break;
+  }
+  return Ctx->getConstantInt1(Result);
+}
+
+Constant *ConstantPropagation::foldCast(InstCast::OpKind Kind, Type DestTy,
+                                        Constant *Src) const {
+  // Only the integer casts are folded; the conversions that involve floating
+  // point are left to the target, like floating point arithmetic.
+  if (!isScalarIntegerType(DestTy) || !isScalarIntegerType(Src->getType()))
+    return nullptr;
+  switch (Kind) {
+  default:
+    return nullptr;
+  case InstCast::Trunc:
+  case InstCast::Zext:
+    return Ctx->getConstantInt(
+        DestTy, signExtend(getUnsigned(Src), getScalarIntBitWidth(DestTy)));
+  case InstCast::Sext:
+    return Ctx->getConstantInt(DestTy, getSigned(Src));
+  }
+}
+
+LatticeValue ConstantPropagation::evaluate(const Inst *Instr,
+                                           const CfgNode *Node) const {
+  LatticeValue Over;
+  Over.State = LatticeValue::Overdefined;
+  if (isVectorType(Instr->getDest()->getType()))
+    return Over;
+
+  if (auto *Phi = llvm::dyn_cast<InstPhi>(Instr)) {
+    // The meet of the values that flow in along the feasible edges.
+    LatticeValue Result;
+    for (SizeT I = 0; I < Phi->getSrcSize(); ++I) {
+      if (!isEdgeFeasible(Phi->getLabel(I), Node))
+        continue;
+      const LatticeValue Value = getValue(Phi->getSrc(I));
+      if (Value.State == LatticeValue::Unknown)
+        continue;
+      if (Value.State == LatticeValue::Overdefined)
+        return Over;
+      if (Result.State == LatticeValue::Const && Result.Value != Value.Value)
+        return Over;
+      Result = Value;
+    }
+    return Result;
+  }
+
+  if (llvm::isa<InstAssign>(Instr))
+    return getValue(Instr->getSrc(0));
+
+  if (auto *Select = llvm::dyn_cast<InstSelect>(Instr)) {
+    const LatticeValue Cond = getValue(Select->getCondition());
+    if (Cond.State == LatticeValue::Unknown)
+      return Cond;
+    if (Cond.State == LatticeValue::Const)
+      return getValue(getUnsigned(Cond.Value) ? Select->getTrueOperand()
+                                              : Select->getFalseOperand());
+    const LatticeValue True = getValue(Select->getTrueOperand());
+    const LatticeValue False = getValue(Select->getFalseOperand());
+    if (True.State == LatticeValue::Const &&
+        False.State == LatticeValue::Const && True.Value == False.Value)
+      return True;
+    if (True.State == LatticeValue::Unknown ||
+        False.State == LatticeValue::Unknown)
+      return LatticeValue();
+    return Over;
+  }
+
+  // The remaining instructions are folded when all their sources are
+  // constant.
+  Constant *Srcs[2] = {nullptr, nullptr};
+  assert(Instr->getSrcSize() <= llvm::array_lengthof(Srcs));
+  for (SizeT I = 0; I < Instr->getSrcSize(); ++I) {
+    const LatticeValue Value = getValue(Instr->getSrc(I));
+    if (Value.State != LatticeValue::Const)
+      return Value.State == LatticeValue::Unknown ? LatticeValue() : Over;
+    Srcs[I] = Value.Value;
+  }
+  Constant *Folded = nullptr;
+  const Type DestTy = Instr->getDest()->getType();
+  if (auto *Arith = llvm::dyn_cast<InstArithmetic>(Instr))
+    Folded = foldArithmetic(Arith->getOp(), DestTy, Srcs[0], Srcs[1]);
+  else if (auto *Icmp = llvm::dyn_cast<InstIcmp>(Instr))
+    Folded = foldIcmp(Icmp->getCondition(), Srcs[0], Srcs[1]);
+  else if (auto *Fcmp = llvm::dyn_cast<InstFcmp>(Instr))
+    Folded = foldFcmp(Fcmp->getCondition(), Srcs[0], Srcs[1]);
+  else if (auto *Cast = llvm::dyn_cast<InstCast>(Instr))
+    Folded = foldCast(Cast->getCastKind(), DestTy, Srcs[0]);
+  if (Folded == nullptr)
+    return Over;
+  LatticeValue Result;
+  Result.State = LatticeValue::Const;
+  Result.Value = Folded;
+  return Result;
+}
+
+void ConstantPropagation::visitInst(Inst *Instr, CfgNode *Node) {
+  if (Instr->isDeleted())
+    return;
+  Variable *Dest = Instr->getDest();
+  if (Dest == nullptr || Values[Dest->getIndex()].State ==
+                             LatticeValue::Overdefined)
+    return;
+  setValue(Dest, evaluate(Instr, Node));
+}
+
+CfgNode *ConstantPropagation::getSwitchTarget(const InstSwitch *Switch,
+                                              Constant *Cmp) const {
+  const SizeT Width = getScalarIntBitWidth(Cmp->getType());
+  const uint64_t Value = getUnsigned(Cmp);
+  for (SizeT I = 0; I < Switch->getNumCases(); ++I) {
+    if ((Switch->getValue(I) & widthMask(Width)) == Value)
+      return Switch->getLabel(I);
+  }
+  return Switch->getLabelDefault();
+}
+
+void ConstantPropagation::visitTerminator(Inst *Instr, CfgNode *Node) {
+  if (auto *Br = llvm::dyn_cast<InstBr>(Instr)) {
+    if (!Br->isUnconditional()) {
+      const LatticeValue Cond = getValue(Br->getCondition());
+      if (Cond.State == LatticeValue::Unknown)
+        return;
+      if (Cond.State == LatticeValue::Const) {
+        markEdgeFeasible(Node, getUnsigned(Cond.Value) ? Br->getTargetTrue()
+                                                       : Br->getTargetFalse());
+        return;
+      }
+    }
+  } else if (auto *Switch = llvm::dyn_cast<InstSwitch>(Instr)) {
+    const LatticeValue Cmp = getValue(Switch->getComparison());
+    if (Cmp.State == LatticeValue::Unknown)
+      return;
+    if (Cmp.State == LatticeValue::Const) {
+      markEdgeFeasible(Node, getSwitchTarget(Switch, Cmp.Value));
+      return;
+    }
+  }
+  for (CfgNode *Succ : Instr->getTerminatorEdges())
+    markEdgeFeasible(Node, Succ);
+}
+
+void ConstantPropagation::visitNode(CfgNode *Node) {
+  const bool FirstVisit = !Executable[Node->getIndex()];
+  Executable[Node->getIndex()] = true;
+  for (Inst &Instr : Node->getPhis())
+    visitInst(&Instr, Node);
+  // The other instructions don't depend on which in-edge is taken, so they only
+  // need to be visited again when their sources change.
+  if (!FirstVisit)
+    return;
+  for (Inst &Instr : Node->getInsts())
+    visitInst(&Instr, Node);
+  visitTerminator(&Node->getInsts().back(), Node);
+}
+
+void ConstantPropagation::solve() {
+  initDefs();
+  NodeWorklist.push_back(Func->getEntryNode());
+  while (!NodeWorklist.empty() || !VarWorklist.empty()) {
+    while (!NodeWorklist.empty()) {
+      CfgNode *Node = NodeWorklist.back();
+      NodeWorklist.pop_back();
+      visitNode(Node);
+    }
+    while (!VarWorklist.empty()) {
+      Variable *Var = VarWorklist.back();
+      VarWorklist.pop_back();
+      for (const Use &U : Users[Var->getIndex()]) {
+        if (!Executable[U.Node->getIndex()])
+          continue;
+        if (U.Instr->getDest() != nullptr)
+          visitInst(U.Instr, U.Node);
+        else if (U.Instr == &U.Node->getInsts().back())
+          visitTerminator(U.Instr, U.Node);
+      }
+    }
+  }
+}
+
+uint32_t ConstantPropagation::rewrite() {
+  uint32_t NumFolded = 0;
+  for (SizeT Index = 0; Index < Values.size(); ++Index) {
+    if (Values[Index].State == LatticeValue::Const && !Users[Index].empty())
+      ++NumFolded;
+  }
+  for (CfgNode *Node : Func->getNodes()) {
+    auto Replace = [this](Inst &Instr) {
+      if (Instr.isDeleted())
+        return;
+      // The call target stays a Variable, since the targets expect a constant
+      // target to be a relocatable.
+      const SizeT Begin = llvm::isa<InstCall>(&Instr) ? 1 : 0;
+      for (SizeT I = Begin; I < Instr.getSrcSize(); ++I) {
+        if (auto *Var = llvm::dyn_cast<Variable>(Instr.getSrc(I))) {
+          const LatticeValue &Value = Values[Var->getIndex()];
+          if (Value.State == LatticeValue::Const)
+            Instr.replaceSource(I, Value.Value);
+        }
+      }
+    };
+    for (Inst &Instr : Node->getPhis())
+      Replace(Instr);
+    for (Inst &Instr : Node->getInsts())
+      Replace(Instr);
+
+    // Replace a branch on a constant by a branch to the only feasible
+    // successor. The new branch goes at the end of the list, where
+    // CfgNode::computeSuccessors() looks for the terminator.
+    if (!Executable[Node->getIndex()])
+      continue;
+    Inst &Terminator = Node->getInsts().back();
+    CfgNode *Target = nullptr;
+    if (auto *Br = llvm::dyn_cast<InstBr>(&Terminator)) {
+      if (!Br->isUnconditional()) {
+        if (Constant *Cond = getConstantCondition(Br->getCondition()))
+          Target = getUnsigned(Cond) ? Br->getTargetTrue()
+                                     : Br->getTargetFalse();
+      }
+    } else if (auto *Switch = llvm::dyn_cast<InstSwitch>(&Terminator)) {
+      if (Constant *Cmp = getConstantCondition(Switch->getComparison()))
+        Target = getSwitchTarget(Switch, Cmp);
+    }
+    if (Target == nullptr)
+      continue;
+    Terminator.setDeleted();
+    Node->getInsts().push_back(InstBr::create(Func, Target));
+    ++NumFolded;
+  }
+  return NumFolded;
+}
+
+uint32_t ConstantPropagation::deleteDeadCode() {
+  // Count the uses that are left, and delete the pure instructions without
+  // uses, together with the pure instructions that only they used.
+  CfgVector<SizeT> NumUses(Func->getNumVariables());
+  CfgVector<Inst *> Defs(Func->getNumVariables());
+  CfgVector<Inst *> Worklist;
+  for (CfgNode *Node : Func->getNodes()) {
+    auto Count = [&NumUses, &Defs](Inst &Instr) {
+      if (Instr.isDeleted())
+        return;
+      for (SizeT I = 0; I < Instr.getSrcSize(); ++I) {
+        if (auto *Var = llvm::dyn_cast<Variable>(Instr.getSrc(I)))
+          ++NumUses[Var->getIndex()];
+      }
+      if (isPure(&Instr))
+        Defs[Instr.getDest()->getIndex()] = &Instr;
+    };
+    for (Inst &Instr : Node->getPhis())
+      Count(Instr);
+    for (Inst &Instr : Node->getInsts())
+      Count(Instr);
+  }
+  for (Inst *Instr : Defs) {
+    if (Instr != nullptr && NumUses[Instr->getDest()->getIndex()] == 0)
+      Worklist.push_back(Instr);
+  }
+  uint32_t NumDeleted = 0;
+  while (!Worklist.empty()) {
+    Inst *Instr = Worklist.back();
+    Worklist.pop_back();
+    if (Instr->isDeleted())
+      continue;
+    Instr->setDeleted();
+    ++NumDeleted;
+    for (SizeT I = 0; I < Instr->getSrcSize(); ++I) {
+      auto *Var = llvm::dyn_cast<Variable>(Instr->getSrc(I));
+      if (Var == nullptr || --NumUses[Var->getIndex()] > 0)
+        continue;
+      if (Inst *Def = Defs[Var->getIndex()])
+        Worklist.push_back(Def);
+    }
+  }
+  // Phi lowering does not skip deleted phis, so take them out of the lists.
+  for (CfgNode *Node : Func->getNodes()) {
+    PhiList &Phis = Node->getPhis();
+    for (auto I = Phis.begin(), E = Phis.end(); I != E;) {
+      auto Next = std::next(I);
+      if (I->isDeleted())
+        Phis.remove(I);
+      I = Next;
+    }
+  }
+  return NumDeleted;
+}
+
+} // end of anonymous namespace
+
+void propagateConstants(Cfg *Func) {
+  TimerMarker T(TimerStack::TT_sccp, Func);
+  ConstantPropagation SCCP(Func);
+  SCCP.solve();
+  const uint32_t NumFolded = SCCP.rewrite();
+  // Recompute the edges from the new terminators. This drops the nodes that
+  // are no longer reachable, and zeroes the phi operands that came from them.
+  const SizeT NumNodesBefore = Func->getNumNodes();
+  Func->computeInOutEdges();
+  const uint32_t NumDeadNodes = NumNodesBefore - Func->getNumNodes();
+  const uint32_t NumDeleted = SCCP.deleteDeadCode();
+  Func->getContext()->statsUpdateSCCP(NumFolded, NumDeleted, NumDeadNodes);
+}
+
+} // end of namespace Ice
@@ -0,0 +1,33 @@
+//===- subzero/src/IceSCCP.h - Sparse conditional constant prop -*- C++ -*-===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Declares the sparse conditional constant propagation pass, which
+/// folds constants and removes the code they make dead in the high-level ICE
+/// IR.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SUBZERO_SRC_ICESCCP_H
+#define SUBZERO_SRC_ICESCCP_H
+
+namespace Ice {
+
+/// Propagates constants through the function with the sparse conditional
+/// constant propagation algorithm of Wegman and Zadeck. It replaces the uses of
+/// Variables that are found to be constant, folds conditional branches and
+/// switches on constants, prunes the nodes that become unreachable, and deletes
+/// the pure instructions whose results are no longer used.
+///
+/// The Cfg must still be in SSA form, i.e. before phi lowering.
+void propagateConstants(class Cfg *Func);
+
+} // end of namespace Ice
+
+#endif // SUBZERO_SRC_ICESCCP_H
@@ -81,6 +81,7 @@ void LoweringContext::rewind() {
 
 void LoweringContext::insert(Inst *Instr) {
   getNode()->getInsts().insert(Next, Instr);
+  getNode()->getCfg()->placeInstNumber(getNode(), Instr);
   LastInserted = Instr;
 }
 
@@ -521,6 +522,9 @@ void TargetLowering::regAlloc(RegAllocKind Kind) {
     RegExclude |= RegSet_FramePointer;
   SmallBitVector RegMask = getRegisterSet(RegInclude, RegExclude);
   bool Repeat = (Kind == RAK_Global && getFlags().getRepeatRegAlloc());
+  // Splitting needs the live ranges that only a global allocation computes.
+  const bool SplitGlobalVars =
+      Kind != RAK_BlockLocal && getFlags().getSplitGlobalVars();
   CfgSet<Variable *> EmptySet;
   do {
     LinearScan.init(Kind, EmptySet);
@@ -534,7 +538,7 @@ void TargetLowering::regAlloc(RegAllocKind Kind) {
   // set of Variables that have no register and a non-empty live range, and
   // model an infinite number of registers.  Maybe use the register aliasing
   // mechanism to get better packing of narrower slots.
-  if (getFlags().getSplitGlobalVars())
+  if (SplitGlobalVars)
     postRegallocSplitting(RegMask);
 }
 
@@ -951,6 +955,26 @@ bool TargetLowering::shouldOptimizeMemIntrins() {
   return Func->getOptLevel() >= Opt_1 || getFlags().getForceMemIntrinOpt();
 }
 
+bool TargetLowering::isSiblingCallCandidate(const InstCall *Instr) {
+  if (!Instr->isTailcall() || Instr->isTargetHelperCall())
+    return false;
+  if (!getFlags().getEnableSiblingCalls())
+    return false;
+  // Sandboxed returns are rewritten as masked indirect jumps, and nonsfi calls
+  // go through the GOT, so neither can be turned into a direct jump.
+  if (getFlags().getUseSandboxing() || getFlags().getUseNonsfi())
+    return false;
+  if (!llvm::isa<ConstantRelocatable>(Instr->getCallTarget()))
+    return false;
+  auto *Ret = llvm::dyn_cast_or_null<InstRet>(Context.getNextInst());
+  if (Ret == nullptr)
+    return false;
+  Variable *Dest = Instr->getDest();
+  if (!Ret->hasRetValue())
+    return Dest == nullptr;
+  return Dest != nullptr && Ret->getRetValue() == Dest;
+}
+
 void TargetLowering::scalarizeArithmetic(InstArithmetic::OpKind Kind,
                                          Variable *Dest, Operand *Src0,
                                          Operand *Src1) {
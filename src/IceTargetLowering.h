@@ -204,9 +204,8 @@ public:
   virtual void translateO0() {
     Func->setError("Target doesn't specify O0 lowering steps.");
   }
-  virtual void translateO1() {
-    Func->setError("Target doesn't specify O1 lowering steps.");
-  }
+  /// Targets without their own -O1 steps use their -Om1 steps.
+  virtual void translateO1() { translateOm1(); }
   virtual void translateO2() {
     Func->setError("Target doesn't specify O2 lowering steps.");
   }
@@ -500,6 +499,14 @@ protected:
 
   bool shouldOptimizeMemIntrins();
 
+  /// Returns true if the call being lowered can be lowered as a sibling call,
+  /// i.e. as a jump to a direct target after the frame is torn down. This
+  /// requires the call to be marked as a tail call (which also guarantees that
+  /// the callee does not access the caller's allocas) and to be immediately
+  /// followed by a return of the call's result. Whether the arguments fit the
+  /// calling convention is left to the target.
+  bool isSiblingCallCandidate(const InstCall *Instr);
+
   void scalarizeArithmetic(InstArithmetic::OpKind K, Variable *Dest,
                            Operand *Src0, Operand *Src1);
 
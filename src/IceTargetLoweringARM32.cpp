@@ -25,6 +25,7 @@
 #include "IceInstVarIter.h"
 #include "IceLiveness.h"
 #include "IceOperand.h"
+#include "IcePassPipeline.h"
 #include "IcePhiLoweringImpl.h"
 #include "IceRegistersARM32.h"
 #include "IceTargetLoweringARM32.def"
@@ -995,120 +996,60 @@ void TargetARM32::loadNamedConstantRelocatablePIC(
 void TargetARM32::translateO2() {
   TimerMarker T(TimerStack::TT_O2, Func);
 
-  // TODO(stichnot): share passes with other targets?
-  // https://code.google.com/p/nativeclient/issues/detail?id=4094
-  if (SandboxingType == ST_Nonsfi) {
-    createGotPtr();
-  }
-  genTargetHelperCalls();
-  findMaxStackOutArgsSize();
-
+  PassPipeline P(Func, getFlags().getO2PassOrder());
+  P.add("createGotPtr", PA_None, PA_None, [this]() { createGotPtr(); })
+      .enabledIf(SandboxingType == ST_Nonsfi)
+      .required();
+  P.addSCCP();
+  P.addIfConversion();
+  P.add("genHelpers", PA_None, PA_All, [this]() { genTargetHelperCalls(); })
+      .required();
+  P.add("findMaxStackOutArgsSize", PA_None, PA_None,
+        [this]() { findMaxStackOutArgsSize(); })
+      .required();
   // Do not merge Alloca instructions, and lay out the stack.
-  static constexpr bool SortAndCombineAllocas = true;
-  Func->processAllocas(SortAndCombineAllocas);
-  Func->dump("After Alloca processing");
-
-  if (!getFlags().getEnablePhiEdgeSplit()) {
-    // Lower Phi instructions.
-    Func->placePhiLoads();
-    if (Func->hasError())
-      return;
-    Func->placePhiStores();
-    if (Func->hasError())
-      return;
-    Func->deletePhis();
-    if (Func->hasError())
-      return;
-    Func->dump("After Phi lowering");
-  }
-
-  // Address mode optimization.
-  Func->getVMetadata()->init(VMK_SingleDefs);
-  Func->doAddressOpt();
-  Func->materializeVectorShuffles();
-
-  // Argument lowering
-  Func->doArgLowering();
-
-  // Target lowering. This requires liveness analysis for some parts of the
-  // lowering decisions, such as compare/branch fusing. If non-lightweight
-  // liveness analysis is used, the instructions need to be renumbered first.
-  // TODO: This renumbering should only be necessary if we're actually
-  // calculating live intervals, which we only do for register allocation.
-  Func->renumberInstructions();
-  if (Func->hasError())
-    return;
-
-  // TODO: It should be sufficient to use the fastest liveness calculation,
-  // i.e. livenessLightweight(). However, for some reason that slows down the
-  // rest of the translation. Investigate.
-  Func->liveness(Liveness_Basic);
-  if (Func->hasError())
-    return;
-  Func->dump("After ARM32 address mode opt");
-
-  if (SandboxingType == ST_Nonsfi) {
-    insertGotPtrInitPlaceholder();
-  }
-  Func->genCode();
-  if (Func->hasError())
-    return;
-  Func->dump("After ARM32 codegen");
-
-  // Register allocation. This requires instruction renumbering and full
-  // liveness analysis.
-  Func->renumberInstructions();
-  if (Func->hasError())
-    return;
-  Func->liveness(Liveness_Intervals);
-  if (Func->hasError())
-    return;
-  // The post-codegen dump is done here, after liveness analysis and associated
-  // cleanup, to make the dump cleaner and more useful.
-  Func->dump("After initial ARM32 codegen");
-  // Validate the live range computations. The expensive validation call is
-  // deliberately only made when assertions are enabled.
-  assert(Func->validateLiveness());
-  Func->getVMetadata()->init(VMK_All);
-  regAlloc(RAK_Global);
-  if (Func->hasError())
-    return;
-
-  copyRegAllocFromInfWeightVariable64On32(Func->getVariables());
-  Func->dump("After linear scan regalloc");
-
-  if (getFlags().getEnablePhiEdgeSplit()) {
-    Func->advancedPhiLowering();
-    Func->dump("After advanced Phi lowering");
-  }
-
-  ForbidTemporaryWithoutReg _(this);
-
-  // Stack frame mapping.
-  Func->genFrame();
-  if (Func->hasError())
-    return;
-  Func->dump("After stack frame mapping");
-
-  postLowerLegalization();
-  if (Func->hasError())
-    return;
-  Func->dump("After postLowerLegalization");
-
-  Func->contractEmptyNodes();
-  Func->reorderNodes();
-
-  // Branch optimization. This needs to be done just before code emission. In
-  // particular, no transformations that insert or reorder CfgNodes should be
-  // done after branch optimization. We go ahead and do it before nop insertion
-  // to reduce the amount of work needed for searching for opportunities.
-  Func->doBranchOpt();
-  Func->dump("After branch optimization");
-
-  // Nop insertion
-  if (getFlags().getShouldDoNopInsertion()) {
-    Func->doNopInsertion();
-  }
+  P.add("processAllocas", PA_None, PA_All,
+        [this]() {
+          static constexpr bool SortAndCombineAllocas = true;
+          Func->processAllocas(SortAndCombineAllocas);
+        })
+      .dump("After Alloca processing")
+      .required();
+  P.addRedundantLoadElim();
+  P.addPhiLowering();
+  P.addAddressOpt();
+  P.add("vectorShuffles", PA_None, PA_All,
+        [this]() { Func->materializeVectorShuffles(); });
+  P.addArgLowering();
+  // The placeholder doesn't change any liveness that genCode() relies on.
+  P.add("insertGotPtrInitPlaceholder", PA_None, PA_None,
+        [this]() { insertGotPtrInitPlaceholder(); })
+      .enabledIf(SandboxingType == ST_Nonsfi)
+      .required();
+  P.addGenCode().dump("After ARM32 codegen");
+  P.addRegAlloc();
+  P.add("copyRegAllocFromInfWeightVariable64On32", PA_None, PA_None,
+        [this]() {
+          copyRegAllocFromInfWeightVariable64On32(Func->getVariables());
+        })
+      .required();
+  P.addAdvancedPhiLowering();
+  // From here on, every temporary must be created with a register.
+  std::unique_ptr<ForbidTemporaryWithoutReg> Forbid;
+  P.add("forbidTemporaryWithoutReg", PA_None, PA_None,
+        [this, &Forbid]() {
+          Forbid = makeUnique<ForbidTemporaryWithoutReg>(this);
+        })
+      .required();
+  P.addGenFrame();
+  P.add("postLowerLegalization", PA_None, PA_All,
+        [this]() { postLowerLegalization(); })
+      .dump("After postLowerLegalization")
+      .required();
+  P.addNodeLayout();
+  P.addBranchOpt();
+  P.addNopInsertion();
+  P.run();
 }
 
 void TargetARM32::translateOm1() {
@@ -3840,6 +3781,20 @@ void TargetARM32::lowerCall(const InstCall *Instr) {
     Context.insert<InstFakeUse>(RegArg);
   }
 
+  // A tail call whose arguments are all in registers is lowered as a branch
+  // emitted after the epilog, which restores lr, so that the callee returns
+  // directly to our caller. The argument registers are all caller-save, so the
+  // epilog's pops can't clobber them.
+  if (StackArgs.empty() && isSiblingCallCandidate(Instr)) {
+    Context.getNextInst()->setDeleted();
+    Context.advanceNext();
+    Context.getNode()->setHasReturn();
+    _ret(getPhysicalRegister(RegARM32::Reg_lr), nullptr,
+         llvm::cast<ConstantRelocatable>(CallTarget));
+    Context.insert<InstFakeUse>(SP);
+    return;
+  }
+
   InstARM32Call *NewCall =
       Sandboxer(this, InstBundleLock::Opt_AlignToEnd).bl(ReturnReg, CallTarget);
 
@@ -750,8 +750,9 @@ protected:
             CondARM32::Cond Pred = CondARM32::AL) {
     Context.insert<InstARM32Rev>(Dest, Src0, Pred);
   }
-  void _ret(Variable *LR, Variable *Src0 = nullptr) {
-    Context.insert<InstARM32Ret>(LR, Src0);
+  void _ret(Variable *LR, Variable *Src0 = nullptr,
+            const ConstantRelocatable *SiblingCallTarget = nullptr) {
+    Context.insert<InstARM32Ret>(LR, Src0, SiblingCallTarget);
   }
   void _rscs(Variable *Dest, Variable *Src0, Operand *Src1,
              CondARM32::Cond Pred = CondARM32::AL) {
@@ -24,7 +24,9 @@
 #include "IceInstVarIter.h"
 #include "IceLiveness.h"
 #include "IceOperand.h"
+#include "IcePassPipeline.h"
 #include "IcePhiLoweringImpl.h"
+#include "IceRNG.h"
 #include "IceRegistersMIPS32.h"
 #include "IceTargetLoweringMIPS32.def"
 #include "IceUtils.h"
@@ -864,112 +866,44 @@ void TargetMIPS32::findMaxStackOutArgsSize() {
 void TargetMIPS32::translateO2() {
   TimerMarker T(TimerStack::TT_O2, Func);
 
-  // TODO(stichnot): share passes with X86?
-  // https://code.google.com/p/nativeclient/issues/detail?id=4094
-  genTargetHelperCalls();
-
-  unsetIfNonLeafFunc();
-
-  findMaxStackOutArgsSize();
-
+  PassPipeline P(Func, getFlags().getO2PassOrder());
+  P.addSCCP();
+  P.addIfConversion();
+  P.add("genHelpers", PA_None, PA_All, [this]() { genTargetHelperCalls(); })
+      .required();
+  P.add("unsetIfNonLeafFunc", PA_None, PA_None,
+        [this]() { unsetIfNonLeafFunc(); })
+      .required();
+  P.add("findMaxStackOutArgsSize", PA_None, PA_None,
+        [this]() { findMaxStackOutArgsSize(); })
+      .required();
   // Merge Alloca instructions, and lay out the stack.
-  static constexpr bool SortAndCombineAllocas = true;
-  Func->processAllocas(SortAndCombineAllocas);
-  Func->dump("After Alloca processing");
-
-  if (!getFlags().getEnablePhiEdgeSplit()) {
-    // Lower Phi instructions.
-    Func->placePhiLoads();
-    if (Func->hasError())
-      return;
-    Func->placePhiStores();
-    if (Func->hasError())
-      return;
-    Func->deletePhis();
-    if (Func->hasError())
-      return;
-    Func->dump("After Phi lowering");
-  }
-
-  // Address mode optimization.
-  Func->getVMetadata()->init(VMK_SingleDefs);
-  Func->doAddressOpt();
-
-  // Argument lowering
-  Func->doArgLowering();
-
-  // Target lowering. This requires liveness analysis for some parts of the
-  // lowering decisions, such as compare/branch fusing. If non-lightweight
-  // liveness analysis is used, the instructions need to be renumbered first.
-  // TODO: This renumbering should only be necessary if we're actually
-  // calculating live intervals, which we only do for register allocation.
-  Func->renumberInstructions();
-  if (Func->hasError())
-    return;
-
-  // TODO: It should be sufficient to use the fastest liveness calculation,
-  // i.e. livenessLightweight(). However, for some reason that slows down the
-  // rest of the translation. Investigate.
-  Func->liveness(Liveness_Basic);
-  if (Func->hasError())
-    return;
-  Func->dump("After MIPS32 address mode opt");
-
-  Func->genCode();
-  if (Func->hasError())
-    return;
-  Func->dump("After MIPS32 codegen");
-
-  // Register allocation. This requires instruction renumbering and full
-  // liveness analysis.
-  Func->renumberInstructions();
-  if (Func->hasError())
-    return;
-  Func->liveness(Liveness_Intervals);
-  if (Func->hasError())
-    return;
-  // The post-codegen dump is done here, after liveness analysis and associated
-  // cleanup, to make the dump cleaner and more useful.
-  Func->dump("After initial MIPS32 codegen");
-  // Validate the live range computations. The expensive validation call is
-  // deliberately only made when assertions are enabled.
-  assert(Func->validateLiveness());
-  Func->getVMetadata()->init(VMK_All);
-  regAlloc(RAK_Global);
-  if (Func->hasError())
-    return;
-  Func->dump("After linear scan regalloc");
-
-  if (getFlags().getEnablePhiEdgeSplit()) {
-    Func->advancedPhiLowering();
-    Func->dump("After advanced Phi lowering");
-  }
-
-  // Stack frame mapping.
-  Func->genFrame();
-  if (Func->hasError())
-    return;
-  Func->dump("After stack frame mapping");
-
-  postLowerLegalization();
-  if (Func->hasError())
-    return;
-  Func->dump("After postLowerLegalization");
-
-  Func->contractEmptyNodes();
-  Func->reorderNodes();
-
-  // Branch optimization. This needs to be done just before code emission. In
-  // particular, no transformations that insert or reorder CfgNodes should be
-  // done after branch optimization. We go ahead and do it before nop insertion
-  // to reduce the amount of work needed for searching for opportunities.
-  Func->doBranchOpt();
-  Func->dump("After branch optimization");
-
-  // Nop insertion
-  if (getFlags().getShouldDoNopInsertion()) {
-    Func->doNopInsertion();
-  }
+  P.add("processAllocas", PA_None, PA_All,
+        [this]() {
+          static constexpr bool SortAndCombineAllocas = true;
+          Func->processAllocas(SortAndCombineAllocas);
+        })
+      .dump("After Alloca processing")
+      .required();
+  P.addRedundantLoadElim();
+  P.addPhiLowering();
+  P.addAddressOpt();
+  P.addArgLowering();
+  P.addGenCode().dump("After MIPS32 codegen");
+  P.addRegAlloc();
+  P.addAdvancedPhiLowering();
+  P.addGenFrame();
+  P.add("postLowerLegalization", PA_None, PA_All,
+        [this]() { postLowerLegalization(); })
+      .dump("After postLowerLegalization")
+      .required();
+  P.addNodeLayout();
+  P.addBranchOpt();
+  P.addNopInsertion();
+  P.add("fillDelaySlots", PA_None, PA_All, [this]() { fillDelaySlots(); })
+      .dump("After delay slot filling")
+      .enabledIf(getFlags().getEnableDelaySlotFill());
+  P.run();
 }
 
 void TargetMIPS32::translateOm1() {
@@ -2242,6 +2176,80 @@ void TargetMIPS32::postLowerLegalization() {
   }
 }
 
+namespace {
+// Returns true if Slot cannot execute in Transfer's delay slot, i.e. after
+// Transfer has read its operands. Slot must not define a register Transfer
+// reads, nor touch $ra, which calls write before their delay slot executes.
+bool conflictsWithDelaySlot(const TargetLowering *Target,
+                            const InstMIPS32 *Transfer,
+                            const InstMIPS32 *Slot) {
+  const auto &DestAliases =
+      Target->getAliasesForRegister(Slot->getDest()->getRegNum());
+  if (DestAliases[RegMIPS32::Reg_RA])
+    return true;
+  for (SizeT I = 0; I < Slot->getSrcSize(); ++I) {
+    const auto *Var = llvm::dyn_cast<Variable>(Slot->getSrc(I));
+    if (Var != nullptr && Var->getRegNum() == RegMIPS32::Reg_RA)
+      return true;
+  }
+  for (SizeT I = 0; I < Transfer->getSrcSize(); ++I) {
+    const auto *Var = llvm::dyn_cast<Variable>(Transfer->getSrc(I));
+    if (Var == nullptr)
+      continue;
+    if (!Var->hasReg() || DestAliases[Var->getRegNum()])
+      return true;
+  }
+  return false;
+}
+} // end of anonymous namespace
+
+void TargetMIPS32::fillDelaySlots() {
+  TimerMarker T(TimerStack::TT_fillDelaySlots, Func);
+  // Sandboxing constrains what may share a bundle with a control transfer, so
+  // sandboxed code keeps the nops.
+  const bool CanFill = !NeedSandboxing;
+  for (CfgNode *Node : Func->getNodes()) {
+    // The last instruction emitted before the current one, if it may be moved
+    // into a delay slot.
+    InstMIPS32 *Candidate = nullptr;
+    for (Inst &Instr : Node->getInsts()) {
+      if (Instr.isDeleted() || Instr.isRedundantAssign())
+        continue;
+      // Pseudo-instructions that only carry liveness information emit no code.
+      if (llvm::isa<InstFakeDef>(&Instr) || llvm::isa<InstFakeUse>(&Instr) ||
+          llvm::isa<InstFakeKill>(&Instr))
+        continue;
+      auto *Cur = llvm::dyn_cast<InstMIPS32>(&Instr);
+      if (Cur == nullptr) {
+        Candidate = nullptr;
+        continue;
+      }
+      const bool IsTransfer = llvm::isa<InstMIPS32Br>(Cur) ||
+                              llvm::isa<InstMIPS32Call>(Cur) ||
+                              llvm::isa<InstMIPS32Ret>(Cur);
+      if (!IsTransfer) {
+        Candidate = Cur->canFillDelaySlot() ? Cur : nullptr;
+        continue;
+      }
+      const bool Filled =
+          CanFill && Candidate != nullptr &&
+          !conflictsWithDelaySlot(this, Cur, Candidate);
+      if (Filled) {
+        Cur->setDelaySlotInst(Candidate);
+        Candidate->setDeleted();
+      }
+      Ctx->statsUpdateDelaySlots(Filled);
+      // A conditional branch to two nodes is followed by an unconditional
+      // branch, whose delay slot is never filled.
+      if (auto *Br = llvm::dyn_cast<InstMIPS32Br>(Cur)) {
+        if (!Br->isUnconditionalBranch() && Br->getTargetTrue() != nullptr)
+          Ctx->statsUpdateDelaySlots(false);
+      }
+      Candidate = nullptr;
+    }
+  }
+}
+
 Operand *TargetMIPS32::loOperand(Operand *Operand) {
   assert(Operand->getType() == IceType_i64);
   if (auto *Var64On32 = llvm::dyn_cast<Variable64On32>(Operand))
@@ -5768,11 +5776,20 @@ template <typename T> struct ConstantPoolEmitterTraits;
 static_assert(sizeof(uint64_t) == 8,
               "uint64_t is supposed to be 8 bytes wide.");
 
-// TODO(jaydeep.patil): implement the following when implementing constant
-// randomization:
-//  * template <> struct ConstantPoolEmitterTraits<uint8_t>
-//  * template <> struct ConstantPoolEmitterTraits<uint16_t>
-//  * template <> struct ConstantPoolEmitterTraits<uint32_t>
+// Only i32 immediates are pooled (see TargetMIPS32::shouldBePooled()), so
+// there are no uint8_t or uint16_t traits.
+template <> struct ConstantPoolEmitterTraits<uint32_t> {
+  using ConstantType = ConstantInteger32;
+  static constexpr Type IceType = IceType_i32;
+  static const char AsmTag[];
+  static const char TypeName[];
+  static uint64_t bitcastToUint64(uint32_t Value) {
+    return static_cast<uint64_t>(Value);
+  }
+};
+const char ConstantPoolEmitterTraits<uint32_t>::AsmTag[] = ".word";
+const char ConstantPoolEmitterTraits<uint32_t>::TypeName[] = "i32";
+
 template <> struct ConstantPoolEmitterTraits<float> {
   using ConstantType = ConstantFloat;
   static constexpr Type IceType = IceType_f32;
@@ -5830,9 +5847,16 @@ template <typename T> void emitConstantPool(GlobalContext *Ctx) {
   Str << "\t.section\t.rodata.cst" << Align << ",\"aM\",%progbits," << Align
       << "\n"
       << "\t.align\t" << (Align == 4 ? 2 : 3) << "\n";
-  if (getFlags().getReorderPooledConstants()) {
-    // TODO(jaydeep.patil): add constant pooling.
-    UnimplementedError(getFlags());
+  // If reorder-pooled-constants option is set to true, we need to shuffle the
+  // constant pool before emitting it.
+  if (getFlags().getReorderPooledConstants() && !Pool.empty()) {
+    // Use the constant's kind value as the salt for creating random number
+    // generator.
+    Operand::OperandKind K = (*Pool.begin())->getKind();
+    RandomNumberGenerator RNG(getFlags().getRandomSeed(),
+                              RPE_PooledConstantReordering, K);
+    RandomShuffle(Pool.begin(), Pool.end(),
+                  [&RNG](uint64_t N) { return (uint32_t)RNG.next(N); });
   }
   for (Constant *C : Pool) {
     if (!C->getShouldBePooled()) {
@@ -5846,15 +5870,21 @@ template <typename T> void emitConstantPool(GlobalContext *Ctx) {
 void TargetDataMIPS32::lowerConstants() {
   if (getFlags().getDisableTranslation())
     return;
+  const bool PoolImmediates =
+      getFlags().getRandomizeAndPoolImmediatesOption() == RPI_Pool;
   switch (getFlags().getOutFileType()) {
   case FT_Elf: {
     ELFObjectWriter *Writer = Ctx->getObjectWriter();
+    if (PoolImmediates)
+      Writer->writeConstantPool<ConstantInteger32>(IceType_i32);
     Writer->writeConstantPool<ConstantFloat>(IceType_f32);
     Writer->writeConstantPool<ConstantDouble>(IceType_f64);
   } break;
   case FT_Asm:
   case FT_Iasm: {
     OstreamLocker _(Ctx);
+    if (PoolImmediates)
+      emitConstantPool<uint32_t>(Ctx);
     emitConstantPool<float>(Ctx);
     emitConstantPool<double>(Ctx);
     break;
@@ -5961,7 +5991,16 @@ Operand *TargetMIPS32::legalize(Operand *From, LegalMask Allowed,
       // Use addiu if the immediate is a 16bit value. Otherwise load it
       // using a lui-ori instructions.
       Variable *Reg = makeReg(Ty, RegNum);
-      if (isInt<16>(int32_t(Value))) {
+      if (C32->getShouldBePooled()) {
+        // Load the immediate from the literal pool, like floats below.
+        Ctx->statsUpdateRPImms();
+        Constant *Offset = Ctx->getConstantSym(0, C32->getLabelName());
+        Variable *TReg = makeReg(getPointerType());
+        _lui(TReg, Offset, RO_Hi);
+        OperandMIPS32Mem *Addr =
+            OperandMIPS32Mem::create(Func, Ty, TReg, Offset);
+        Sandboxer(this).lw(Reg, Addr, RO_Lo);
+      } else if (isInt<16>(int32_t(Value))) {
         Variable *Zero = makeReg(Ty, RegMIPS32::Reg_ZERO);
         Context.insert<InstFakeDef>(Zero);
         _addiu(Reg, Zero, Value);
@@ -6138,7 +6177,8 @@ void TargetMIPS32::Sandboxer::addiu_sp(uint32_t StackOffset) {
   Target->_and(SP, SP, T7);
 }
 
-void TargetMIPS32::Sandboxer::lw(Variable *Dest, OperandMIPS32Mem *Mem) {
+void TargetMIPS32::Sandboxer::lw(Variable *Dest, OperandMIPS32Mem *Mem,
+                                 RelocOp Reloc) {
   Variable *Base = Mem->getBase();
   if (Target->NeedSandboxing && (Target->getStackReg() != Base->getRegNum()) &&
       (RegMIPS32::Reg_T8 != Base->getRegNum())) {
@@ -6147,7 +6187,7 @@ void TargetMIPS32::Sandboxer::lw(Variable *Dest, OperandMIPS32Mem *Mem) {
     createAutoBundle();
     Target->_and(Base, Base, T7);
   }
-  Target->_lw(Dest, Mem);
+  Target->_lw(Dest, Mem, Reloc);
   if (Target->NeedSandboxing && (Dest->getRegNum() == Target->getStackReg())) {
     auto *T7 = Target->makeReg(IceType_i32, RegMIPS32::Reg_T7);
     Target->Context.insert<InstFakeDef>(T7);
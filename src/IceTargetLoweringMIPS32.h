@@ -41,7 +41,12 @@ public:
     if (auto *ConstFloat = llvm::dyn_cast<ConstantFloat>(C)) {
       return !Utils::isPositiveZero(ConstFloat->getValue());
     }
-    return false;
+    // Large i32 immediates are only pooled when asked to; otherwise they are
+    // cheaper to build with lui/ori than to load.
+    if (getFlags().getRandomizeAndPoolImmediatesOption() != RPI_Pool) {
+      return false;
+    }
+    return C->getType() == IceType_i32 && C->shouldBeRandomizedOrPooled();
   }
   static ::Ice::Type getPointerType() { return ::Ice::IceType_i32; }
   static std::unique_ptr<::Ice::TargetLowering> create(Cfg *Func) {
@@ -343,8 +348,8 @@ public:
     Context.insert<InstMIPS32Ll>(Value, Mem);
   }
 
-  void _lw(Variable *Value, OperandMIPS32Mem *Mem) {
-    Context.insert<InstMIPS32Lw>(Value, Mem);
+  void _lw(Variable *Value, OperandMIPS32Mem *Mem, RelocOp Reloc = RO_No) {
+    Context.insert<InstMIPS32Lw>(Value, Mem, Reloc);
   }
 
   void _lwc1(Variable *Value, OperandMIPS32Mem *Mem, RelocOp Reloc = RO_No) {
@@ -617,7 +622,7 @@ public:
     ~Sandboxer();
 
     void addiu_sp(uint32_t StackOffset);
-    void lw(Variable *Dest, OperandMIPS32Mem *Mem);
+    void lw(Variable *Dest, OperandMIPS32Mem *Mem, RelocOp Reloc = RO_No);
     void sw(Variable *Dest, OperandMIPS32Mem *Mem);
     void ll(Variable *Dest, OperandMIPS32Mem *Mem);
     void sc(Variable *Dest, OperandMIPS32Mem *Mem);
@@ -701,6 +706,11 @@ public:
 
   void postLowerLegalization();
 
+  // Moves the instruction preceding each branch, call and return into the
+  // transfer's delay slot, when it is independent of the transfer. Slots that
+  // cannot be filled keep their nop.
+  void fillDelaySlots();
+
   void addProlog(CfgNode *Node) override;
   void addEpilog(CfgNode *Node) override;
 
@@ -270,6 +270,15 @@ struct TargetX8632Traits {
     // SSE2 is the PNaCl baseline instruction set.
     SSE2 = Begin,
     SSE4_1,
+    // Each of the following levels implies the ones before it, which matches
+    // the processors that introduced them.
+    POPCNT,
+    // BMI1 also includes LZCNT, which came with it on Intel processors.
+    BMI1,
+    BMI2,
+    // AVX adds the VEX encoded, non-destructive three-operand forms of the
+    // SSE instructions. It sits above BMI2, as on Haswell and later.
+    AVX,
     End
   };
 
@@ -87,8 +87,11 @@ public:
   bool needSandboxing() const { return NeedSandboxing; }
 
   void translateOm1() override;
+  void translateO1() override;
   void translateO2() override;
   void doLoadOpt();
+  /// Runs the post-regalloc peephole patterns over each node's instructions.
+  void peephole();
   bool doBranchOpt(Inst *I, const CfgNode *NextNode) override;
 
   SizeT getNumRegisters() const override {
@@ -292,6 +295,15 @@ protected:
   uint32_t getCallStackArgumentsSizeBytes(const InstCall *Instr) override;
   void genTargetHelperCallFor(Inst *Instr) override;
 
+  /// The peephole() patterns. Each one tries to rewrite the instruction at I,
+  /// which is not deleted, together with the next one, and returns true if it
+  /// changed anything.
+  bool peepholeSelfMove(InstList &Insts, InstList::iterator I);
+  bool peepholeDeadMov(InstList &Insts, InstList::iterator I);
+  bool peepholeCmpZero(InstList &Insts, InstList::iterator I);
+  bool peepholeLeaToAdd(InstList &Insts, InstList::iterator I);
+  bool peepholeSpillReload(InstList &Insts, InstList::iterator I);
+
   /// OptAddr wraps all the possible operands that an x86 address might have.
   struct OptAddr {
     Variable *Base = nullptr;
@@ -329,6 +341,18 @@ protected:
                       Operand *Val);
   void lowerCountZeros(bool Cttz, Type Ty, Variable *Dest, Operand *FirstVal,
                        Operand *SecondVal);
+  void lowerCountZerosBMI(bool Cttz, Type Ty, Variable *Dest,
+                          Operand *FirstVal, Operand *SecondVal);
+  /// Returns true if a shift of type Ty by Src1 should use the BMI2 shlx, shrx,
+  /// or sarx, which take the count in any register, instead of in cl.
+  bool shouldUseShiftx(Type Ty, const Operand *Src1) const {
+    if (InstructionSet < Traits::BMI2)
+      return false;
+    if (Ty != IceType_i32 && !(Traits::Is64Bit && Ty == IceType_i64))
+      return false;
+    return !llvm::isa<ConstantInteger32>(Src1) &&
+           !llvm::isa<ConstantInteger64>(Src1);
+  }
   /// Load from memory for a given type.
   void typedLoad(Type Ty, Variable *Dest, Variable *Base, Constant *Offset);
   /// Store to memory for a given type.
@@ -510,6 +534,30 @@ protected:
     }
   };
 
+  /// Inserts Dest = Src0 op Src1 for the binary XMM instruction InstT. With
+  /// AVX, this is a single VEX encoded instruction that leaves Src0 intact, so
+  /// the register allocator can coalesce Src0's copy. Otherwise, Src0 is copied
+  /// into Dest first, as in the two-address SSE form.
+  template <typename InstT>
+  void _binopXmm(Variable *Dest, Operand *Src0, Operand *Src1) {
+    if (InstructionSet >= Traits::AVX) {
+      Variable *Src0R = legalizeToReg(Src0);
+      if (Src1 == Src0)
+        Src1 = Src0R;
+      AutoMemorySandboxer<> _(this, &Dest, &Src1);
+      Context.insert<InstT>(Dest, Src0R, Src1);
+      return;
+    }
+    if (isVectorType(Dest->getType()))
+      _movp(Dest, Src0);
+    else
+      _mov(Dest, Src0);
+    if (Src1 == Src0)
+      Src1 = Dest;
+    AutoMemorySandboxer<> _(this, &Dest, &Src1);
+    Context.insert<InstT>(Dest, Src1);
+  }
+
   /// The following are helpers that insert lowered x86 instructions with
   /// minimal syntactic overhead, so that the lowering code can look as close to
   /// assembly as practical.
@@ -533,10 +581,16 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Addps>(Dest, Src0);
   }
+  void _addps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Addps>(Dest, Src0, Src1);
+  }
   void _addss(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Addss>(Dest, Src0);
   }
+  void _addss(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Addss>(Dest, Src0, Src1);
+  }
   void _add_sp(Operand *Adjustment) {
     dispatchToConcrete(&Traits::ConcreteTarget::_add_sp, std::move(Adjustment));
   }
@@ -548,10 +602,16 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Andnps>(Dest, Src0);
   }
+  void _andnps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Andnps>(Dest, Src0, Src1);
+  }
   void _andps(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Andps>(Dest, Src0);
   }
+  void _andps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Andps>(Dest, Src0, Src1);
+  }
   void _and_rmw(X86OperandMem *DestSrc0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &DestSrc0, &Src1);
     Context.insert<typename Traits::Insts::AndRMW>(DestSrc0, Src1);
@@ -642,10 +702,16 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Divps>(Dest, Src0);
   }
+  void _divps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Divps>(Dest, Src0, Src1);
+  }
   void _divss(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Divss>(Dest, Src0);
   }
+  void _divss(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Divss>(Dest, Src0, Src1);
+  }
   template <typename T = Traits>
   typename std::enable_if<T::UsesX87, void>::type _fld(Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Src0);
@@ -693,6 +759,10 @@ protected:
     Context.insert<typename Traits::Insts::Lea>(Dest, Src0);
   }
   void _link_bp() { dispatchToConcrete(&Traits::ConcreteTarget::_link_bp); }
+  void _lzcnt(Variable *Dest, Operand *Src0) {
+    AutoMemorySandboxer<> _(this, &Dest, &Src0);
+    Context.insert<typename Traits::Insts::Lzcnt>(Dest, Src0);
+  }
   void _push_reg(Variable *Reg) {
     dispatchToConcrete(&Traits::ConcreteTarget::_push_reg, std::move(Reg));
   }
@@ -731,6 +801,9 @@ protected:
   void _movss(Variable *Dest, Variable *Src0) {
     Context.insert<typename Traits::Insts::MovssRegs>(Dest, Src0);
   }
+  void _movss(Variable *Dest, Operand *Src0, Variable *Src1) {
+    _binopXmm<typename Traits::Insts::MovssRegs>(Dest, Src0, Src1);
+  }
   void _movsx(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Movsx>(Dest, Src0);
@@ -743,18 +816,30 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Maxss>(Dest, Src0);
   }
+  void _maxss(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Maxss>(Dest, Src0, Src1);
+  }
   void _minss(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Minss>(Dest, Src0);
   }
+  void _minss(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Minss>(Dest, Src0, Src1);
+  }
   void _maxps(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Maxps>(Dest, Src0);
   }
+  void _maxps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Maxps>(Dest, Src0, Src1);
+  }
   void _minps(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Minps>(Dest, Src0);
   }
+  void _minps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Minps>(Dest, Src0, Src1);
+  }
   void _mul(Variable *Dest, Variable *Src0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
     Context.insert<typename Traits::Insts::Mul>(Dest, Src0, Src1);
@@ -763,10 +848,16 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Mulps>(Dest, Src0);
   }
+  void _mulps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Mulps>(Dest, Src0, Src1);
+  }
   void _mulss(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Mulss>(Dest, Src0);
   }
+  void _mulss(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Mulss>(Dest, Src0, Src1);
+  }
   void _neg(Variable *SrcDest) {
     AutoMemorySandboxer<> _(this, &SrcDest);
     Context.insert<typename Traits::Insts::Neg>(SrcDest);
@@ -782,6 +873,9 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Orps>(Dest, Src0);
   }
+  void _orps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Orps>(Dest, Src0, Src1);
+  }
   void _or_rmw(X86OperandMem *DestSrc0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &DestSrc0, &Src1);
     Context.insert<typename Traits::Insts::OrRMW>(DestSrc0, Src1);
@@ -790,22 +884,37 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Padd>(Dest, Src0);
   }
+  void _padd(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Padd>(Dest, Src0, Src1);
+  }
   void _padds(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Padds>(Dest, Src0);
   }
+  void _padds(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Padds>(Dest, Src0, Src1);
+  }
   void _paddus(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Paddus>(Dest, Src0);
   }
+  void _paddus(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Paddus>(Dest, Src0, Src1);
+  }
   void _pand(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Pand>(Dest, Src0);
   }
+  void _pand(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Pand>(Dest, Src0, Src1);
+  }
   void _pandn(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Pandn>(Dest, Src0);
   }
+  void _pandn(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Pandn>(Dest, Src0, Src1);
+  }
   void _pblendvb(Variable *Dest, Operand *Src0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
     Context.insert<typename Traits::Insts::Pblendvb>(Dest, Src0, Src1);
@@ -816,10 +925,16 @@ protected:
     Context.insert<typename Traits::Insts::Pcmpeq>(Dest, Src0,
                                                    ArithmeticTypeOverride);
   }
+  void _pcmpeq(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Pcmpeq>(Dest, Src0, Src1);
+  }
   void _pcmpgt(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Pcmpgt>(Dest, Src0);
   }
+  void _pcmpgt(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Pcmpgt>(Dest, Src0, Src1);
+  }
   void _pextr(Variable *Dest, Operand *Src0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
     Context.insert<typename Traits::Insts::Pextr>(Dest, Src0, Src1);
@@ -832,6 +947,9 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Pmull>(Dest, Src0);
   }
+  void _pmull(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Pmull>(Dest, Src0, Src1);
+  }
   void _pmulhw(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Pmulhw>(Dest, Src0);
@@ -848,33 +966,58 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Pmuludq>(Dest, Src0);
   }
+  void _pmuludq(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Pmuludq>(Dest, Src0, Src1);
+  }
   void _pop(Variable *Dest) {
     Context.insert<typename Traits::Insts::Pop>(Dest);
   }
+  void _popcnt(Variable *Dest, Operand *Src0) {
+    AutoMemorySandboxer<> _(this, &Dest, &Src0);
+    Context.insert<typename Traits::Insts::Popcnt>(Dest, Src0);
+  }
   void _por(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Por>(Dest, Src0);
   }
+  void _por(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Por>(Dest, Src0, Src1);
+  }
   void _punpckl(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Punpckl>(Dest, Src0);
   }
+  void _punpckl(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Punpckl>(Dest, Src0, Src1);
+  }
   void _punpckh(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Punpckh>(Dest, Src0);
   }
+  void _punpckh(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Punpckh>(Dest, Src0, Src1);
+  }
   void _packss(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Packss>(Dest, Src0);
   }
+  void _packss(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Packss>(Dest, Src0, Src1);
+  }
   void _packus(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Packus>(Dest, Src0);
   }
+  void _packus(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Packus>(Dest, Src0, Src1);
+  }
   void _pshufb(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Pshufb>(Dest, Src0);
   }
+  void _pshufb(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Pshufb>(Dest, Src0, Src1);
+  }
   void _pshufd(Variable *Dest, Operand *Src0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
     Context.insert<typename Traits::Insts::Pshufd>(Dest, Src0, Src1);
@@ -895,14 +1038,23 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Psub>(Dest, Src0);
   }
+  void _psub(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Psub>(Dest, Src0, Src1);
+  }
   void _psubs(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Psubs>(Dest, Src0);
   }
+  void _psubs(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Psubs>(Dest, Src0, Src1);
+  }
   void _psubus(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Psubus>(Dest, Src0);
   }
+  void _psubus(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Psubus>(Dest, Src0, Src1);
+  }
   void _push(Operand *Src0) {
     Context.insert<typename Traits::Insts::Push>(Src0);
   }
@@ -910,8 +1062,12 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Pxor>(Dest, Src0);
   }
-  void _ret(Variable *Src0 = nullptr) {
-    Context.insert<typename Traits::Insts::Ret>(Src0);
+  void _pxor(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Pxor>(Dest, Src0, Src1);
+  }
+  void _ret(Variable *Src0 = nullptr,
+            const ConstantRelocatable *SiblingCallTarget = nullptr) {
+    Context.insert<typename Traits::Insts::Ret>(Src0, SiblingCallTarget);
   }
   void _rol(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
@@ -929,6 +1085,10 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Sar>(Dest, Src0);
   }
+  void _sarx(Variable *Dest, Operand *Src0, Variable *Src1) {
+    AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
+    Context.insert<typename Traits::Insts::Sarx>(Dest, Src0, Src1);
+  }
   void _sbb(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Sbb>(Dest, Src0);
@@ -948,6 +1108,10 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
     Context.insert<typename Traits::Insts::Shld>(Dest, Src0, Src1);
   }
+  void _shlx(Variable *Dest, Operand *Src0, Variable *Src1) {
+    AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
+    Context.insert<typename Traits::Insts::Shlx>(Dest, Src0, Src1);
+  }
   void _shr(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Shr>(Dest, Src0);
@@ -956,6 +1120,10 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
     Context.insert<typename Traits::Insts::Shrd>(Dest, Src0, Src1);
   }
+  void _shrx(Variable *Dest, Operand *Src0, Variable *Src1) {
+    AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
+    Context.insert<typename Traits::Insts::Shrx>(Dest, Src0, Src1);
+  }
   void _shufps(Variable *Dest, Operand *Src0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0, &Src1);
     Context.insert<typename Traits::Insts::Shufps>(Dest, Src0, Src1);
@@ -999,14 +1167,24 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Subps>(Dest, Src0);
   }
+  void _subps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Subps>(Dest, Src0, Src1);
+  }
   void _subss(Variable *Dest, Operand *Src0) {
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Subss>(Dest, Src0);
   }
+  void _subss(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Subss>(Dest, Src0, Src1);
+  }
   void _test(Operand *Src0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &Src0, &Src1);
     Context.insert<typename Traits::Insts::Test>(Src0, Src1);
   }
+  void _tzcnt(Variable *Dest, Operand *Src0) {
+    AutoMemorySandboxer<> _(this, &Dest, &Src0);
+    Context.insert<typename Traits::Insts::Tzcnt>(Dest, Src0);
+  }
   void _ucomiss(Operand *Src0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &Src0, &Src1);
     Context.insert<typename Traits::Insts::Ucomiss>(Src0, Src1);
@@ -1039,6 +1217,9 @@ protected:
     AutoMemorySandboxer<> _(this, &Dest, &Src0);
     Context.insert<typename Traits::Insts::Xorps>(Dest, Src0);
   }
+  void _xorps(Variable *Dest, Operand *Src0, Operand *Src1) {
+    _binopXmm<typename Traits::Insts::Xorps>(Dest, Src0, Src1);
+  }
   void _xor_rmw(X86OperandMem *DestSrc0, Operand *Src1) {
     AutoMemorySandboxer<> _(this, &DestSrc0, &Src1);
     Context.insert<typename Traits::Insts::XorRMW>(DestSrc0, Src1);
@@ -26,6 +26,7 @@
 #include "IceInstX86Base.h"
 #include "IceLiveness.h"
 #include "IceOperand.h"
+#include "IcePassPipeline.h"
 #include "IcePhiLoweringImpl.h"
 #include "IceUtils.h"
 #include "IceVariableSplitting.h"
@@ -444,155 +445,153 @@ template <typename TraitsType>
 template <typename TraitsType> void TargetX86Base<TraitsType>::translateO2() {
   TimerMarker T(TimerStack::TT_O2, Func);
 
-  if (SandboxingType != ST_None) {
-    initRebasePtr();
-  }
-
-  genTargetHelperCalls();
-  Func->dump("After target helper call insertion");
-
+  PassPipeline P(Func, getFlags().getO2PassOrder());
+  P.add("initRebasePtr", PA_None, PA_None, [this]() { initRebasePtr(); })
+      .enabledIf(SandboxingType != ST_None)
+      .required();
+  P.addSCCP();
+  P.addIfConversion();
+  P.add("genHelpers", PA_None, PA_All, [this]() { genTargetHelperCalls(); })
+      .dump("After target helper call insertion")
+      .required();
   // Merge Alloca instructions, and lay out the stack.
-  static constexpr bool SortAndCombineAllocas = true;
-  Func->processAllocas(SortAndCombineAllocas);
-  Func->dump("After Alloca processing");
-
+  P.add("processAllocas", PA_None, PA_All,
+        [this]() {
+          static constexpr bool SortAndCombineAllocas = true;
+          Func->processAllocas(SortAndCombineAllocas);
+        })
+      .dump("After Alloca processing")
+      .required();
   // Run this early so it can be used to focus optimizations on potentially hot
   // code.
   // TODO(stichnot,ascull): currently only used for regalloc not
   // expensive high level optimizations which could be focused on potentially
   // hot code.
-  Func->generateLoopInfo();
-  Func->dump("After loop analysis");
-  if (getFlags().getLoopInvariantCodeMotion()) {
-    Func->loopInvariantCodeMotion();
-    Func->dump("After LICM");
-  }
+  P.add("loopInfo", PA_None, PA_None, [this]() { Func->generateLoopInfo(); })
+      .dump("After loop analysis");
+  P.add("licm", PA_None, PA_All,
+        [this]() { Func->loopInvariantCodeMotion(); })
+      .dump("After LICM")
+      .enabledIf(getFlags().getLoopInvariantCodeMotion());
+  P.add("localCSE", PA_None, PA_All,
+        [this]() {
+          Func->localCSE(getFlags().getLocalCSE() == Ice::LCSE_EnabledSSA);
+          Func->dump("After Local CSE");
+          Func->floatConstantCSE();
+        })
+      .enabledIf(getFlags().getLocalCSE() != Ice::LCSE_Disabled);
+  P.add("shortCircuit", PA_None, PA_All,
+        [this]() { Func->shortCircuitJumps(); })
+      .dump("After Short Circuiting")
+      .enabledIf(getFlags().getEnableShortCircuit());
+  P.addRedundantLoadElim();
+  P.addPhiLowering();
+  P.addAddressOpt();
+  P.add("vectorShuffles", PA_None, PA_All,
+        [this]() { Func->materializeVectorShuffles(); });
+  // Find read-modify-write opportunities. Do this after address mode
+  // optimization so that doAddressOpt() doesn't need to be applied to RMW
+  // instructions as well.
+  P.add("findRMW", PA_None, PA_All, [this]() { findRMW(); })
+      .dump("After RMW transform");
+  P.addArgLowering();
+  // Load optimization only fuses a load into its last use, which keeps the
+  // liveness information good enough for genCode().
+  P.add("loadOpt", PA_LivenessBasic, PA_None, [this]() {
+    // Disable constant blinding or pooling for load optimization.
+    BoolFlagSaver B(RandomizationPoolingPaused, true);
+    doLoadOpt();
+  });
+  P.addGenCode();
+  P.add("initSandbox", PA_None, PA_All, [this]() { initSandbox(); })
+      .enabledIf(SandboxingType != ST_None)
+      .required();
+  P.add("splitLocalVars", PA_None, PA_AllButNumbering,
+        [this]() { splitBlockLocalVariables(Func); })
+      .dump("After x86 codegen");
+  P.addRegAlloc();
+  P.addAdvancedPhiLowering();
+  P.addGenFrame();
+  P.addNodeLayout();
+  // Shuffle basic block order if -reorder-basic-blocks is enabled.
+  P.add("shuffleNodes", PA_None, PA_All, [this]() { Func->shuffleNodes(); })
+      .enabledIf(getFlags().getReorderBasicBlocks());
+  P.add("peephole", PA_None, PA_All, [this]() { peephole(); })
+      .enabledIf(getFlags().getX86Peephole());
+  P.addBranchOpt();
+  P.addNopInsertion();
+  // Mark nodes that require sandbox alignment
+  P.add("markNodesForSandboxing", PA_None, PA_None,
+        [this]() { Func->markNodesForSandboxing(); })
+      .enabledIf(NeedSandboxing)
+      .required();
+  P.run();
+}
 
-  if (getFlags().getLocalCSE() != Ice::LCSE_Disabled) {
-    Func->localCSE(getFlags().getLocalCSE() == Ice::LCSE_EnabledSSA);
-    Func->dump("After Local CSE");
-    Func->floatConstantCSE();
-  }
-  if (getFlags().getEnableShortCircuit()) {
-    Func->shortCircuitJumps();
-    Func->dump("After Short Circuiting");
-  }
+template <typename TraitsType> void TargetX86Base<TraitsType>::translateOm1() {
+  TimerMarker T(TimerStack::TT_Om1, Func);
 
-  if (!getFlags().getEnablePhiEdgeSplit()) {
-    // Lower Phi instructions.
-    Func->placePhiLoads();
-    if (Func->hasError())
-      return;
-    Func->placePhiStores();
-    if (Func->hasError())
-      return;
-    Func->deletePhis();
-    if (Func->hasError())
-      return;
-    Func->dump("After Phi lowering");
+  if (SandboxingType != ST_None) {
+    initRebasePtr();
   }
 
-  // Address mode optimization.
-  Func->getVMetadata()->init(VMK_SingleDefs);
-  Func->doAddressOpt();
-  Func->materializeVectorShuffles();
-
-  // Find read-modify-write opportunities. Do this after address mode
-  // optimization so that doAddressOpt() doesn't need to be applied to RMW
-  // instructions as well.
-  findRMW();
-  Func->dump("After RMW transform");
+  genTargetHelperCalls();
 
-  // Argument lowering
-  Func->doArgLowering();
+  // Do not merge Alloca instructions, and lay out the stack.
+  static constexpr bool SortAndCombineAllocas = false;
+  Func->processAllocas(SortAndCombineAllocas);
+  Func->dump("After Alloca processing");
 
-  // Target lowering. This requires liveness analysis for some parts of the
-  // lowering decisions, such as compare/branch fusing. If non-lightweight
-  // liveness analysis is used, the instructions need to be renumbered first
-  // TODO: This renumbering should only be necessary if we're actually
-  // calculating live intervals, which we only do for register allocation.
-  Func->renumberInstructions();
+  Func->placePhiLoads();
   if (Func->hasError())
     return;
-
-  // TODO: It should be sufficient to use the fastest liveness calculation,
-  // i.e. livenessLightweight(). However, for some reason that slows down the
-  // rest of the translation. Investigate.
-  Func->liveness(Liveness_Basic);
+  Func->placePhiStores();
+  if (Func->hasError())
+    return;
+  Func->deletePhis();
   if (Func->hasError())
     return;
-  Func->dump("After x86 address mode opt");
+  Func->dump("After Phi lowering");
 
-  // Disable constant blinding or pooling for load optimization.
-  {
-    BoolFlagSaver B(RandomizationPoolingPaused, true);
-    doLoadOpt();
-  }
+  Func->doArgLowering();
   Func->genCode();
   if (Func->hasError())
     return;
   if (SandboxingType != ST_None) {
     initSandbox();
   }
-  Func->dump("After x86 codegen");
-  splitBlockLocalVariables(Func);
-
-  // Register allocation. This requires instruction renumbering and full
-  // liveness analysis. Loops must be identified before liveness so variable
-  // use weights are correct.
-  Func->renumberInstructions();
-  if (Func->hasError())
-    return;
-  Func->liveness(Liveness_Intervals);
-  if (Func->hasError())
-    return;
-  // The post-codegen dump is done here, after liveness analysis and associated
-  // cleanup, to make the dump cleaner and more useful.
   Func->dump("After initial x86 codegen");
-  // Validate the live range computations. The expensive validation call is
-  // deliberately only made when assertions are enabled.
-  assert(Func->validateLiveness());
-  Func->getVMetadata()->init(VMK_All);
-  regAlloc(RAK_Global);
+
+  regAlloc(RAK_InfOnly);
   if (Func->hasError())
     return;
-  Func->dump("After linear scan regalloc");
-
-  if (getFlags().getEnablePhiEdgeSplit()) {
-    Func->advancedPhiLowering();
-    Func->dump("After advanced Phi lowering");
-  }
+  Func->dump("After regalloc of infinite-weight variables");
 
-  // Stack frame mapping.
   Func->genFrame();
   if (Func->hasError())
     return;
   Func->dump("After stack frame mapping");
 
-  Func->contractEmptyNodes();
-  Func->reorderNodes();
+  if (getFlags().getX86Peephole())
+    peephole();
 
   // Shuffle basic block order if -reorder-basic-blocks is enabled.
   Func->shuffleNodes();
 
-  // Branch optimization.  This needs to be done just before code emission. In
-  // particular, no transformations that insert or reorder CfgNodes should be
-  // done after branch optimization. We go ahead and do it before nop insertion
-  // to reduce the amount of work needed for searching for opportunities.
-  Func->doBranchOpt();
-  Func->dump("After branch optimization");
-
   // Nop insertion if -nop-insertion is enabled.
   Func->doNopInsertion();
 
   // Mark nodes that require sandbox alignment
-  if (NeedSandboxing) {
+  if (NeedSandboxing)
     Func->markNodesForSandboxing();
-  }
 }
 
-template <typename TraitsType> void TargetX86Base<TraitsType>::translateOm1() {
-  TimerMarker T(TimerStack::TT_Om1, Func);
+// -O1 is a fast tier between -Om1 and -O2. It lowers like -O2, but without
+// global liveness analysis: only the Variables whose references are all in one
+// basic block get registers, and the ones that are live across blocks stay on
+// the stack, as in -Om1.
+template <typename TraitsType> void TargetX86Base<TraitsType>::translateO1() {
+  TimerMarker T(TimerStack::TT_O1, Func);
 
   if (SandboxingType != ST_None) {
     initRebasePtr();
@@ -600,8 +599,7 @@ template <typename TraitsType> void TargetX86Base<TraitsType>::translateOm1() {
 
   genTargetHelperCalls();
 
-  // Do not merge Alloca instructions, and lay out the stack.
-  static constexpr bool SortAndCombineAllocas = false;
+  static constexpr bool SortAndCombineAllocas = true;
   Func->processAllocas(SortAndCombineAllocas);
   Func->dump("After Alloca processing");
 
@@ -625,10 +623,13 @@ template <typename TraitsType> void TargetX86Base<TraitsType>::translateOm1() {
   }
   Func->dump("After initial x86 codegen");
 
-  regAlloc(RAK_InfOnly);
+  // Find the block-local Variables, and their use weights for choosing which
+  // ones to spill when registers run out.
+  Func->getVMetadata()->init(VMK_Uses);
+  regAlloc(RAK_BlockLocal);
   if (Func->hasError())
     return;
-  Func->dump("After regalloc of infinite-weight variables");
+  Func->dump("After block-local regalloc");
 
   Func->genFrame();
   if (Func->hasError())
@@ -638,6 +639,12 @@ template <typename TraitsType> void TargetX86Base<TraitsType>::translateOm1() {
   // Shuffle basic block order if -reorder-basic-blocks is enabled.
   Func->shuffleNodes();
 
+  if (getFlags().getX86Peephole())
+    peephole();
+
+  Func->doBranchOpt();
+  Func->dump("After branch optimization");
+
   // Nop insertion if -nop-insertion is enabled.
   Func->doNopInsertion();
 
@@ -911,6 +918,214 @@ bool TargetX86Base<TraitsType>::doBranchOpt(Inst *I, const CfgNode *NextNode) {
   return false;
 }
 
+// The peephole patterns only match adjacent instructions, skipping deleted
+// ones, and never look across a node boundary.
+inline InstList::iterator nextLiveInst(InstList &Insts, InstList::iterator I) {
+  for (++I; I != Insts.end() && I->isDeleted(); ++I)
+    ;
+  return I;
+}
+
+template <typename TraitsType> void TargetX86Base<TraitsType>::peephole() {
+  // The patterns delete instructions that carry last-use bits, or replace them
+  // with new ones that carry none, which would break the live range
+  // bookkeeping in CfgNode::emit() for -asm-verbose.
+  if (getFlags().getDecorateAsm())
+    return;
+  TimerMarker T(TimerStack::TT_peephole, Func);
+  using PatternFn = bool (TargetX86Base::*)(InstList &, InstList::iterator);
+  struct Pattern {
+    GlobalContext::PeepholeX86Kind Kind;
+    PatternFn Apply;
+  };
+  static const Pattern Patterns[] = {
+      {GlobalContext::PK_PeepholeSelfMove, &TargetX86Base::peepholeSelfMove},
+      {GlobalContext::PK_PeepholeDeadMov, &TargetX86Base::peepholeDeadMov},
+      {GlobalContext::PK_PeepholeCmpZero, &TargetX86Base::peepholeCmpZero},
+      {GlobalContext::PK_PeepholeLeaToAdd, &TargetX86Base::peepholeLeaToAdd},
+      {GlobalContext::PK_PeepholeSpillReload,
+       &TargetX86Base::peepholeSpillReload},
+  };
+  for (CfgNode *Node : Func->getNodes()) {
+    InstList &Insts = Node->getInsts();
+    for (auto I = Insts.begin(), E = Insts.end(); I != E; ++I) {
+      if (I->isDeleted())
+        continue;
+      for (const Pattern &P : Patterns) {
+        if ((this->*P.Apply)(Insts, I)) {
+          Ctx->statsUpdatePeepholeX86(P.Kind);
+          break;
+        }
+      }
+    }
+  }
+  Func->dump("After x86 peephole optimization");
+}
+
+// mov eax, eax ==> (deleted)
+//
+// Emission already skips these, but deleting them lets the other patterns see
+// through them.
+template <typename TraitsType>
+bool TargetX86Base<TraitsType>::peepholeSelfMove(InstList &,
+                                                 InstList::iterator I) {
+  if (!llvm::isa<typename Traits::Insts::Mov>(*I) || !I->isRedundantAssign())
+    return false;
+  I->setDeleted();
+  return true;
+}
+
+// mov eax, ecx
+// mov eax, 1 ==> mov eax, 1
+//
+// The first mov is dead when the second one overwrites the whole register
+// without reading it. Loads are left alone, since they may fault.
+template <typename TraitsType>
+bool TargetX86Base<TraitsType>::peepholeDeadMov(InstList &Insts,
+                                                InstList::iterator I) {
+  if (!llvm::isa<typename Traits::Insts::Mov>(*I))
+    return false;
+  Variable *Dest = I->getDest();
+  if (!Dest->hasReg() || !isScalarIntegerType(Dest->getType()))
+    return false;
+  Operand *Src = I->getSrc(0);
+  if (auto *SrcVar = llvm::dyn_cast<Variable>(Src)) {
+    if (!SrcVar->hasReg())
+      return false;
+  } else if (!llvm::isa<Constant>(Src)) {
+    return false;
+  }
+  auto Next = nextLiveInst(Insts, I);
+  if (Next == Insts.end() || !llvm::isa<typename Traits::Insts::Mov>(*Next))
+    return false;
+  Variable *NextDest = Next->getDest();
+  if (!NextDest->hasReg() || NextDest->getRegNum() != Dest->getRegNum() ||
+      NextDest->getType() != Dest->getType())
+    return false;
+  const auto BaseReg = Traits::getBaseReg(Dest->getRegNum());
+  FOREACH_VAR_IN_INST(Var, *Next) {
+    if (Var->hasReg() && Traits::getBaseReg(Var->getRegNum()) == BaseReg)
+      return false;
+  }
+  I->setDeleted();
+  return true;
+}
+
+// cmp eax, 0 ==> test eax, eax
+//
+// Both leave CF and OF clear and set ZF and SF from eax, and test has the
+// shorter encoding.
+template <typename TraitsType>
+bool TargetX86Base<TraitsType>::peepholeCmpZero(InstList &Insts,
+                                                InstList::iterator I) {
+  if (!llvm::isa<typename Traits::Insts::Icmp>(*I))
+    return false;
+  auto *Src0 = llvm::dyn_cast<Variable>(I->getSrc(0));
+  if (Src0 == nullptr || !Src0->hasReg())
+    return false;
+  Operand *Src1 = I->getSrc(1);
+  if (auto *C32 = llvm::dyn_cast<ConstantInteger32>(Src1)) {
+    if (C32->getValue() != 0)
+      return false;
+  } else if (auto *C64 = llvm::dyn_cast<ConstantInteger64>(Src1)) {
+    if (C64->getValue() != 0)
+      return false;
+  } else {
+    return false;
+  }
+  Insts.insert(I, Traits::Insts::Test::create(Func, Src0, Src0));
+  I->setDeleted();
+  return true;
+}
+
+// lea eax, [eax+4] ==> add eax, 4
+//
+// Unlike lea, add writes the flags, so this is only done when no later
+// instruction in the node reads them before they are written again.
+template <typename TraitsType>
+bool TargetX86Base<TraitsType>::peepholeLeaToAdd(InstList &Insts,
+                                                 InstList::iterator I) {
+  if (!llvm::isa<typename Traits::Insts::Lea>(*I))
+    return false;
+  Variable *Dest = I->getDest();
+  if (Dest->getType() != IceType_i32 || !Dest->hasReg())
+    return false;
+  auto *Mem = llvm::dyn_cast<X86OperandMem>(I->getSrc(0));
+  if (Mem == nullptr || Mem->getIndex() != nullptr ||
+      Mem->getSegmentRegister() != X86OperandMem::DefaultSegment ||
+      Mem->getIsRebased())
+    return false;
+  Variable *Base = Mem->getBase();
+  if (Base == nullptr || !Base->hasReg() ||
+      Base->getRegNum() != Dest->getRegNum() || Base->getType() != IceType_i32)
+    return false;
+  auto *Offset = llvm::dyn_cast_or_null<ConstantInteger32>(Mem->getOffset());
+  if (Offset == nullptr)
+    return false;
+  for (auto J = nextLiveInst(Insts, I); J != Insts.end();
+       J = nextLiveInst(Insts, J)) {
+    const Inst *Instr = iteratorToInst(J);
+    // These write the flags without reading them.
+    if (llvm::isa<typename Traits::Insts::Icmp>(Instr) ||
+        llvm::isa<typename Traits::Insts::Test>(Instr) ||
+        llvm::isa<typename Traits::Insts::Ucomiss>(Instr) ||
+        llvm::isa<typename Traits::Insts::Add>(Instr) ||
+        llvm::isa<typename Traits::Insts::Sub>(Instr) ||
+        llvm::isa<typename Traits::Insts::And>(Instr) ||
+        llvm::isa<typename Traits::Insts::Or>(Instr) ||
+        llvm::isa<typename Traits::Insts::Xor>(Instr))
+      break;
+    // These neither read nor write the flags.
+    if (llvm::isa<typename Traits::Insts::Mov>(Instr) ||
+        llvm::isa<typename Traits::Insts::Movp>(Instr) ||
+        llvm::isa<typename Traits::Insts::Lea>(Instr) ||
+        llvm::isa<typename Traits::Insts::Store>(Instr) ||
+        llvm::isa<InstFakeDef>(Instr) || llvm::isa<InstFakeUse>(Instr) ||
+        llvm::isa<InstFakeKill>(Instr))
+      continue;
+    // The flags are not live across nodes, so a node-ending jump is fine.
+    if (llvm::isa<typename Traits::Insts::Ret>(Instr) ||
+        llvm::isa<typename Traits::Insts::Jmp>(Instr))
+      break;
+    if (auto *Br = llvm::dyn_cast<InstX86Br>(Instr)) {
+      if (Br->isUnconditionalBranch())
+        break;
+    }
+    return false;
+  }
+  Insts.insert(I, Traits::Insts::Add::create(Func, Dest, Offset));
+  I->setDeleted();
+  return true;
+}
+
+// mov [esp+8], eax
+// mov ecx, [esp+8] ==> mov [esp+8], eax
+//                      mov ecx, eax
+//
+// The reload is deleted instead when it targets the register that was stored.
+template <typename TraitsType>
+bool TargetX86Base<TraitsType>::peepholeSpillReload(InstList &Insts,
+                                                    InstList::iterator I) {
+  if (!llvm::isa<typename Traits::Insts::Mov>(*I))
+    return false;
+  Variable *Slot = I->getDest();
+  auto *Stored = llvm::dyn_cast<Variable>(I->getSrc(0));
+  if (Slot->hasReg() || Stored == nullptr || !Stored->hasReg() ||
+      Stored->getType() != Slot->getType())
+    return false;
+  auto Next = nextLiveInst(Insts, I);
+  if (Next == Insts.end() || !llvm::isa<typename Traits::Insts::Mov>(*Next) ||
+      Next->getSrc(0) != Slot)
+    return false;
+  Variable *Reload = Next->getDest();
+  if (!Reload->hasReg() || Reload->getType() != Slot->getType())
+    return false;
+  if (Reload->getRegNum() != Stored->getRegNum())
+    Insts.insert(Next, Traits::Insts::Mov::create(Func, Reload, Stored));
+  Next->setDeleted();
+  return true;
+}
+
 template <typename TraitsType>
 Variable *TargetX86Base<TraitsType>::getPhysicalRegister(RegNumT RegNum,
                                                          Type Ty) {
@@ -2083,32 +2298,27 @@ void TargetX86Base<TraitsType>::lowerArithmetic(const InstArithmetic *Instr) {
       break;
     case InstArithmetic::Add: {
       Variable *T = makeReg(Ty);
-      _movp(T, Src0);
-      _padd(T, Src1);
+      _padd(T, Src0, Src1);
       _movp(Dest, T);
     } break;
     case InstArithmetic::And: {
       Variable *T = makeReg(Ty);
-      _movp(T, Src0);
-      _pand(T, Src1);
+      _pand(T, Src0, Src1);
       _movp(Dest, T);
     } break;
     case InstArithmetic::Or: {
       Variable *T = makeReg(Ty);
-      _movp(T, Src0);
-      _por(T, Src1);
+      _por(T, Src0, Src1);
       _movp(Dest, T);
     } break;
     case InstArithmetic::Xor: {
       Variable *T = makeReg(Ty);
-      _movp(T, Src0);
-      _pxor(T, Src1);
+      _pxor(T, Src0, Src1);
       _movp(Dest, T);
     } break;
     case InstArithmetic::Sub: {
       Variable *T = makeReg(Ty);
-      _movp(T, Src0);
-      _psub(T, Src1);
+      _psub(T, Src0, Src1);
       _movp(Dest, T);
     } break;
     case InstArithmetic::Mul: {
@@ -2117,8 +2327,7 @@ void TargetX86Base<TraitsType>::lowerArithmetic(const InstArithmetic *Instr) {
           Ty == IceType_v8i16 || InstructionSet >= Traits::SSE4_1;
       if (TypesAreValidForPmull && InstructionSetIsValidForPmull) {
         Variable *T = makeReg(Ty);
-        _movp(T, Src0);
-        _pmull(T, Src0 == Src1 ? T : Src1);
+        _pmull(T, Src0, Src1);
         _movp(Dest, T);
       } else if (Ty == IceType_v4i32) {
         // Lowering sequence:
@@ -2193,26 +2402,22 @@ void TargetX86Base<TraitsType>::lowerArithmetic(const InstArithmetic *Instr) {
       break;
     case InstArithmetic::Fadd: {
       Variable *T = makeReg(Ty);
-      _movp(T, Src0);
-      _addps(T, Src1);
+      _addps(T, Src0, Src1);
       _movp(Dest, T);
     } break;
     case InstArithmetic::Fsub: {
       Variable *T = makeReg(Ty);
-      _movp(T, Src0);
-      _subps(T, Src1);
+      _subps(T, Src0, Src1);
       _movp(Dest, T);
     } break;
     case InstArithmetic::Fmul: {
       Variable *T = makeReg(Ty);
-      _movp(T, Src0);
-      _mulps(T, Src0 == Src1 ? T : Src1);
+      _mulps(T, Src0, Src1);
       _movp(Dest, T);
     } break;
     case InstArithmetic::Fdiv: {
       Variable *T = makeReg(Ty);
-      _movp(T, Src0);
-      _divps(T, Src1);
+      _divps(T, Src0, Src1);
       _movp(Dest, T);
     } break;
     case InstArithmetic::Frem:
@@ -2292,6 +2497,12 @@ void TargetX86Base<TraitsType>::lowerArithmetic(const InstArithmetic *Instr) {
     }
     break;
   case InstArithmetic::Shl:
+    if (shouldUseShiftx(Ty, Src1)) {
+      T = makeReg(Ty);
+      _shlx(T, legalize(Src0, Legal_Reg | Legal_Mem), legalizeToReg(Src1));
+      _mov(Dest, T);
+      break;
+    }
     _mov(T, Src0);
     if (!llvm::isa<ConstantInteger32>(Src1) &&
         !llvm::isa<ConstantInteger64>(Src1))
@@ -2300,6 +2511,12 @@ void TargetX86Base<TraitsType>::lowerArithmetic(const InstArithmetic *Instr) {
     _mov(Dest, T);
     break;
   case InstArithmetic::Lshr:
+    if (shouldUseShiftx(Ty, Src1)) {
+      T = makeReg(Ty);
+      _shrx(T, legalize(Src0, Legal_Reg | Legal_Mem), legalizeToReg(Src1));
+      _mov(Dest, T);
+      break;
+    }
     _mov(T, Src0);
     if (!llvm::isa<ConstantInteger32>(Src1) &&
         !llvm::isa<ConstantInteger64>(Src1))
@@ -2308,6 +2525,12 @@ void TargetX86Base<TraitsType>::lowerArithmetic(const InstArithmetic *Instr) {
     _mov(Dest, T);
     break;
   case InstArithmetic::Ashr:
+    if (shouldUseShiftx(Ty, Src1)) {
+      T = makeReg(Ty);
+      _sarx(T, legalize(Src0, Legal_Reg | Legal_Mem), legalizeToReg(Src1));
+      _mov(Dest, T);
+      break;
+    }
     _mov(T, Src0);
     if (!llvm::isa<ConstantInteger32>(Src1) &&
         !llvm::isa<ConstantInteger64>(Src1))
@@ -2527,23 +2750,19 @@ void TargetX86Base<TraitsType>::lowerArithmetic(const InstArithmetic *Instr) {
     _mov(Dest, T_edx);
   } break;
   case InstArithmetic::Fadd:
-    _mov(T, Src0);
-    _addss(T, Src1);
+    _addss(T, Src0, Src1);
     _mov(Dest, T);
     break;
   case InstArithmetic::Fsub:
-    _mov(T, Src0);
-    _subss(T, Src1);
+    _subss(T, Src0, Src1);
     _mov(Dest, T);
     break;
   case InstArithmetic::Fmul:
-    _mov(T, Src0);
-    _mulss(T, Src0 == Src1 ? T : Src1);
+    _mulss(T, Src0, Src1);
     _mov(Dest, T);
     break;
   case InstArithmetic::Fdiv:
-    _mov(T, Src0);
-    _divss(T, Src1);
+    _divss(T, Src0, Src1);
     _mov(Dest, T);
     break;
   case InstArithmetic::Frem:
@@ -2705,6 +2924,18 @@ void TargetX86Base<TraitsType>::lowerCall(const InstCall *Instr) {
   for (auto &ArgPair : GprArgs) {
     Context.insert<InstFakeUse>(llvm::cast<Variable>(ArgPair.second));
   }
+  // A tail call whose arguments are all in registers can reuse the caller's
+  // return address: fold the following ret into a jmp to the callee, which is
+  // emitted after the epilog. The argument registers are all caller-save, so
+  // the epilog's pops can't clobber them.
+  if (StackArgs.empty() && isSiblingCallCandidate(Instr)) {
+    Context.getNextInst()->setDeleted();
+    Context.advanceNext();
+    Context.getNode()->setHasReturn();
+    _ret(nullptr, llvm::cast<ConstantRelocatable>(Instr->getCallTarget()));
+    keepEspLiveAtExit();
+    return;
+  }
   // Generate the call instruction. Assign its result to a temporary with high
   // register allocation weight.
   // ReturnReg doubles as ReturnRegLo as necessary.
@@ -2834,8 +3065,7 @@ void TargetX86Base<TraitsType>::lowerCast(const InstCast *Instr) {
         // onemask = materialize(1,1,...); dst = (src & onemask) > 0
         Variable *OneMask = makeVectorOfOnes(DestTy);
         Variable *T = makeReg(DestTy);
-        _movp(T, Src0RM);
-        _pand(T, OneMask);
+        _pand(T, Src0RM, OneMask);
         Variable *Zeros = makeVectorOfZeros(DestTy);
         _pcmpgt(T, Zeros);
         _movp(Dest, T);
@@ -2905,8 +3135,7 @@ void TargetX86Base<TraitsType>::lowerCast(const InstCast *Instr) {
       // onemask = materialize(1,1,...); dest = onemask & src
       Variable *OneMask = makeVectorOfOnes(DestTy);
       Variable *T = makeReg(DestTy);
-      _movp(T, Src0RM);
-      _pand(T, OneMask);
+      _pand(T, Src0RM, OneMask);
       _movp(Dest, T);
     } else if (!Traits::Is64Bit && DestTy == IceType_i64) {
       // t1=movzx src; dst.lo=t1; dst.hi=0
@@ -2951,8 +3180,7 @@ void TargetX86Base<TraitsType>::lowerCast(const InstCast *Instr) {
       Type Src0Ty = Src0RM->getType();
       Variable *OneMask = makeVectorOfOnes(Src0Ty);
       Variable *T = makeReg(DestTy);
-      _movp(T, Src0RM);
-      _pand(T, OneMask);
+      _pand(T, Src0RM, OneMask);
       _movp(Dest, T);
     } else if (DestTy == IceType_i1 || DestTy == IceType_i8) {
       // Make sure we truncate from and into valid registers.
@@ -3599,10 +3827,8 @@ void TargetX86Base<TraitsType>::lowerIcmpVector(const InstIcmp *Icmp) {
     Variable *T0 = makeReg(Ty);
     Variable *T1 = makeReg(Ty);
     Variable *HighOrderBits = makeVectorOfHighOrderBits(Ty);
-    _movp(T0, Src0RM);
-    _pxor(T0, HighOrderBits);
-    _movp(T1, Src1RM);
-    _pxor(T1, HighOrderBits);
+    _pxor(T0, Src0RM, HighOrderBits);
+    _pxor(T1, Src1RM, HighOrderBits);
     Src0RM = T0;
     Src1RM = T1;
   }
@@ -3615,14 +3841,12 @@ void TargetX86Base<TraitsType>::lowerIcmpVector(const InstIcmp *Icmp) {
   case InstIcmp::Eq: {
     if (llvm::isa<X86OperandMem>(Src1RM))
       Src1RM = legalizeToReg(Src1RM);
-    _movp(T, Src0RM);
-    _pcmpeq(T, Src1RM);
+    _pcmpeq(T, Src0RM, Src1RM);
   } break;
   case InstIcmp::Ne: {
     if (llvm::isa<X86OperandMem>(Src1RM))
       Src1RM = legalizeToReg(Src1RM);
-    _movp(T, Src0RM);
-    _pcmpeq(T, Src1RM);
+    _pcmpeq(T, Src0RM, Src1RM);
     Variable *MinusOne = makeVectorOfMinusOnes(Ty);
     _pxor(T, MinusOne);
   } break;
@@ -3630,16 +3854,14 @@ void TargetX86Base<TraitsType>::lowerIcmpVector(const InstIcmp *Icmp) {
   case InstIcmp::Sgt: {
     if (llvm::isa<X86OperandMem>(Src1RM))
       Src1RM = legalizeToReg(Src1RM);
-    _movp(T, Src0RM);
-    _pcmpgt(T, Src1RM);
+    _pcmpgt(T, Src0RM, Src1RM);
   } break;
   case InstIcmp::Uge:
   case InstIcmp::Sge: {
     // !(Src1RM > Src0RM)
     if (llvm::isa<X86OperandMem>(Src0RM))
       Src0RM = legalizeToReg(Src0RM);
-    _movp(T, Src1RM);
-    _pcmpgt(T, Src0RM);
+    _pcmpgt(T, Src1RM, Src0RM);
     Variable *MinusOne = makeVectorOfMinusOnes(Ty);
     _pxor(T, MinusOne);
   } break;
@@ -3647,16 +3869,14 @@ void TargetX86Base<TraitsType>::lowerIcmpVector(const InstIcmp *Icmp) {
   case InstIcmp::Slt: {
     if (llvm::isa<X86OperandMem>(Src0RM))
       Src0RM = legalizeToReg(Src0RM);
-    _movp(T, Src1RM);
-    _pcmpgt(T, Src0RM);
+    _pcmpgt(T, Src1RM, Src0RM);
   } break;
   case InstIcmp::Ule:
   case InstIcmp::Sle: {
     // !(Src0RM > Src1RM)
     if (llvm::isa<X86OperandMem>(Src1RM))
       Src1RM = legalizeToReg(Src1RM);
-    _movp(T, Src0RM);
-    _pcmpgt(T, Src1RM);
+    _pcmpgt(T, Src0RM, Src1RM);
     Variable *MinusOne = makeVectorOfMinusOnes(Ty);
     _pxor(T, MinusOne);
   } break;
@@ -3973,8 +4193,7 @@ void TargetX86Base<TraitsType>::lowerInsertElement(
 
     if (Index == 0) {
       Variable *T = makeReg(Ty);
-      _movp(T, SourceVectRM);
-      _movss(T, ElementR);
+      _movss(T, SourceVectRM, ElementR);
       _movp(Instr->getDest(), T);
       return;
     }
@@ -4218,6 +4437,27 @@ void TargetX86Base<TraitsType>::lowerIntrinsicCall(
     Type ValTy = Val->getType();
     assert(ValTy == IceType_i32 || ValTy == IceType_i64);
 
+    if (InstructionSet >= Traits::POPCNT) {
+      if (!Traits::Is64Bit && ValTy == IceType_i64) {
+        // Add up the counts of the two halves.
+        Val = legalize(Val);
+        Variable *T_Lo = makeReg(IceType_i32);
+        Variable *T_Hi = makeReg(IceType_i32);
+        _popcnt(T_Lo, legalize(loOperand(Val), Legal_Reg | Legal_Mem));
+        _popcnt(T_Hi, legalize(hiOperand(Val), Legal_Reg | Legal_Mem));
+        _add(T_Lo, T_Hi);
+        auto *DestLo = llvm::cast<Variable>(loOperand(Dest));
+        auto *DestHi = llvm::cast<Variable>(hiOperand(Dest));
+        _mov(DestLo, T_Lo);
+        _mov(DestHi, Ctx->getConstantZero(IceType_i32));
+        return;
+      }
+      T = makeReg(ValTy);
+      _popcnt(T, legalize(Val, Legal_Reg | Legal_Mem));
+      _mov(Dest, T);
+      return;
+    }
+
     if (!Traits::Is64Bit) {
       T = Dest;
     } else {
@@ -4465,8 +4705,7 @@ void TargetX86Base<TraitsType>::lowerIntrinsicCall(
     auto *T = makeReg(Src0->getType());
     auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
     auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-    _movp(T, Src0RM);
-    _packss(T, Src1RM);
+    _packss(T, Src0RM, Src1RM);
     _movp(Dest, T);
     return;
   }
@@ -4477,8 +4716,7 @@ void TargetX86Base<TraitsType>::lowerIntrinsicCall(
     auto *T = makeReg(Src0->getType());
     auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
     auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-    _movp(T, Src0RM);
-    _packus(T, Src1RM);
+    _packus(T, Src0RM, Src1RM);
     _movp(Dest, T);
     return;
   }
@@ -4540,8 +4778,7 @@ void TargetX86Base<TraitsType>::lowerIntrinsicCall(
     auto *T = makeReg(Dest->getType());
     auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
     auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-    _movp(T, Src0RM);
-    _padds(T, Src1RM);
+    _padds(T, Src0RM, Src1RM);
     _movp(Dest, T);
     return;
   }
@@ -4552,8 +4789,7 @@ void TargetX86Base<TraitsType>::lowerIntrinsicCall(
     auto *T = makeReg(Dest->getType());
     auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
     auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-    _movp(T, Src0RM);
-    _psubs(T, Src1RM);
+    _psubs(T, Src0RM, Src1RM);
     _movp(Dest, T);
     return;
   }
@@ -4564,8 +4800,7 @@ void TargetX86Base<TraitsType>::lowerIntrinsicCall(
     auto *T = makeReg(Dest->getType());
     auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
     auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-    _movp(T, Src0RM);
-    _paddus(T, Src1RM);
+    _paddus(T, Src0RM, Src1RM);
     _movp(Dest, T);
     return;
   }
@@ -4576,8 +4811,7 @@ void TargetX86Base<TraitsType>::lowerIntrinsicCall(
     auto *T = makeReg(Dest->getType());
     auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
     auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-    _movp(T, Src0RM);
-    _psubus(T, Src1RM);
+    _psubus(T, Src0RM, Src1RM);
     _movp(Dest, T);
     return;
   }
@@ -4987,9 +5221,9 @@ void TargetX86Base<TraitsType>::lowerCountZeros(bool Cttz, Type Ty,
                                                 Variable *Dest,
                                                 Operand *FirstVal,
                                                 Operand *SecondVal) {
-  // TODO(jvoung): Determine if the user CPU supports LZCNT (BMI).
-  // Then the instructions will handle the Val == 0 case much more simply
-  // and won't require conversion from bit position to number of zeros.
+  // With -mattr=bmi, lzcnt and tzcnt compute the result directly, including
+  // the Val == 0 case, for which they return the operand width and set CF.
+  // See lowerCountZerosBMI().
   //
   // Otherwise:
   //   bsr IF_NOT_ZERO, Val
@@ -5018,6 +5252,10 @@ void TargetX86Base<TraitsType>::lowerCountZeros(bool Cttz, Type Ty,
 
   // TODO(jpp): refactor this method.
   assert(Ty == IceType_i32 || Ty == IceType_i64);
+  if (InstructionSet >= Traits::BMI1) {
+    lowerCountZerosBMI(Cttz, Ty, Dest, FirstVal, SecondVal);
+    return;
+  }
   const Type DestTy = Traits::Is64Bit ? Dest->getType() : IceType_i32;
   Variable *T = makeReg(DestTy);
   Operand *FirstValRM = legalize(FirstVal, Legal_Mem | Legal_Reg);
@@ -5078,6 +5316,52 @@ void TargetX86Base<TraitsType>::lowerCountZeros(bool Cttz, Type Ty,
   _mov(DestHi, Ctx->getConstantZero(IceType_i32));
 }
 
+/// Lowers count {trailing, leading} zeros with lzcnt or tzcnt:
+///
+///   lzcnt T_DEST, Val
+///   mov DEST, T_DEST
+///
+/// X8632 only: for 64-bit values, FirstVal is the half that is only counted
+/// when SecondVal is zero, so:
+///
+///   lzcnt T_DEST2, FirstVal
+///   add T_DEST2, 32
+///   lzcnt T_DEST, SecondVal   ; sets CF if SecondVal == 0
+///   cmovb T_DEST, T_DEST2
+///   mov DEST.lo, T_DEST
+///   mov DEST.hi, 0
+template <typename TraitsType>
+void TargetX86Base<TraitsType>::lowerCountZerosBMI(bool Cttz, Type Ty,
+                                                   Variable *Dest,
+                                                   Operand *FirstVal,
+                                                   Operand *SecondVal) {
+  assert(InstructionSet >= Traits::BMI1);
+  const Type DestTy = Traits::Is64Bit ? Dest->getType() : IceType_i32;
+  auto CountZeros = [this, Cttz](Variable *T, Operand *Val) {
+    Operand *ValRM = legalize(Val, Legal_Mem | Legal_Reg);
+    if (Cttz) {
+      _tzcnt(T, ValRM);
+    } else {
+      _lzcnt(T, ValRM);
+    }
+  };
+  Variable *T_Dest = makeReg(DestTy);
+  if (Traits::Is64Bit || Ty == IceType_i32) {
+    CountZeros(T_Dest, FirstVal);
+    _mov(Dest, T_Dest);
+    return;
+  }
+  Variable *T_Dest2 = makeReg(IceType_i32);
+  CountZeros(T_Dest2, FirstVal);
+  _add(T_Dest2, Ctx->getConstantInt32(32));
+  CountZeros(T_Dest, SecondVal);
+  _cmov(T_Dest, T_Dest2, Traits::Cond::Br_b);
+  auto *DestLo = llvm::cast<Variable>(loOperand(Dest));
+  auto *DestHi = llvm::cast<Variable>(hiOperand(Dest));
+  _mov(DestLo, T_Dest);
+  _mov(DestHi, Ctx->getConstantZero(IceType_i32));
+}
+
 template <typename TraitsType>
 void TargetX86Base<TraitsType>::typedLoad(Type Ty, Variable *Dest,
                                           Variable *Base, Constant *Offset) {
@@ -6234,8 +6518,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector_UsingPshufb(
 #undef IDX_IN_SRC
     auto *T1 = makeReg(DestTy);
     auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-    _movp(T1, Src1RM);
-    _pshufb(T1, Mask1M);
+    _pshufb(T1, Src1RM, Mask1M);
     _por(T0, T1);
   }
 
@@ -6265,8 +6548,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
     if (Instr->indexesAre(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7)) {
       auto *T = makeReg(DestTy);
       auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
-      _movp(T, Src0RM);
-      _punpckl(T, Src0RM);
+      _punpckl(T, Src0RM, Src0RM);
       _movp(Dest, T);
       return;
     }
@@ -6276,8 +6558,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
       auto *T = makeReg(DestTy);
       auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
       auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-      _movp(T, Src0RM);
-      _punpckl(T, Src1RM);
+      _punpckl(T, Src0RM, Src1RM);
       _movp(Dest, T);
       return;
     }
@@ -6286,8 +6567,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
                           15, 15)) {
       auto *T = makeReg(DestTy);
       auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
-      _movp(T, Src0RM);
-      _punpckh(T, Src0RM);
+      _punpckh(T, Src0RM, Src0RM);
       _movp(Dest, T);
       return;
     }
@@ -6297,8 +6577,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
       auto *T = makeReg(DestTy);
       auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
       auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-      _movp(T, Src0RM);
-      _punpckh(T, Src1RM);
+      _punpckh(T, Src0RM, Src1RM);
       _movp(Dest, T);
       return;
     }
@@ -6340,8 +6619,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
     if (Instr->indexesAre(0, 0, 1, 1, 2, 2, 3, 3)) {
       auto *T = makeReg(DestTy);
       auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
-      _movp(T, Src0RM);
-      _punpckl(T, Src0RM);
+      _punpckl(T, Src0RM, Src0RM);
       _movp(Dest, T);
       return;
     }
@@ -6350,8 +6628,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
       auto *T = makeReg(DestTy);
       auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
       auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-      _movp(T, Src0RM);
-      _punpckl(T, Src1RM);
+      _punpckl(T, Src0RM, Src1RM);
       _movp(Dest, T);
       return;
     }
@@ -6359,8 +6636,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
     if (Instr->indexesAre(4, 4, 5, 5, 6, 6, 7, 7)) {
       auto *T = makeReg(DestTy);
       auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
-      _movp(T, Src0RM);
-      _punpckh(T, Src0RM);
+      _punpckh(T, Src0RM, Src0RM);
       _movp(Dest, T);
       return;
     }
@@ -6369,8 +6645,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
       auto *T = makeReg(DestTy);
       auto *Src0RM = legalize(Src0, Legal_Reg | Legal_Mem);
       auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
-      _movp(T, Src0RM);
-      _punpckh(T, Src1RM);
+      _punpckh(T, Src0RM, Src1RM);
       _movp(Dest, T);
       return;
     }
@@ -6454,8 +6729,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
           auto *Src1RM = legalize(Src1, Legal_Reg | Legal_Mem);
           auto *Src0R = legalizeToReg(Src0);
           T = makeReg(DestTy);
-          _movp(T, Src0R);
-          _punpckl(T, Src1RM);
+          _punpckl(T, Src0R, Src1RM);
         } else if (Index0 == Index2 && Index1 == Index3) {
           assert(false && "Following code is untested but likely correct; test "
                           "and remove assert.");
@@ -6537,8 +6811,7 @@ void TargetX86Base<TraitsType>::lowerShuffleVector(
           auto *Src1RM = legalize(Src0, Legal_Reg | Legal_Mem);
           auto *Src0R = legalizeToReg(Src1);
           T = makeReg(DestTy);
-          _movp(T, Src0R);
-          _punpckl(T, Src1RM);
+          _punpckl(T, Src0R, Src1RM);
         } else if (Index0 == Index2 && Index1 == Index3) {
           auto *Unified = lowerShuffleVector_UnifyFromDifferentSrcs(
               Src1, Index0, Src0, Index1);
@@ -7546,6 +7819,9 @@ void TargetX86Base<TraitsType>::genTargetHelperCallFor(Inst *Instr) {
     default:
       return;
     case Intrinsics::Ctpop: {
+      // The popcnt instruction needs no helper call.
+      if (InstructionSet >= Traits::POPCNT)
+        return;
       Operand *Val = Intrinsic->getArg(0);
       Type ValTy = Val->getType();
       if (ValTy == IceType_i64)
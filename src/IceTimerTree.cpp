@@ -15,6 +15,7 @@
 
 #include "IceTimerTree.h"
 
+#include "IceClFlags.h"
 #include "IceDefs.h"
 
 #ifdef __clang__
@@ -23,14 +24,86 @@
 #endif // __clang__
 
 #include "llvm/Support/Format.h"
-#include "llvm/Support/Timer.h"
 
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif // __clang__
 
+#include <chrono>
+#include <time.h>
+
+#if (defined(__i386__) || defined(__x86_64__)) && !defined(__native_client__)
+#define SUBZERO_USE_TSC 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#else
+#define SUBZERO_USE_TSC 0
+#endif
+
 namespace Ice {
 
+namespace {
+
+// Reads a monotonic clock that is not slewed by NTP, in seconds.
+double monotonicTime() {
+#if defined(CLOCK_MONOTONIC_RAW)
+  struct timespec TS;
+  if (clock_gettime(CLOCK_MONOTONIC_RAW, &TS) == 0)
+    return TS.tv_sec + TS.tv_nsec * 1e-9;
+#endif // defined(CLOCK_MONOTONIC_RAW)
+  using Seconds = std::chrono::duration<double>;
+  return std::chrono::duration_cast<Seconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+#if SUBZERO_USE_TSC
+// Converts TSC readings to seconds on the monotonicTime() scale. Reading the
+// TSC costs a fraction of a clock_gettime() call, which keeps timer overhead
+// low when every pass of every function is timed.
+class TscClock {
+  TscClock(const TscClock &) = delete;
+  TscClock &operator=(const TscClock &) = delete;
+
+public:
+  TscClock() {
+    // The TSC can only be used if it ticks at a constant rate across P-states
+    // and C-states, i.e. CPUID.80000007H:EDX[8] ("invariant TSC").
+    unsigned EAX, EBX, ECX, EDX;
+    if (!__get_cpuid(0x80000000, &EAX, &EBX, &ECX, &EDX) || EAX < 0x80000007)
+      return;
+    __get_cpuid(0x80000007, &EAX, &EBX, &ECX, &EDX);
+    if (!(EDX & (1u << 8)))
+      return;
+    // Calibrate against the monotonic clock over about a millisecond, which
+    // bounds the calibration error to a few parts per million.
+    constexpr double CalibrationTime = 0.001;
+    BaseTime = monotonicTime();
+    BaseTicks = __rdtsc();
+    double EndTime;
+    do {
+      EndTime = monotonicTime();
+    } while (EndTime - BaseTime < CalibrationTime);
+    const uint64_t EndTicks = __rdtsc();
+    if (EndTicks <= BaseTicks)
+      return;
+    SecondsPerTick = (EndTime - BaseTime) / (EndTicks - BaseTicks);
+  }
+  bool isUsable() const { return SecondsPerTick != 0; }
+  double now() const {
+    // Subtract BaseTicks first so that the conversion to double is exact.
+    return BaseTime + int64_t(__rdtsc() - BaseTicks) * SecondsPerTick;
+  }
+
+private:
+  double BaseTime = 0;
+  uint64_t BaseTicks = 0;
+  double SecondsPerTick = 0;
+};
+#endif // SUBZERO_USE_TSC
+
+} // end of anonymous namespace
+
 TimerStack::TimerStack(const std::string &Name)
     : Name(Name), FirstTimestamp(timestamp()), LastTimestamp(FirstTimestamp) {
   if (!BuildDefs::timers())
@@ -306,8 +379,16 @@ void TimerStack::dump(Ostream &Str, bool DumpCumulative) {
 }
 
 double TimerStack::timestamp() {
-  // TODO: Implement in terms of std::chrono for C++11.
-  return llvm::TimeRecord::getCurrentTime(false).getWallTime();
+#if SUBZERO_USE_TSC
+  // The calibration busy-waits for about a millisecond, which is only worth
+  // paying when the timers are read at every pass.
+  if (getFlags().isTimingEnabled()) {
+    static const TscClock Clock;
+    if (Clock.isUsable())
+      return Clock.now();
+  }
+#endif // SUBZERO_USE_TSC
+  return monotonicTime();
 }
 
 } // end of namespace Ice
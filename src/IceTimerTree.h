@@ -72,10 +72,15 @@ public:
   void pop(TimerIdT ID);
   void reset();
   void dump(Ostream &Str, bool DumpCumulative);
+  const std::string &getIDName(TimerIdT ID) const { return IDs[ID]; }
+  /// Returns the current time in seconds. On x86 hosts with an invariant TSC,
+  /// and once a timing flag is enabled, this reads the TSC, calibrated on first
+  /// use against the raw monotonic clock; otherwise it reads the raw monotonic
+  /// clock directly. Both readings are on the same scale.
+  static double timestamp();
 
 private:
   void update(bool UpdateCounts);
-  static double timestamp();
   TranslationType translateIDsFrom(const TimerStack &Src);
   PathType getPath(TTindex Index, const TranslationType &Mapping) const;
   TTindex getChildIndex(TTindex Parent, TimerIdT ID);
@@ -93,6 +98,41 @@ private:
   TTindex StackTop = 0;
 };
 
+/// TimerTrace records the push and pop events on one thread's timer stacks, for
+/// -timing-trace. The events are kept in a fixed-size ring buffer so that
+/// recording never allocates; if the buffer overflows, the oldest events are
+/// overwritten.
+class TimerTrace {
+  TimerTrace(const TimerTrace &) = delete;
+  TimerTrace &operator=(const TimerTrace &) = delete;
+
+public:
+  struct Event {
+    double Time;
+    TimerIdT ID;
+    TimerStackIdT StackID;
+    bool IsBegin;
+  };
+  static constexpr SizeT Capacity = 1 << 16;
+
+  TimerTrace() : Events(Capacity) {}
+  void record(TimerIdT ID, TimerStackIdT StackID, bool IsBegin) {
+    Events[NumRecorded++ % Capacity] = {TimerStack::timestamp(), ID, StackID,
+                                        IsBegin};
+  }
+  /// Calls Fn on each retained event, oldest first.
+  template <typename F> void forEachEvent(F Fn) const {
+    const uint64_t Begin =
+        NumRecorded > Capacity ? NumRecorded - Capacity : uint64_t(0);
+    for (uint64_t I = Begin; I < NumRecorded; ++I)
+      Fn(Events[I % Capacity]);
+  }
+
+private:
+  std::vector<Event> Events;
+  uint64_t NumRecorded = 0;
+};
+
 } // end of namespace Ice
 
 #endif // SUBZERO_SRC_ICETIMERTREE_H
@@ -0,0 +1,509 @@
+//===- subzero/src/IceTranslationCache.cpp - Function code cache ----------===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implements the on-disk, content-addressed cache of translated
+/// functions.
+///
+/// Each entry is a file named after the hex digest of its key, holding the
+/// function's code bytes, followed by its fixups and its jump tables. Fixup
+/// values are stored by name (or by value, for pooled floating point
+/// constants) and are re-interned in the GlobalContext when the entry is
+/// replayed, so the emitted object is the same as if the function had been
+/// translated.
+///
+//===----------------------------------------------------------------------===//
+
+#include "IceTranslationCache.h"
+
+#include "IceAssembler.h"
+#include "IceCfg.h"
+#include "IceClFlags.h"
+#include "IceGlobalContext.h"
+#include "IceInst.h"
+#include "IceOperand.h"
+#include "IceRevision.h"
+#include "IceSwitchLowering.h"
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#endif // __clang__
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MD5.h"
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif // __clang__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+namespace Ice {
+
+namespace {
+
+constexpr char EntryMagic[] = "SZTCACHE1";
+constexpr size_t EntryMagicSize = sizeof(EntryMagic) - 1;
+constexpr char EntrySuffix[] = ".sztc";
+/// Once the cache exceeds its limit, entries are evicted until it is this
+/// percentage of the limit, so that eviction does not run on every insertion.
+constexpr uint64_t EvictToPercent = 90;
+
+enum FixupValueKind : uint8_t {
+  FVK_Null,
+  FVK_Relocatable,
+  FVK_Float,
+  FVK_Double,
+};
+
+/// Serializes the fields of a cache entry, in host byte order. Entries are
+/// not meant to be shared between hosts, since the key includes the Subzero
+/// revision but not the host.
+class EntryWriter {
+  EntryWriter(const EntryWriter &) = delete;
+  EntryWriter &operator=(const EntryWriter &) = delete;
+
+public:
+  EntryWriter() = default;
+  template <typename T> void write(T Value) {
+    Contents.append(reinterpret_cast<const char *>(&Value), sizeof(Value));
+  }
+  void writeBytes(llvm::StringRef Bytes) {
+    Contents.append(Bytes.data(), Bytes.size());
+  }
+  void writeString(llvm::StringRef Str) {
+    write<uint32_t>(Str.size());
+    writeBytes(Str);
+  }
+  const std::string &getContents() const { return Contents; }
+
+private:
+  std::string Contents;
+};
+
+/// Deserializes an entry written by EntryWriter. Reads past the end of the
+/// entry (i.e. a truncated or corrupt file) set the error flag, and return
+/// zero values, so that callers only need to check hasError() once at the end.
+class EntryReader {
+  EntryReader() = delete;
+  EntryReader(const EntryReader &) = delete;
+  EntryReader &operator=(const EntryReader &) = delete;
+
+public:
+  explicit EntryReader(llvm::StringRef Contents) : Contents(Contents) {}
+  template <typename T> T read() {
+    T Value = T();
+    if (!ensure(sizeof(Value)))
+      return Value;
+    memcpy(&Value, Contents.data() + Position, sizeof(Value));
+    Position += sizeof(Value);
+    return Value;
+  }
+  llvm::StringRef readBytes(size_t Size) {
+    if (!ensure(Size))
+      return llvm::StringRef();
+    llvm::StringRef Bytes = Contents.substr(Position, Size);
+    Position += Size;
+    return Bytes;
+  }
+  llvm::StringRef readString() { return readBytes(read<uint32_t>()); }
+  bool hasError() const { return HasError; }
+  bool atEnd() const { return Position == Contents.size(); }
+
+private:
+  bool ensure(size_t Size) {
+    if (HasError || Size > Contents.size() - Position)
+      HasError = true;
+    return !HasError;
+  }
+
+  const llvm::StringRef Contents;
+  size_t Position = 0;
+  bool HasError = false;
+};
+
+bool readFile(const std::string &Path, std::string *Contents) {
+  std::ifstream File(Path, std::ios::in | std::ios::binary);
+  if (!File)
+    return false;
+  std::ostringstream Str;
+  Str << File.rdbuf();
+  if (File.bad())
+    return false;
+  *Contents = Str.str();
+  return true;
+}
+
+bool isEntryName(const std::string &Name) {
+  constexpr size_t SuffixSize = sizeof(EntrySuffix) - 1;
+  return Name.size() > SuffixSize &&
+         Name.compare(Name.size() - SuffixSize, SuffixSize, EntrySuffix) == 0;
+}
+
+/// Returns true if the flag can't change the code generated for a function:
+/// it names the input or output files, controls diagnostics or the translation
+/// threads, or only affects the rest of the object file (e.g. data sections).
+bool isConfigIndependentFlag(llvm::StringRef Name) {
+  static constexpr const char *IndependentFlags[] = {
+      "AllowErrorRecovery",
+      "AllowUninitializedGlobals",
+      "AlwaysExitSuccess",
+      "BitcodeAsText",
+      "BuildOnRead",
+      "CompileServerSocket",
+      "DataSections",
+      "DumpStats",
+      "DumpStrings",
+      "EmitRevision",
+      "FunctionReportFile",
+      "GenerateBuildAtts",
+      "IRFilename",
+      "InputFileFormat",
+      "LLVMVerboseErrors",
+      "LogFilename",
+      "NumTranslationThreads",
+      "OutputFilename",
+      "ParseParallel",
+      "ReorderFunctions",
+      "ReorderFunctionsWindowSize",
+      "ReorderGlobalVariables",
+      "SubzeroTimingEnabled",
+      "TestStatusString",
+      "TimeEachFunction",
+      "TimingFocusOnString",
+      "TimingTraceFile",
+      "TranslationCacheDir",
+      "TranslationCacheSizeMB",
+      "VerboseFocusOnString",
+  };
+  for (const char *Flag : IndependentFlags) {
+    if (Name == Flag)
+      return true;
+  }
+  return false;
+}
+
+void appendFlagValue(llvm::raw_ostream &Str, const std::string &Value) {
+  Str << Value;
+}
+
+void appendFlagValue(llvm::raw_ostream &Str,
+                     const std::vector<std::string> &Values) {
+  for (const std::string &Value : Values)
+    Str << Value << ",";
+}
+
+template <typename T> void appendFlagValue(llvm::raw_ostream &Str, T Value) {
+  Str << static_cast<int64_t>(Value);
+}
+
+/// Returns the configuration that affects the code generated for a function.
+/// It holds every command line flag, except the ones that are known not to
+/// change the code, so that a new flag can't make the cache return stale code.
+/// Flags that disable the cache altogether (see TranslationCache::create())
+/// are included as well, since they are the same for every cached function.
+std::string getConfigString() {
+  const ClFlags &Flags = getFlags();
+  std::string Buffer;
+  llvm::raw_string_ostream Str(Buffer);
+  Str << getSubzeroRevision() << "\n";
+#define X(Name, ...)                                                           \
+  if (!isConfigIndependentFlag(#Name)) {                                       \
+    Str << #Name "=";                                                          \
+    appendFlagValue(Str, Flags.get##Name());                                   \
+    Str << "\n";                                                               \
+  }
+  COMMAND_LINE_FLAGS
+#undef X
+  return Str.str();
+}
+
+} // end of anonymous namespace
+
+std::unique_ptr<TranslationCache> TranslationCache::create(GlobalContext *Ctx) {
+  const ClFlags &Flags = getFlags();
+  const std::string Directory = Flags.getTranslationCacheDir();
+  if (BuildDefs::minimal() || Directory.empty())
+    return nullptr;
+  // Only the x86 assemblers produce fixups that can be recreated from their
+  // kind, position and value alone.
+  const TargetArch Arch = Flags.getTargetArch();
+  if (Arch != Target_X8632 && Arch != Target_X8664)
+    return nullptr;
+  if (Flags.getOutFileType() != FT_Elf)
+    return nullptr;
+  // Exclude configurations where the code of a function depends on more than
+  // its bitcode and the module's declarations, or where translation has side
+  // effects (other than the code itself) that a cache hit would skip.
+  if (Flags.getVerbose() != IceV_None || Flags.getDisableTranslation() ||
+      Flags.getTranslateOnlyString() != ":" ||
+      Flags.getShouldDoNopInsertion() ||
+      Flags.getRandomizeRegisterAllocation() ||
+      Flags.getRandomizeAndPoolImmediatesOption() != RPI_None ||
+      Flags.getReorderBasicBlocks() || Flags.getEnableBlockProfile() ||
+      Flags.getSanitizeAddresses())
+    return nullptr;
+  if (::mkdir(Directory.c_str(), 0777) != 0 && errno != EEXIST) {
+    llvm::report_fatal_error("Unable to create translation cache directory " +
+                             Directory + ": " + std::strerror(errno));
+  }
+  constexpr uint64_t MB = 1024 * 1024;
+  return std::unique_ptr<TranslationCache>(new TranslationCache(
+      Ctx, Directory, uint64_t(Flags.getTranslationCacheSizeMB()) * MB));
+}
+
+TranslationCache::TranslationCache(GlobalContext *Ctx,
+                                   const std::string &Directory,
+                                   uint64_t MaxBytes)
+    : Ctx(Ctx), Directory(Directory), MaxBytes(MaxBytes),
+      ConfigDigest(digest(getConfigString())) {
+  // Index the existing entries, so that the size limit is enforced across
+  // compiles.
+  DIR *Dir = ::opendir(Directory.c_str());
+  if (Dir == nullptr)
+    return;
+  while (const struct dirent *DirEntry = ::readdir(Dir)) {
+    const std::string Name = DirEntry->d_name;
+    if (!isEntryName(Name))
+      continue;
+    struct stat Stat;
+    if (::stat((Directory + "/" + Name).c_str(), &Stat) != 0)
+      continue;
+    const std::string Key = Name.substr(0, Name.size() - strlen(EntrySuffix));
+    Entries[Key] = {uint64_t(Stat.st_size), int64_t(Stat.st_mtime)};
+    TotalBytes += Stat.st_size;
+  }
+  ::closedir(Dir);
+  std::lock_guard<std::mutex> L(Lock);
+  evict();
+}
+
+std::string TranslationCache::digest(llvm::StringRef Bytes) {
+  llvm::MD5 Hash;
+  Hash.update(Bytes);
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+  llvm::SmallString<32> Str;
+  llvm::MD5::stringifyResult(Result, Str);
+  return std::string(Str.str());
+}
+
+std::string TranslationCache::getKey(const TranslationCacheInfo &Info) const {
+  // -force-O2 and -split-inst select functions by name or sequence number, so
+  // their outcome for this particular function is part of its configuration.
+  const ClFlags &Flags = getFlags();
+  const bool ForceO2 =
+      Flags.matchForceO2(Info.FunctionName, Info.SequenceNumber);
+  const bool SplitInsts = Flags.matchSplitInsts(
+      Info.FunctionName.toString(), Info.SequenceNumber);
+  return digest(Info.Key + ConfigDigest + (ForceO2 ? "1" : "0") +
+                (SplitInsts ? "1" : "0"));
+}
+
+std::string TranslationCache::getPath(const std::string &Key) const {
+  return Directory + "/" + Key + EntrySuffix;
+}
+
+std::unique_ptr<Assembler>
+TranslationCache::lookup(const TranslationCacheInfo &Info) {
+  TimerMarker T(TimerStack::TT_translationCache, Ctx);
+  if (!Info.FunctionName.hasStdString())
+    return nullptr;
+  const std::string Key = getKey(Info);
+  const std::string Path = getPath(Key);
+  // The file is looked up even if it is not in the index, since another
+  // compile sharing the directory may have added it.
+  std::string Contents;
+  if (!readFile(Path, &Contents))
+    return nullptr;
+  {
+    // Mark the entry as recently used, both in the index and on disk.
+    std::lock_guard<std::mutex> L(Lock);
+    ::utime(Path.c_str(), nullptr);
+    addEntry(Key, Contents.size());
+  }
+  EntryReader Reader(Contents);
+  if (Reader.readBytes(EntryMagicSize) != EntryMagic)
+    return nullptr;
+
+  // Create an assembler for the target, through a throwaway Cfg.
+  std::unique_ptr<Assembler> Asm =
+      Cfg::create(Ctx, Info.SequenceNumber)->releaseAssembler();
+  Asm->setFunctionName(Info.FunctionName);
+  Asm->setInternal(Info.IsInternal);
+  Asm->emitBytes(Reader.readString());
+
+  const auto NumFixups = Reader.read<uint32_t>();
+  for (uint32_t I = 0; I < NumFixups && !Reader.hasError(); ++I) {
+    const auto Kind = Reader.read<FixupKind>();
+    const auto Position = Reader.read<uint64_t>();
+    const auto Addend = Reader.read<RelocOffsetT>();
+    const Constant *Value = AssemblerFixup::NullSymbol;
+    switch (Reader.read<FixupValueKind>()) {
+    case FVK_Null:
+      break;
+    case FVK_Relocatable: {
+      const auto Offset = Reader.read<RelocOffsetT>();
+      const llvm::StringRef Name = Reader.readString();
+      Value = Ctx->getConstantSym(Offset, Ctx->getGlobalString(Name.str()));
+    } break;
+    case FVK_Float:
+      Value = Ctx->getConstantFloat(Reader.read<float>());
+      break;
+    case FVK_Double:
+      Value = Ctx->getConstantDouble(Reader.read<double>());
+      break;
+    default:
+      return nullptr;
+    }
+    AssemblerFixup *Fixup = Asm->createFixup(Kind, Value);
+    Fixup->set_position(Position);
+    Fixup->set_addend(Addend);
+  }
+
+  JumpTableDataList JumpTables;
+  const auto NumJumpTables = Reader.read<uint32_t>();
+  for (uint32_t I = 0; I < NumJumpTables && !Reader.hasError(); ++I) {
+    const GlobalString Name = Ctx->getGlobalString(Reader.readString().str());
+    const auto Id = Reader.read<SizeT>();
+    JumpTableData::TargetList TargetOffsets(Reader.read<uint32_t>());
+    for (intptr_t &Offset : TargetOffsets)
+      Offset = Reader.read<uint64_t>();
+    JumpTables.emplace_back(Name, Info.FunctionName, Id, TargetOffsets);
+  }
+  if (Reader.hasError() || !Reader.atEnd())
+    return nullptr;
+  for (JumpTableData &JumpTable : JumpTables)
+    Ctx->addJumpTableData(std::move(JumpTable));
+  return Asm;
+}
+
+void TranslationCache::insert(const TranslationCacheInfo &Info, Cfg *Func) {
+  TimerMarker T(TimerStack::TT_translationCache, Ctx);
+  if (!Info.FunctionName.hasStdString())
+    return;
+  Assembler *Asm = Func->getAssembler<>();
+  EntryWriter Writer;
+  Writer.writeBytes(llvm::StringRef(EntryMagic, EntryMagicSize));
+  Writer.writeString(Asm->getBufferView());
+
+  const FixupRefList &Fixups = Asm->fixups();
+  Writer.write<uint32_t>(Fixups.size());
+  for (const AssemblerFixup *Fixup : Fixups) {
+    // Fixups bound to ELF symbols only come from the object writer itself.
+    if (Fixup->valueIsSymbol())
+      return;
+    Writer.write<FixupKind>(Fixup->kind());
+    Writer.write<uint64_t>(Fixup->position());
+    Writer.write<RelocOffsetT>(Fixup->get_addend());
+    if (Fixup->isNullSymbol()) {
+      Writer.write(FVK_Null);
+      continue;
+    }
+    // Pooled floating point constants are referenced through their label, and
+    // must be re-pooled so that the label gets defined.
+    const Constant *Value = Fixup->getConstValue();
+    if (const auto *Float = llvm::dyn_cast<ConstantFloat>(Value)) {
+      Writer.write(FVK_Float);
+      Writer.write<float>(Float->getValue());
+      continue;
+    }
+    if (const auto *Double = llvm::dyn_cast<ConstantDouble>(Value)) {
+      Writer.write(FVK_Double);
+      Writer.write<double>(Double->getValue());
+      continue;
+    }
+    // The addend was written separately, so offset() is only needed for its
+    // symbol's own (fully resolved) offset.
+    const RelocOffsetT Offset = Fixup->offset() - Fixup->get_addend();
+    const GlobalString Name = Fixup->symbol();
+    if (!Name.hasStdString())
+      return;
+    Writer.write(FVK_Relocatable);
+    Writer.write<RelocOffsetT>(Offset);
+    Writer.writeString(Name.toString());
+  }
+
+  const auto &JumpTables = Func->getJumpTables();
+  Writer.write<uint32_t>(JumpTables.size());
+  for (const InstJumpTable *JumpTable : JumpTables) {
+    const JumpTableData Data = JumpTable->toJumpTableData(Asm);
+    if (!Data.getName().hasStdString())
+      return;
+    Writer.writeString(Data.getName().toString());
+    Writer.write<SizeT>(Data.getId());
+    Writer.write<uint32_t>(Data.getTargetOffsets().size());
+    for (const intptr_t Offset : Data.getTargetOffsets())
+      Writer.write<uint64_t>(Offset);
+  }
+
+  // Write to a temporary file and rename it into place, so that concurrent
+  // compiles sharing the directory never see a partial entry.
+  const std::string Key = getKey(Info);
+  const std::string Path = getPath(Key);
+  const std::string TempPath =
+      Path + ".tmp" + std::to_string(::getpid()) + "." +
+      std::to_string(Info.SequenceNumber);
+  const std::string &Contents = Writer.getContents();
+  {
+    std::ofstream File(TempPath, std::ios::out | std::ios::binary);
+    File.write(Contents.data(), Contents.size());
+    if (!File) {
+      ::unlink(TempPath.c_str());
+      return;
+    }
+  }
+  if (std::rename(TempPath.c_str(), Path.c_str()) != 0) {
+    ::unlink(TempPath.c_str());
+    return;
+  }
+  std::lock_guard<std::mutex> L(Lock);
+  addEntry(Key, Contents.size());
+}
+
+void TranslationCache::addEntry(const std::string &Key, uint64_t Size) {
+  auto Iter = Entries.find(Key);
+  if (Iter != Entries.end())
+    TotalBytes -= Iter->second.Size;
+  Entries[Key] = {Size, int64_t(std::time(nullptr))};
+  TotalBytes += Size;
+  evict();
+}
+
+void TranslationCache::evict() {
+  if (TotalBytes <= MaxBytes)
+    return;
+  std::vector<std::pair<int64_t, std::string>> ByAge;
+  ByAge.reserve(Entries.size());
+  for (const auto &Entry : Entries)
+    ByAge.emplace_back(Entry.second.LastUse, Entry.first);
+  std::sort(ByAge.begin(), ByAge.end());
+  const uint64_t Target = MaxBytes / 100 * EvictToPercent;
+  for (const auto &Entry : ByAge) {
+    if (TotalBytes <= Target)
+      break;
+    auto Iter = Entries.find(Entry.second);
+    ::unlink(getPath(Entry.second).c_str());
+    TotalBytes -= Iter->second.Size;
+    Entries.erase(Iter);
+  }
+}
+
+} // end of namespace Ice
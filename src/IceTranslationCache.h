@@ -0,0 +1,98 @@
+//===- subzero/src/IceTranslationCache.h - Function code cache --*- C++ -*-===//
+//
+//                        The Subzero Code Generator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Declares the on-disk, content-addressed cache of translated
+/// functions.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SUBZERO_SRC_ICETRANSLATIONCACHE_H
+#define SUBZERO_SRC_ICETRANSLATIONCACHE_H
+
+#include "IceDefs.h"
+#include "IceStringPool.h"
+
+#include <map>
+#include <mutex>
+
+namespace Ice {
+
+/// TranslationCacheInfo describes a function that has not been parsed yet, in
+/// enough detail for the translation cache to find (and install) its code.
+struct TranslationCacheInfo {
+  /// Digest of everything the function's translation depends on, other than
+  /// the configuration (flags, target, Subzero revision).
+  std::string Key;
+  GlobalString FunctionName;
+  bool IsInternal = false;
+  uint32_t SequenceNumber = 0;
+};
+
+/// TranslationCache maps the digest of a function body (plus the module-level
+/// declarations it refers to, and the translation configuration) to the
+/// function's assembled code, fixups and jump tables, stored in one file per
+/// function under a cache directory. A hit lets a translation thread skip
+/// parsing, optimization and lowering altogether.
+///
+/// The cache is shared by all the translation threads. Its size is bounded by
+/// evicting the least recently used entries, using the files' modification
+/// times so that the recency information survives across compiles.
+class TranslationCache {
+  TranslationCache() = delete;
+  TranslationCache(const TranslationCache &) = delete;
+  TranslationCache &operator=(const TranslationCache &) = delete;
+
+public:
+  /// Returns a new cache if -translation-cache is given and the configuration
+  /// produces deterministic, position-independent function code, and nullptr
+  /// otherwise.
+  static std::unique_ptr<TranslationCache> create(GlobalContext *Ctx);
+
+  /// Returns the digest of the given bytes, as a hex string.
+  static std::string digest(llvm::StringRef Bytes);
+
+  /// Returns the cached code of the described function, or nullptr on a miss.
+  /// On a hit, also registers the function's jump tables with the context.
+  std::unique_ptr<Assembler> lookup(const TranslationCacheInfo &Info);
+
+  /// Records the code of the just assembled Func, if it can be replayed.
+  void insert(const TranslationCacheInfo &Info, Cfg *Func);
+
+private:
+  TranslationCache(GlobalContext *Ctx, const std::string &Directory,
+                   uint64_t MaxBytes);
+
+  struct EntryInfo {
+    uint64_t Size;
+    int64_t LastUse;
+  };
+
+  /// Returns the digest identifying the described function's entry.
+  std::string getKey(const TranslationCacheInfo &Info) const;
+  std::string getPath(const std::string &Key) const;
+  /// Adds the entry to the index, and evicts the least recently used entries
+  /// if the cache is over its size limit. Requires Lock to be held.
+  void addEntry(const std::string &Key, uint64_t Size);
+  void evict();
+
+  GlobalContext *Ctx;
+  const std::string Directory;
+  const uint64_t MaxBytes;
+  /// Digest of the configuration, mixed into every key.
+  std::string ConfigDigest;
+
+  std::mutex Lock;
+  std::map<std::string, EntryInfo> Entries;
+  uint64_t TotalBytes = 0;
+};
+
+} // end of namespace Ice
+
+#endif // SUBZERO_SRC_ICETRANSLATIONCACHE_H
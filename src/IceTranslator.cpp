@@ -18,6 +18,7 @@
 #include "IceCfg.h"
 #include "IceClFlags.h"
 #include "IceGlobalInits.h"
+#include "IceInliner.h"
 #include "IceTargetLowering.h"
 
 #include <utility>
@@ -57,9 +58,27 @@ bool Translator::checkIfUnnamedNameSafe(const std::string &Name,
 }
 
 void Translator::translateFcn(std::unique_ptr<Cfg> Func) {
+  if (getFlags().getEnableInlining()) {
+    PendingFcns.emplace_back(std::move(Func));
+    // Bound the memory held by the parsed functions, at the cost of not
+    // inlining the calls between functions of different batches.
+    const uint32_t MaxPending = getFlags().getInlineMaxPendingFuncs();
+    if (MaxPending != 0 && PendingFcns.size() >= MaxPending)
+      translatePendingFcns();
+    return;
+  }
   Ctx->optQueueBlockingPush(makeUnique<CfgOptWorkItem>(std::move(Func)));
 }
 
+void Translator::translatePendingFcns() {
+  if (PendingFcns.empty())
+    return;
+  inlineFunctions(Ctx, PendingFcns);
+  for (auto &Func : PendingFcns)
+    Ctx->optQueueBlockingPush(makeUnique<CfgOptWorkItem>(std::move(Func)));
+  PendingFcns.clear();
+}
+
 void Translator::lowerGlobals(
     std::unique_ptr<VariableDeclarationList> VariableDeclarations) {
   Ctx->emitQueueBlockingPush(makeUnique<EmitterWorkItem>(
@@ -48,9 +48,17 @@ public:
 
   GlobalContext *getContext() const { return Ctx; }
 
-  /// Translates the constructed ICE function Func to machine code.
+  /// Translates the constructed ICE function Func to machine code. With
+  /// -enable-inlining, Func is held back until translatePendingFcns(), or until
+  /// -inline-max-pending-functions functions are held.
   void translateFcn(std::unique_ptr<Cfg> Func);
 
+  /// Runs the inliner over the functions held back by translateFcn(), then
+  /// translates them in the order they were constructed. Must be called once
+  /// all functions have been constructed, before waiting for the worker
+  /// threads.
+  void translatePendingFcns();
+
   /// Lowers the given list of global addresses to target. Generates list of
   /// corresponding variable declarations.
   void
@@ -72,6 +80,8 @@ protected:
   uint32_t NextSequenceNumber;
   /// ErrorCode of the translation.
   ErrorCode ErrorStatus;
+  /// Functions waiting for the inliner.
+  std::vector<std::unique_ptr<Cfg>> PendingFcns;
 };
 
 class CfgOptWorkItem final : public OptWorkItem {
@@ -67,6 +67,10 @@ enum TargetInstructionSet {
   X86InstructionSet_Begin,
   X86InstructionSet_SSE2 = X86InstructionSet_Begin,
   X86InstructionSet_SSE4_1,
+  X86InstructionSet_POPCNT,
+  X86InstructionSet_BMI1,
+  X86InstructionSet_BMI2,
+  X86InstructionSet_AVX,
   X86InstructionSet_End,
   ARM32InstructionSet_Begin,
   ARM32InstructionSet_Neon = ARM32InstructionSet_Begin,
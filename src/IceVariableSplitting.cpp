@@ -202,6 +202,12 @@ public:
   bool shouldSkipRemainingInstructions() const {
     return ShouldSkipRemainingInstructions;
   }
+  /// Inserts a new move before Where, numbered into the gap between its
+  /// neighbors so that the pass keeps the instruction numbering valid.
+  void insertMov(InstList::iterator Where, Inst *Mov) {
+    Node->getInsts().insert(Where, Mov);
+    Node->getCfg()->placeInstNumber(Node, Mov);
+  }
   bool isUnconditionallyExecuted() const { return WaitingForLabel == nullptr; }
 
   /// Note: the handle*() functions return true to indicate that the instruction
@@ -314,7 +320,7 @@ public:
         if (!VarMap.isInstLastUseOfVar(SrcVar, Instr)) {
           Variable *NewMapped = VarMap.makeLinked(SrcVar);
           Inst *Mov = Target->createLoweredMove(NewMapped, Dest);
-          Node->getInsts().insert(IterNext, Mov);
+          insertMov(IterNext, Mov);
         }
       }
       return true;
@@ -339,14 +345,14 @@ public:
         // executed.
         Variable *NewMapped = VarMap.makeLinked(Dest);
         Inst *Mov = Target->createLoweredMove(NewMapped, SrcVar);
-        Node->getInsts().insert(IterNext, Mov);
+        insertMov(IterNext, Mov);
       } else {
         // For a conditionally executed instruction, add a redefinition of the
         // original Dest mapping, without creating a new linked variable.
         Variable *OldMapped = VarMap.get(Dest);
         Inst *Mov = Target->createLoweredMove(OldMapped, SrcVar);
         Mov->setDestRedefined();
-        Node->getInsts().insert(IterNext, Mov);
+        insertMov(IterNext, Mov);
       }
       return true;
     }
@@ -364,7 +370,7 @@ public:
       return true;
     Variable *NewMapped = VarMap.makeLinked(Dest);
     Inst *Mov = Target->createLoweredMove(NewMapped, Dest);
-    Node->getInsts().insert(IterCur, Mov);
+    insertMov(IterCur, Mov);
     return true;
   }
 
@@ -398,7 +404,7 @@ public:
             if (!VarMap.isInstLastUseOfVar(SrcVar, Instr)) {
               Variable *NewMapped = VarMap.makeLinked(SrcVar);
               Inst *Mov = Target->createLoweredMove(NewMapped, OldMapped);
-              Node->getInsts().insert(IterCur, Mov);
+              insertMov(IterCur, Mov);
             }
           }
           Instr->replaceSource(i, OldMapped);
@@ -410,12 +416,12 @@ public:
       if (isUnconditionallyExecuted()) {
         Variable *NewMapped = VarMap.makeLinked(Dest);
         Inst *Mov = Target->createLoweredMove(NewMapped, Dest);
-        Node->getInsts().insert(IterNext, Mov);
+        insertMov(IterNext, Mov);
       } else {
         Variable *OldMapped = VarMap.get(Dest);
         Inst *Mov = Target->createLoweredMove(OldMapped, Dest);
         Mov->setDestRedefined();
-        Node->getInsts().insert(IterNext, Mov);
+        insertMov(IterNext, Mov);
       }
     }
     return true;
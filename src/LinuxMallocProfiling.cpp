@@ -18,6 +18,7 @@
 
 #include <dlfcn.h>
 #include <malloc.h>
+#include <sys/resource.h>
 #include <unordered_map>
 
 extern "C" void *__libc_malloc(size_t size);
@@ -41,6 +42,14 @@ void *internalAllocator(size_t size, void *caller) {
   }
   return __libc_malloc(size);
 }
+
+void reportPeakRSS(Ice::Ostream *Ls, const char *When) {
+  struct rusage Usage;
+  if (getrusage(RUSAGE_SELF, &Usage) != 0)
+    return;
+  // On Linux, ru_maxrss is in kilobytes.
+  *Ls << "Peak RSS " << When << ": " << Usage.ru_maxrss << " KB\n";
+}
 } // end of anonymous namespace
 
 // new, new[], and malloc are all defined as weak symbols to allow them to be
@@ -66,6 +75,7 @@ namespace Ice {
 
 LinuxMallocProfiling::LinuxMallocProfiling(size_t NumThreads, Ostream *Ls)
     : Ls(Ls) {
+  reportPeakRSS(Ls, "before translation");
   if (NumThreads != 0) {
     *Ls << "NOTE: Malloc profiling is not thread safe. Use --threads=0 to "
            "enable.\n";
@@ -75,6 +85,7 @@ LinuxMallocProfiling::LinuxMallocProfiling(size_t NumThreads, Ostream *Ls)
 }
 
 LinuxMallocProfiling::~LinuxMallocProfiling() {
+  reportPeakRSS(Ls, "after translation");
   if (Callers == nullptr) {
     return;
   }
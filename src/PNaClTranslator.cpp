@@ -23,6 +23,7 @@
 #include "IceInst.h"
 #include "IceOperand.h"
 #include "IceRangeSpec.h"
+#include "IceTranslationCache.h"
 
 #ifdef __clang__
 #pragma clang diagnostic push
@@ -339,6 +340,17 @@ public:
 
   void verifyFunctionTypeSignatures();
 
+  /// Computes the digest of the module-level information that the translation
+  /// of a function block may depend on: types, global declarations, and the
+  /// global abbreviations of the blocks nested in a function block. Must be
+  /// called after global names and value IDs are installed, but before the
+  /// global variables are lowered.
+  void computeModuleDigest(NaClBitstreamReader *Reader);
+
+  /// Returns the digest computed by computeModuleDigest(), or the empty string
+  /// if it hasn't been computed.
+  const std::string &getModuleDigest() const { return ModuleDigest; }
+
   void createValueIDs() {
     assert(VariableDeclarations);
     ValueIDConstants.reserve(VariableDeclarations->size() +
@@ -446,6 +458,8 @@ private:
   Ice::FuncSigType UndefinedFuncSigType;
   // Defines if a module block has already been parsed.
   bool ParsedModuleBlock = false;
+  // Digest of the module-level declarations, for the translation cache.
+  std::string ModuleDigest;
 
   bool ParseBlock(unsigned BlockID) override;
 
@@ -653,6 +667,50 @@ void TopLevelParser::verifyFunctionTypeSignatures() {
   }
 }
 
+void TopLevelParser::computeModuleDigest(NaClBitstreamReader *Reader) {
+  assert(VariableDeclarations);
+  std::string Buffer;
+  raw_string_ostream StrBuf(Buffer);
+  auto AddSignature = [&StrBuf](const Ice::FuncSigType &Signature) {
+    StrBuf << Signature.getReturnType() << "(";
+    for (Ice::Type ArgType : Signature.getArgList())
+      StrBuf << ArgType << ",";
+    StrBuf << ")";
+  };
+  for (const ExtendedType &Ty : TypeIDValues) {
+    StrBuf << "T" << Ty.getKind() << ":";
+    if (const auto *FuncSigTy = dyn_cast<FuncSigExtendedType>(&Ty))
+      AddSignature(FuncSigTy->getSignature());
+    else if (const auto *SimpleTy = dyn_cast<SimpleExtendedType>(&Ty))
+      StrBuf << SimpleTy->getType();
+    StrBuf << "\n";
+  }
+  for (const Ice::FunctionDeclaration *Func : FunctionDeclarations) {
+    StrBuf << "F" << Func->getName().toStringOrEmpty() << ":"
+           << Func->getLinkage() << ":" << Func->isProto() << ":";
+    AddSignature(Func->getSignature());
+    StrBuf << "\n";
+  }
+  for (const Ice::VariableDeclaration *Var : *VariableDeclarations) {
+    StrBuf << "V" << Var->getName().toStringOrEmpty() << ":"
+           << Var->getLinkage() << ":" << Var->hasInitializer() << "\n";
+  }
+  for (unsigned BlockID :
+       {naclbitc::FUNCTION_BLOCK_ID, naclbitc::CONSTANTS_BLOCK_ID,
+        naclbitc::VALUE_SYMTAB_BLOCK_ID}) {
+    StrBuf << "B" << BlockID << "\n";
+    for (const NaClBitCodeAbbrev *Abbrev :
+         Reader->getBlockInfo(BlockID)->getAbbrevs().getVector()) {
+      for (unsigned I = 0, E = Abbrev->getNumOperandInfos(); I < E; ++I) {
+        const NaClBitCodeAbbrevOp &Op = Abbrev->getOperandInfo(I);
+        StrBuf << Op.getEncoding() << "." << Op.getValue() << ",";
+      }
+      StrBuf << "\n";
+    }
+  }
+  ModuleDigest = Ice::TranslationCache::digest(StrBuf.str());
+}
+
 // Base class for parsing blocks within the bitcode file. Note: Because this is
 // the base class of block parsers, we generate error messages if ParseBlock or
 // ParseRecord is not overridden in derived classes.
@@ -1394,7 +1452,10 @@ public:
         Func->addArg(getNextInstVar(ArgType));
       }
 
+      const uint64_t StartBit = Record.GetCursor().GetCurrentBitNo();
       ParserResult = ParseThisBlock();
+      if (Ice::FunctionReport *Report = Func->getReport())
+        Report->InputBits = Record.GetCursor().GetCurrentBitNo() - StartBit;
     }
 
     if (ParserResult || BlockHasError)
@@ -3006,6 +3067,12 @@ public:
   ~ModuleParser() override = default;
   const char *getBlockName() const override { return "module"; }
   NaClBitstreamCursor &getCursor() const { return Record.GetCursor(); }
+  const std::string &getModuleDigest() const {
+    return Context->getModuleDigest();
+  }
+  Ice::FunctionDeclaration *getFunctionByID(NaClBcIndexSize_t ID) const {
+    return Context->getFunctionByID(ID);
+  }
 
 private:
   Ice::TimerMarker Timer;
@@ -3025,6 +3092,9 @@ private:
       Context->installGlobalNames();
       Context->createValueIDs();
       Context->verifyFunctionTypeSignatures();
+      if (IsParseParallel &&
+          getTranslator().getContext()->getTranslationCache() != nullptr)
+        Context->computeModuleDigest(getCursor().getBitStreamReader());
       std::unique_ptr<Ice::VariableDeclarationList> Globals =
           Context->getGlobalVariables();
       if (Globals)
@@ -3036,6 +3106,7 @@ private:
 
   void ExitBlock() override {
     installGlobalNamesAndGlobalVarInitializers();
+    Context->getTranslator().translatePendingFcns();
     Context->getTranslator().getContext()->waitForWorkerThreads();
   }
 
@@ -3100,6 +3171,7 @@ public:
         Buffer(std::move(Buffer)), BufferSize(BufferSize), StartBit(StartBit),
         SeqNumber(SeqNumber) {}
   std::unique_ptr<Ice::Cfg> getParsedCfg() override;
+  bool getTranslationCacheInfo(Ice::TranslationCacheInfo *Info) const override;
   ~CfgParserWorkItem() override = default;
 
 private:
@@ -3126,6 +3198,31 @@ std::unique_ptr<Ice::Cfg> CfgParserWorkItem::getParsedCfg() {
   return Parser.parseFunction(SeqNumber);
 }
 
+bool CfgParserWorkItem::getTranslationCacheInfo(
+    Ice::TranslationCacheInfo *Info) const {
+  const std::string &ModuleDigest = ModParser->getModuleDigest();
+  if (ModuleDigest.empty())
+    return false;
+  const Ice::FunctionDeclaration *FuncDecl =
+      ModParser->getFunctionByID(FcnId);
+  // The block is copied starting at the word containing StartBit, so the bit
+  // offset within that word is part of its contents.
+  NaClBitstreamCursor &Cursor(ModParser->getCursor());
+  const uint64_t StartBitInWord =
+      StartBit - 8 * Cursor.getStartWordByteForBit(StartBit);
+  std::string KeyBuffer;
+  raw_string_ostream StrBuf(KeyBuffer);
+  StrBuf << ModuleDigest << ":" << BlockID << ":" << StartBitInWord << ":"
+         << FuncDecl->getName().toStringOrEmpty() << ":"
+         << FuncDecl->getLinkage() << ":";
+  StrBuf.write(reinterpret_cast<const char *>(Buffer.get()), BufferSize);
+  Info->Key = Ice::TranslationCache::digest(StrBuf.str());
+  Info->FunctionName = FuncDecl->getName();
+  Info->IsInternal = FuncDecl->getLinkage() == GlobalValue::InternalLinkage;
+  Info->SequenceNumber = SeqNumber;
+  return true;
+}
+
 bool ModuleParser::ParseBlock(unsigned BlockID) {
   switch (BlockID) {
   case naclbitc::BLOCKINFO_BLOCK_ID:
@@ -1592,11 +1592,15 @@ void WasmTranslator::translate(
         WritePtr = Seg.dest_addr;
       }
 
-      // Add the data
-      WasmMemory->addInitializer(VariableDeclaration::DataInitializer::create(
-          Globals.get(), reinterpret_cast<const char *>(Module->module_start) +
-                             Seg.source_offset,
-          Seg.source_size));
+      // Add the data. The segment is referenced in place, since Buffer is kept
+      // alive until the globals have been emitted.
+      WasmMemory->addInitializer(
+          VariableDeclaration::DataInitializer::createReference(
+              Globals.get(),
+              llvm::StringRef(
+                  reinterpret_cast<const char *>(Module->module_start) +
+                      Seg.source_offset,
+                  Seg.source_size)));
 
       WritePtr += Seg.source_size;
     }
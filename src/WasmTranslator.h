@@ -70,6 +70,8 @@ public:
                     v8::internal::wasm::FunctionBody &Body);
 
 private:
+  /// The module being translated. Data segment initializers refer to it, so
+  /// it must not be modified once the module has been decoded.
   std::vector<uint8_t> Buffer;
 };
 }
@@ -0,0 +1,53 @@
+; Test that independent instructions are moved into the delay slots of MIPS32
+; calls and returns when -enable-delay-slot-fill is given.
+
+; REQUIRES: allow_dump
+
+; Compile using standalone assembler.
+; RUN: %p2i --filetype=asm -i %s --target=mips32 --args -O2 \
+; RUN:   --allow-externally-defined-symbols -enable-delay-slot-fill \
+; RUN:   | FileCheck %s --check-prefix=ASM
+
+; Show bytes in assembled standalone code.
+; RUN: %p2i --filetype=asm -i %s --target=mips32 --assemble --disassemble \
+; RUN:   --args -O2 --allow-externally-defined-symbols -enable-delay-slot-fill \
+; RUN:   | FileCheck %s --check-prefix=DIS
+
+; Show bytes in assembled integrated code.
+; RUN: %p2i --filetype=iasm -i %s --target=mips32 --assemble --disassemble \
+; RUN:   --args -O2 --allow-externally-defined-symbols -enable-delay-slot-fill \
+; RUN:   | FileCheck %s --check-prefix=DIS
+
+; Count the filled and unfilled slots.
+; RUN: %p2i --filetype=asm -i %s --target=mips32 --args -O2 \
+; RUN:   --allow-externally-defined-symbols -enable-delay-slot-fill -szstats \
+; RUN:   | FileCheck %s --check-prefix=STATS
+
+declare void @callee(i32, i32)
+
+define internal void @test_call(i32 %a) {
+entry:
+  %b = add i32 %a, 1
+  call void @callee(i32 %a, i32 %b)
+  ret void
+}
+
+; ASM-LABEL: test_call:
+; ASM:      .set	noreorder
+; ASM-NEXT: jal	callee
+; ASM-NEXT: {{[a-z]+}}	$
+; ASM-NEXT: .set	reorder
+; ASM:      .set	noreorder
+; ASM-NEXT: jr	$ra
+; ASM-NEXT: addiu	$sp, $sp, {{.*}}
+; ASM-NEXT: .set	reorder
+
+; DIS-LABEL: <test_call>:
+; DIS:      jal
+; DIS-NOT:  nop
+; DIS:      lw	ra,{{.*}}(sp)
+; DIS-NEXT: jr	ra
+; DIS-NEXT: addiu	sp,sp,{{.*}}
+
+; STATS: |_FINAL_|Slots Filled|{{[1-9]}}
+; STATS: |_FINAL_|Slots Nop   |
@@ -140,20 +140,71 @@ next3:
   call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
   br label %next1
 }
-; Note: forward branches for non-local labels in Subzero currently use the fully
-; relaxed form (4-byte offset) to avoid needing a relaxation pass.  When we use
-; llvm-mc, it performs the relaxation pass and uses a 1-byte offset.
+; Forward branches to cfg nodes go through branch relaxation, so they use a
+; 1-byte offset when the target is close enough.
 ; CHECK-LABEL: test_near_forward
 ; CHECK:      [[BACKLABEL:[0-9a-f]+]]: {{.*}} cmp
-; CHECK-NEXT: {{.*}} jb [[FORWARDLABEL:[0-9a-f]+]]
+; CHECK-NEXT: {{[0-9a-f]+}}: 72 {{[0-9a-f]+}} jb [[FORWARDLABEL:[0-9a-f]+]]
 ; CHECK-NEXT: {{.*}} mov DWORD PTR
 ; CHECK-NEXT: {{.*}} mfence
 ; CHECK-NEXT: [[FORWARDLABEL]]: {{.*}} mov DWORD PTR
 ; CHECK:      {{.*}} jmp [[BACKLABEL]]
 
+; Forward branches whose target is too far for a 1-byte offset are relaxed to
+; the 4-byte form, while the ones in range keep the 1-byte form.
+define internal void @test_far_forward(i32 %iptr, i32 %val) {
+entry:
+  %ptr = inttoptr i32 %iptr to i32*
+  %cmp = icmp ult i32 %val, 1
+  br i1 %cmp, label %far, label %fill
+fill:
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  %cmp2 = icmp ult i32 %val, 2
+  br i1 %cmp2, label %far, label %near
+near:
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  br label %far
+far:
+  call void @llvm.nacl.atomic.store.i32(i32 %val, i32* %ptr, i32 6)
+  ret void
+}
+; CHECK-LABEL: test_far_forward
+; CHECK:      {{[0-9a-f]+}}: 0f 82 {{.*}} jb [[FAR:[0-9a-f]+]]
+; CHECK:      {{[0-9a-f]+}}: 72 {{[0-9a-f]+}} jb [[FAR]]
+; CHECK:      [[FAR]]: {{.*}} mov DWORD PTR
+
 
-; Unlike forward branches to cfg nodes, "local" forward branches
-; always use a 1 byte displacement.
+; "Local" forward branches always use a 1 byte displacement, without
+; going through branch relaxation.
 ; Check local forward branches, followed by a near backward branch
 ; to make sure that the instruction size accounting for the forward
 ; branches are correct, by the time the backward branch is hit.
@@ -0,0 +1,80 @@
+; Tests that -mattr=avx lowers the vector arithmetic, compare, and shuffle
+; instructions to the VEX encoded three-operand forms, which do not need their
+; first source to be copied into the destination first. AVX is the highest x86
+; level, so -mattr=bmi2 still uses the SSE forms.
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -mattr=avx \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=AVX %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -Om1 -mattr=avx \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=AVX %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -mattr=sse4.1 \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=SSE %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -mattr=bmi2 \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=SSE \
+; RUN:   --implicit-check-not='{{[[:space:]]v[a-z]+ xmm}}' %s
+
+define internal <4 x i32> @add_v4i32(<4 x i32> %a, <4 x i32> %b) {
+entry:
+  %res = add <4 x i32> %a, %b
+  ret <4 x i32> %res
+}
+; AVX-LABEL: add_v4i32
+; AVX: vpaddd xmm{{[0-9]+}},xmm{{[0-9]+}},xmm{{[0-9]+}}
+; SSE-LABEL: add_v4i32
+; SSE: paddd xmm{{[0-9]+}},xmm{{[0-9]+}}
+
+define internal <4 x i32> @mul_v4i32(<4 x i32> %a, <4 x i32> %b) {
+entry:
+  %res = mul <4 x i32> %a, %b
+  ret <4 x i32> %res
+}
+; AVX-LABEL: mul_v4i32
+; AVX: vpmulld xmm{{[0-9]+}},xmm{{[0-9]+}},xmm{{[0-9]+}}
+; SSE-LABEL: mul_v4i32
+; SSE: pmulld xmm{{[0-9]+}},xmm{{[0-9]+}}
+
+; %a is still live after the fadd, so the SSE form needs a copy of it, while
+; the AVX form reads it in place.
+define internal <4 x float> @reuse_operand(<4 x float> %a, <4 x float> %b) {
+entry:
+  %sum = fadd <4 x float> %a, %b
+  %res = fmul <4 x float> %sum, %a
+  ret <4 x float> %res
+}
+; AVX-LABEL: reuse_operand
+; AVX: vaddps
+; AVX-NOT: movups
+; AVX: vmulps
+; SSE-LABEL: reuse_operand
+; SSE: movups
+; SSE: addps
+; SSE: mulps
+
+define internal <4 x i32> @sgt_v4i32(<4 x i32> %a, <4 x i32> %b) {
+entry:
+  %cmp = icmp sgt <4 x i32> %a, %b
+  %res = sext <4 x i1> %cmp to <4 x i32>
+  ret <4 x i32> %res
+}
+; AVX-LABEL: sgt_v4i32
+; AVX: vpcmpgtd xmm{{[0-9]+}},xmm{{[0-9]+}},xmm{{[0-9]+}}
+
+define internal float @fadd_f32(float %a, float %b) {
+entry:
+  %res = fadd float %a, %b
+  ret float %res
+}
+; AVX-LABEL: fadd_f32
+; AVX: vaddss xmm{{[0-9]+}},xmm{{[0-9]+}},
+
+define internal <4 x float> @insert_first(<4 x float> %v, float %e) {
+entry:
+  %res = insertelement <4 x float> %v, float %e, i32 0
+  ret <4 x float> %res
+}
+; AVX-LABEL: insert_first
+; AVX: vmovss xmm{{[0-9]+}},xmm{{[0-9]+}},xmm{{[0-9]+}}
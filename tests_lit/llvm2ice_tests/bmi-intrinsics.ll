@@ -0,0 +1,157 @@
+; Tests the lowering of the bit counting intrinsics and of variable shifts
+; with the -mattr=popcnt, -mattr=bmi, and -mattr=bmi2 instruction set levels.
+; The levels are cumulative, so bmi also enables popcnt, and bmi2 enables both.
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -mattr=sse4.1 \
+; RUN:   -allow-externally-defined-symbols \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=BASE %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -mattr=popcnt \
+; RUN:   -allow-externally-defined-symbols \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=POPCNT %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -mattr=bmi \
+; RUN:   -allow-externally-defined-symbols \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=BMI %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -Om1 -mattr=bmi \
+; RUN:   -allow-externally-defined-symbols \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=BMI %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -mattr=bmi2 \
+; RUN:   -allow-externally-defined-symbols \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=BMI2 %s
+
+declare i32 @llvm.ctlz.i32(i32, i1)
+declare i64 @llvm.ctlz.i64(i64, i1)
+declare i32 @llvm.cttz.i32(i32, i1)
+declare i64 @llvm.cttz.i64(i64, i1)
+declare i32 @llvm.ctpop.i32(i32)
+declare i64 @llvm.ctpop.i64(i64)
+
+define internal i32 @test_popcount_32(i32 %x) {
+entry:
+  %r = call i32 @llvm.ctpop.i32(i32 %x)
+  ret i32 %r
+}
+; BASE-LABEL: test_popcount_32
+; BASE: call {{.*}} R_{{.*}} __popcountsi2
+; POPCNT-LABEL: test_popcount_32
+; POPCNT-NOT: call
+; POPCNT: popcnt
+; BMI-LABEL: test_popcount_32
+; BMI: popcnt
+
+define internal i64 @test_popcount_64(i64 %x) {
+entry:
+  %r = call i64 @llvm.ctpop.i64(i64 %x)
+  ret i64 %r
+}
+; BASE-LABEL: test_popcount_64
+; BASE: call {{.*}} R_{{.*}} __popcountdi2
+; The two halves are counted separately and added, and the upper half of the
+; result is cleared.
+; POPCNT-LABEL: test_popcount_64
+; POPCNT-NOT: call
+; POPCNT: popcnt [[REG_LO:e..]],
+; POPCNT: popcnt [[REG_HI:e..]],
+; POPCNT: add [[REG_LO]],[[REG_HI]]
+; POPCNT: mov {{.*}},0x0
+
+define internal i32 @test_ctlz_32(i32 %x) {
+entry:
+  %r = call i32 @llvm.ctlz.i32(i32 %x, i1 false)
+  ret i32 %r
+}
+; LZCNT is defined for an input of 0, so no cmov or xor fixup is needed.
+; BASE-LABEL: test_ctlz_32
+; BASE: bsr
+; BASE: cmovne
+; POPCNT-LABEL: test_ctlz_32
+; POPCNT: bsr
+; BMI-LABEL: test_ctlz_32
+; BMI-NOT: bsr
+; BMI: lzcnt
+; BMI-NOT: cmov
+; BMI-NOT: xor
+; BMI: ret
+
+define internal i64 @test_ctlz_64(i64 %x) {
+entry:
+  %r = call i64 @llvm.ctlz.i64(i64 %x, i1 false)
+  ret i64 %r
+}
+; LZCNT of the upper half sets the carry flag when the upper half is zero, in
+; which case the result is 32 plus the count of the lower half.
+; BMI-LABEL: test_ctlz_64
+; BMI: lzcnt
+; BMI: add {{.*}},0x20
+; BMI: lzcnt
+; BMI: cmovb
+; BMI: ret
+
+define internal i32 @test_cttz_32(i32 %x) {
+entry:
+  %r = call i32 @llvm.cttz.i32(i32 %x, i1 false)
+  ret i32 %r
+}
+; BASE-LABEL: test_cttz_32
+; BASE: bsf
+; BASE: cmovne
+; BMI-LABEL: test_cttz_32
+; BMI-NOT: bsf
+; BMI: tzcnt
+; BMI-NOT: cmov
+; BMI: ret
+
+define internal i64 @test_cttz_64(i64 %x) {
+entry:
+  %r = call i64 @llvm.cttz.i64(i64 %x, i1 false)
+  ret i64 %r
+}
+; BMI-LABEL: test_cttz_64
+; BMI: tzcnt
+; BMI: add {{.*}},0x20
+; BMI: tzcnt
+; BMI: cmovb
+; BMI: ret
+
+; Variable shifts no longer need their count in cl with BMI2.
+define internal i32 @test_shl_var(i32 %a, i32 %b) {
+entry:
+  %r = shl i32 %a, %b
+  ret i32 %r
+}
+; BMI-LABEL: test_shl_var
+; BMI: shl {{.*}},cl
+; BMI2-LABEL: test_shl_var
+; BMI2-NOT: cl
+; BMI2: shlx
+; BMI2: ret
+
+define internal i32 @test_lshr_var(i32 %a, i32 %b) {
+entry:
+  %r = lshr i32 %a, %b
+  ret i32 %r
+}
+; BMI2-LABEL: test_lshr_var
+; BMI2: shrx
+
+define internal i32 @test_ashr_var(i32 %a, i32 %b) {
+entry:
+  %r = ashr i32 %a, %b
+  ret i32 %r
+}
+; BMI2-LABEL: test_ashr_var
+; BMI2: sarx
+
+; Shifts by a constant keep using the immediate form.
+define internal i32 @test_shl_const(i32 %a) {
+entry:
+  %r = shl i32 %a, 3
+  ret i32 %r
+}
+; BMI2-LABEL: test_shl_const
+; BMI2-NOT: shlx
+; BMI2: shl {{.*}},0x3
@@ -0,0 +1,28 @@
+; Tests that the high-level instructions deleted by lowering are removed from
+; the node's instruction list right after the node is lowered, even at -Om1
+; which never renumbers, unless -keep-deleted-insts retains them.
+
+; REQUIRES: allow_dump
+
+; RUN: %if --need=target_X8632 --command %p2i --target x8632 -i %s \
+; RUN:   --filetype=asm --args -Om1 -verbose=inst,del -threads=0 \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s
+; RUN: %if --need=target_X8632 --command %p2i --target x8632 -i %s \
+; RUN:   --filetype=asm --args -Om1 -verbose=inst,del -keep-deleted-insts \
+; RUN:   -threads=0 \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s --check-prefix=KEEP
+
+define internal i32 @add(i32 %a, i32 %b) {
+entry:
+  %c = add i32 %a, %b
+  ret i32 %c
+}
+
+; CHECK-LABEL: After initial x86 codegen
+; CHECK-NOT: //
+; CHECK: ret
+; CHECK: ================
+
+; KEEP-LABEL: After initial x86 codegen
+; KEEP: //{{.*}} = add i32
+; KEEP: ret
@@ -0,0 +1,28 @@
+; Tests that a compile server request can repeat a flag the server was started
+; with, and that the request's value wins. Also tests that the server refuses to
+; replace a file at the socket path that is not a socket.
+
+; REQUIRES: allow_llvm_ir_as_input
+
+; RUN: %{python} %{src_root}/pydir/szclient.py --socket %t.sock \
+; RUN:   --start-server "%pnacl_sz -O2 -filetype=obj -bitcode-format=llvm \
+; RUN:   -build-on-read=0" \
+; RUN:   -O2 -filetype=asm -bitcode-format=llvm -build-on-read=0 %s -o - \
+; RUN:   | FileCheck %s
+
+; RUN: echo keep > %t.file
+; RUN: not %pnacl_sz -compile-server=%t.file 2>&1 \
+; RUN:   | FileCheck --check-prefix=NOTSOCK %s
+; RUN: FileCheck --check-prefix=KEPT %s < %t.file
+
+define internal i32 @add_one(i32 %a) {
+entry:
+  %r = add i32 %a, 1
+  ret i32 %r
+}
+; CHECK-LABEL: add_one:
+; CHECK: add
+; CHECK: ret
+
+; NOTSOCK: LLVM ERROR: Compile server socket path exists and is not a socket
+; KEPT: keep
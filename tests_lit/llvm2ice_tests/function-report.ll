@@ -0,0 +1,35 @@
+; Tests that -function-report writes one line per translated function, as JSON
+; Lines or as CSV depending on the file name.
+
+; REQUIRES: allow_dump
+
+; RUN: %p2i --filetype=obj --output %t.o -i %s --args -O2 \
+; RUN:   -function-report=%t.jsonl
+; RUN: FileCheck %s < %t.jsonl
+
+; RUN: %p2i --filetype=obj --output %t.o -i %s --args -Om1 \
+; RUN:   -function-report=%t.csv
+; RUN: FileCheck %s --check-prefix=CSV < %t.csv
+
+define internal i32 @add(i32 %a, i32 %b) {
+entry:
+  %sum = add i32 %a, %b
+  ret i32 %sum
+}
+
+define internal i32 @max(i32 %a, i32 %b) {
+entry:
+  %cmp = icmp sgt i32 %a, %b
+  br i1 %cmp, label %first, label %second
+first:
+  ret i32 %a
+second:
+  ret i32 %b
+}
+
+; CHECK-DAG: {"name":"add","seq":2,"thread":"translator {{[0-9]+}}","input_bits":{{[0-9]+}},"insts_before":2,"insts_after":{{[0-9]+}},"spills":{{[0-9]+}},"fills":{{[0-9]+}},"code_bytes":{{[1-9][0-9]*}},"arena_bytes":{{[1-9][0-9]*}},"translate_sec":{{[0-9.]+}},"pass_sec":{"genHelpers":{{[0-9.]+}},{{.*}}"regAlloc":{{[0-9.]+}}{{.*}}}}
+; CHECK-DAG: {"name":"max","seq":3,{{.*}}"insts_before":4,
+
+; CSV: name,seq,thread,input_bits,insts_before,insts_after,spills,fills,code_bytes,arena_bytes,translate_sec,pass_sec
+; CSV-DAG: "add",2,"translator {{[0-9]+}}",{{[0-9]+}},2,{{[0-9]+}},{{[0-9]+}},{{[0-9]+}},{{[1-9][0-9]*}},{{[1-9][0-9]*}},{{[0-9.]+}},""
+; CSV-DAG: "max",3,"translator {{[0-9]+}}",{{[0-9]+}},4,
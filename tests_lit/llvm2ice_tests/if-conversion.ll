@@ -0,0 +1,111 @@
+; Tests that -enable-if-conversion replaces small branch diamonds and triangles
+; by selects, and that it leaves the branch when an arm has an instruction that
+; can't be speculated or is too long.
+
+; REQUIRES: allow_dump
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -enable-if-conversion \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s --check-prefix=NOCVT
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=asm --target x8632 \
+; RUN:   -i %s --args -O2 -enable-if-conversion -szstats \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s --check-prefix=STATS
+
+define internal i32 @diamond(i32 %a, i32 %b) {
+entry:
+  %cmp = icmp slt i32 %a, %b
+  br i1 %cmp, label %then, label %else
+then:
+  %x = add i32 %a, 1
+  br label %join
+else:
+  %y = sub i32 %b, 1
+  br label %join
+join:
+  %res = phi i32 [ %x, %then ], [ %y, %else ]
+  ret i32 %res
+}
+; CHECK-LABEL: diamond
+; CHECK-NOT: j{{l|ge}}
+; CHECK: cmov
+; CHECK: ret
+; NOCVT-LABEL: diamond
+; NOCVT: j{{l|ge}}
+
+define internal i32 @triangle(i32 %a, i32 %b) {
+entry:
+  %cmp = icmp ugt i32 %a, %b
+  br i1 %cmp, label %then, label %join
+then:
+  %x = shl i32 %a, 2
+  br label %join
+join:
+  %res = phi i32 [ %x, %then ], [ %b, %entry ]
+  ret i32 %res
+}
+; CHECK-LABEL: triangle
+; CHECK-NOT: j{{a|be}}
+; CHECK: cmov
+; CHECK: ret
+
+; A load may fault on the path where it was not executed.
+define internal i32 @no_convert_load(i32 %a, i32 %p) {
+entry:
+  %cmp = icmp eq i32 %a, 0
+  br i1 %cmp, label %then, label %join
+then:
+  %addr = inttoptr i32 %p to i32*
+  %v = load i32, i32* %addr, align 1
+  br label %join
+join:
+  %res = phi i32 [ %v, %then ], [ %a, %entry ]
+  ret i32 %res
+}
+; CHECK-LABEL: no_convert_load
+; CHECK: j{{e|ne}}
+; CHECK: ret
+
+; So may a division.
+define internal i32 @no_convert_div(i32 %a, i32 %b) {
+entry:
+  %cmp = icmp ne i32 %b, 0
+  br i1 %cmp, label %then, label %join
+then:
+  %q = sdiv i32 %a, %b
+  br label %join
+join:
+  %res = phi i32 [ %q, %then ], [ 0, %entry ]
+  ret i32 %res
+}
+; CHECK-LABEL: no_convert_div
+; CHECK: j{{e|ne}}
+; CHECK: idiv
+
+; The arms execute more than -if-conversion-max-insts instructions together.
+define internal i32 @no_convert_long(i32 %a, i32 %b) {
+entry:
+  %cmp = icmp slt i32 %a, %b
+  br i1 %cmp, label %then, label %else
+then:
+  %x1 = add i32 %a, 1
+  %x2 = mul i32 %x1, %b
+  %x3 = xor i32 %x2, 7
+  br label %join
+else:
+  %y1 = sub i32 %b, 1
+  %y2 = mul i32 %y1, %a
+  %y3 = or i32 %y2, 3
+  br label %join
+join:
+  %res = phi i32 [ %x3, %then ], [ %y3, %else ]
+  ret i32 %res
+}
+; CHECK-LABEL: no_convert_long
+; CHECK: j{{l|ge}}
+
+; STATS: |_FINAL_|IfCvt Diamnd|1
+; STATS: |_FINAL_|IfCvt Triang|1
@@ -0,0 +1,93 @@
+; Tests that -enable-inlining replaces calls to small leaf functions by copies
+; of their bodies, and leaves other calls alone.
+
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 -enable-inlining \
+; RUN:   -allow-externally-defined-symbols | FileCheck %s
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 -enable-inlining \
+; RUN:   -allow-externally-defined-symbols -threads=0 | FileCheck %s
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -Om1 -enable-inlining \
+; RUN:   -allow-externally-defined-symbols | FileCheck %s
+
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 -enable-inlining \
+; RUN:   -inline-threshold=1 -allow-externally-defined-symbols \
+; RUN:   | FileCheck %s --check-prefix=SMALL
+
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 \
+; RUN:   -allow-externally-defined-symbols | FileCheck %s --check-prefix=NOINLINE
+
+; The callees and the caller are held back in different batches.
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 -enable-inlining \
+; RUN:   -inline-max-pending-functions=2 -allow-externally-defined-symbols \
+; RUN:   | FileCheck %s --check-prefix=NOINLINE
+
+; RUN: %if --need=allow_dump --command %p2i --filetype=asm -i %s --args -O2 \
+; RUN:   -enable-inlining -allow-externally-defined-symbols -szstats \
+; RUN:   | %if --need=allow_dump --command FileCheck %s --check-prefix=STATS
+
+declare void @external(i32)
+
+define internal i32 @getField(i32 %ptr) {
+entry:
+  %addr = add i32 %ptr, 8
+  %addr.ptr = inttoptr i32 %addr to i32*
+  %val = load i32, i32* %addr.ptr, align 1
+  ret i32 %val
+}
+
+define internal void @setField(i32 %ptr, i32 %val) {
+entry:
+  %addr = add i32 %ptr, 8
+  %addr.ptr = inttoptr i32 %addr to i32*
+  store i32 %val, i32* %addr.ptr, align 1
+  ret void
+}
+; The callees are still translated.
+; CHECK-LABEL: getField
+; CHECK-LABEL: setField
+
+; Calls another function, so this is not a leaf.
+define internal void @wrapper(i32 %a) {
+entry:
+  call void @external(i32 %a)
+  ret void
+}
+
+; Has control flow, so this is not a single basic block.
+define internal i32 @abs(i32 %a) {
+entry:
+  %neg = icmp slt i32 %a, 0
+  br i1 %neg, label %negate, label %done
+negate:
+  %b = sub i32 0, %a
+  ret i32 %b
+done:
+  ret i32 %a
+}
+
+define internal i32 @caller(i32 %obj) {
+entry:
+  %old = call i32 @getField(i32 %obj)
+  %new = add i32 %old, 1
+  call void @setField(i32 %obj, i32 %new)
+  call void @wrapper(i32 %new)
+  %res = call i32 @abs(i32 %new)
+  ret i32 %res
+}
+; CHECK-LABEL: caller
+; CHECK-NOT: call {{.*}} getField
+; CHECK-NOT: call {{.*}} setField
+; CHECK: call {{.*}} R_{{.*}} wrapper
+; CHECK: call {{.*}} R_{{.*}} abs
+; CHECK: ret
+
+
+; SMALL-LABEL: caller
+; SMALL: call {{.*}} R_{{.*}} getField
+; SMALL: call {{.*}} R_{{.*}} setField
+
+; NOINLINE-LABEL: caller
+; NOINLINE: call {{.*}} R_{{.*}} getField
+; NOINLINE: call {{.*}} R_{{.*}} setField
+
+; STATS: |_FINAL_|Inline Cands|2
+; STATS: |_FINAL_|Inlined Call|2
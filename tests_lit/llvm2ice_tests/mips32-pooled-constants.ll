@@ -0,0 +1,50 @@
+; Tests that MIPS32 loads large immediates from the literal pool when
+; -randomize-pool-immediates=pool is given, and that the pools can be
+; reordered.
+
+; REQUIRES: allow_dump
+
+; RUN: %p2i --filetype=asm --target mips32 -i %s --args -O2 \
+; RUN:   -randomize-pool-immediates=pool -randomize-pool-threshold=0x1 \
+; RUN:   | FileCheck %s --check-prefix=POOL
+; RUN: %p2i --filetype=asm --target mips32 -i %s --args -Om1 \
+; RUN:   -randomize-pool-immediates=pool -randomize-pool-threshold=0x1 \
+; RUN:   | FileCheck %s --check-prefix=POOL
+
+; RUN: %p2i --filetype=asm --target mips32 -i %s --args -O2 \
+; RUN:   | FileCheck %s --check-prefix=NOPOOL
+
+; RUN: %p2i --filetype=asm --target mips32 -i %s --args -O2 -sz-seed=1 \
+; RUN:   -reorder-pooled-constants -randomize-pool-immediates=pool \
+; RUN:   -randomize-pool-threshold=0x1 \
+; RUN:   | FileCheck %s --check-prefix=REORDER
+
+define internal i32 @add_arg_plus_200000(i32 %arg) {
+entry:
+  %res = add i32 200000, %arg
+  ret i32 %res
+}
+; POOL-LABEL: add_arg_plus_200000
+; POOL: lui [[BASE:\$[a-z0-9]+]], %hi(.L$i32$00030d40)
+; POOL-NEXT: lw {{\$[a-z0-9]+}}, %lo(.L$i32$00030d40)([[BASE]])
+
+; NOPOOL-LABEL: add_arg_plus_200000
+; NOPOOL: lui [[REG:\$[a-z0-9]+]], 3
+; NOPOOL-NEXT: ori {{\$[a-z0-9]+}}, [[REG]], 3392
+
+define internal float @add_float_constants(float %arg) {
+entry:
+  %a = fadd float %arg, 1.500000e+00
+  %b = fadd float %a, 2.500000e+00
+  ret float %b
+}
+
+; POOL: .section .rodata.cst4
+; POOL: .L$i32$00030d40:
+; POOL-NEXT: .word 0x30d40
+
+; NOPOOL-NOT: .L$i32$
+
+; REORDER-DAG: .L$float$3fc00000:
+; REORDER-DAG: .L$float$40200000:
+; REORDER-DAG: .L$i32$00030d40:
@@ -453,9 +453,9 @@ entry:
   ret i32 %r
 }
 ; CHECK-LABEL: test_ctlz_32
-; TODO(jvoung): If we detect that LZCNT is supported, then use that
-; and avoid the need to do the cmovne and xor stuff to guarantee that
-; the result is well-defined w/ input == 0.
+; Without -mattr=bmi there is no LZCNT, so the cmovne and xor stuff is needed
+; to guarantee that the result is well-defined w/ input == 0. See
+; bmi-intrinsics.ll for the LZCNT lowering.
 ; CHECK: bsr [[REG_TMP:e.*]],{{.*}}
 ; CHECK: mov [[REG_RES:e.*]],0x3f
 ; CHECK: cmovne [[REG_RES]],[[REG_TMP]]
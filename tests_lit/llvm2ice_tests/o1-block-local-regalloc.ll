@@ -0,0 +1,61 @@
+; Tests the -O1 tier, which register-allocates the Variables that are local to
+; one basic block without computing global liveness, and leaves the Variables
+; that are live across blocks on the stack like -Om1.
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O1 -allow-externally-defined-symbols \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -Om1 -allow-externally-defined-symbols \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=OM1 %s
+
+declare void @external()
+
+; All the temporaries are local to the entry block, so none of them is stored
+; to the stack at -O1.
+define internal i32 @local(i32 %a, i32 %b) {
+entry:
+  %c = add i32 %a, %b
+  %d = mul i32 %c, %a
+  %e = sub i32 %d, %b
+  ret i32 %e
+}
+; CHECK-LABEL: local
+; CHECK-NOT: mov DWORD PTR [esp
+; CHECK: ret
+; OM1-LABEL: local
+; OM1: mov DWORD PTR [esp+{{.*}}],e{{..}}
+; OM1: ret
+
+; %c lives across the call, so it gets a callee-save register.
+define internal i32 @across_call(i32 %a, i32 %b) {
+entry:
+  %c = add i32 %a, %b
+  call void @external()
+  %d = add i32 %c, %b
+  ret i32 %d
+}
+; CHECK-LABEL: across_call
+; CHECK: push {{e(bx|si|di)}}
+; CHECK: call
+; CHECK: ret
+
+; %sum is live across blocks, so it is stored to its stack slot, while the
+; block-local temporaries still get registers.
+define internal i32 @across_blocks(i32 %a, i32 %b) {
+entry:
+  %sum = add i32 %a, %b
+  %cmp = icmp sgt i32 %sum, 0
+  br i1 %cmp, label %pos, label %neg
+pos:
+  %x = shl i32 %sum, 1
+  ret i32 %x
+neg:
+  %y = sub i32 0, %sum
+  ret i32 %y
+}
+; CHECK-LABEL: across_blocks
+; CHECK: add [[REG:e..]],
+; CHECK: mov DWORD PTR [esp+{{.*}}],[[REG]]
+; CHECK: shl
+; CHECK: ret
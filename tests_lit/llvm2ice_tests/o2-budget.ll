@@ -0,0 +1,36 @@
+; Tests that -o2-max-insts and -o2-max-vars demote functions that exceed the
+; budget to -Om1, except for those selected by -force-O2.
+
+; REQUIRES: allow_dump
+
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 -o2-max-insts=4 \
+; RUN:   -verbose=status -szstats | FileCheck %s
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 -o2-max-vars=5 \
+; RUN:   -verbose=status -szstats | FileCheck %s
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 -o2-max-insts=4 \
+; RUN:   -force-O2=big -verbose=status -szstats \
+; RUN:   | FileCheck %s --check-prefix=FORCED
+
+define internal i32 @small(i32 %a) {
+entry:
+  %b = add i32 %a, 1
+  ret i32 %b
+}
+
+define internal i32 @big(i32 %a, i32 %b) {
+entry:
+  %c = add i32 %a, %b
+  %d = mul i32 %c, %a
+  %e = sub i32 %d, %b
+  %f = xor i32 %e, %c
+  %g = or i32 %f, %d
+  ret i32 %g
+}
+
+; CHECK-NOT: Demoting small
+; CHECK: Demoting big to -Om1: {{[0-9]+}} instructions, {{[0-9]+}} variables
+; CHECK-NOT: Demoting
+; CHECK: |_FINAL_|O2 Demotions|1
+
+; FORCED-NOT: Demoting
+; FORCED: |_FINAL_|O2 Demotions|0
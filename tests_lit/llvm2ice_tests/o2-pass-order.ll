@@ -0,0 +1,30 @@
+; Tests -o2-pass-order, which replaces the target's O2 pass pipeline with the
+; listed passes.
+
+; REQUIRES: allow_dump
+
+; Leaving out the optional passes still produces working code.
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 \
+; RUN:   -o2-pass-order=genHelpers,processAllocas,phiLowering,argLowering,genCode,regAlloc,advancedPhiLowering,genFrame \
+; RUN:   | FileCheck %s
+
+; RUN: %p2i --expect-fail --filetype=obj -i %s --args -O2 \
+; RUN:   -o2-pass-order=genHelpers,noSuchPass 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=UNKNOWN
+
+; RUN: %p2i --expect-fail --filetype=obj -i %s --args -O2 \
+; RUN:   -o2-pass-order=genHelpers,processAllocas,phiLowering,argLowering,genCode 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=MISSING
+
+define internal i32 @add(i32 %a, i32 %b) {
+entry:
+  %sum = add i32 %a, %b
+  ret i32 %sum
+}
+; CHECK-LABEL: add
+; CHECK: add
+; CHECK: ret
+
+; UNKNOWN: LLVM ERROR: Unknown pass 'noSuchPass' in pass order; this target's passes are: {{.*}}genCode
+
+; MISSING: LLVM ERROR: Pass 'regAlloc' is required but missing from pass order
@@ -0,0 +1,52 @@
+; Tests that instructions inserted by lowering keep the sparse instruction
+; numbering valid, and that -szstats counts the full renumbering passes.  -Om1
+; never needs the numbering, so it never renumbers.
+
+; REQUIRES: allow_dump
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s
+
+; The stats are printed before the disassembly, so they are checked separately.
+; RUN: %if --need=target_X8632 --command %p2i --filetype=asm --target x8632 \
+; RUN:   -i %s --args -O2 -szstats \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s --check-prefix=STATS
+; RUN: %p2i --filetype=asm -i %s --args -Om1 -szstats \
+; RUN:   | FileCheck %s --check-prefix=OM1
+
+define internal i32 @straight(i32 %a, i32 %b) {
+entry:
+  %c = add i32 %a, %b
+  %d = mul i32 %c, %a
+  %e = udiv i32 %d, %b
+  ret i32 %e
+}
+; CHECK-LABEL: straight
+; CHECK: add
+; CHECK: imul
+; CHECK: div
+; CHECK: ret
+
+define internal i32 @branches(i32 %a, i32 %b) {
+entry:
+  %cmp = icmp sgt i32 %a, %b
+  br i1 %cmp, label %first, label %second
+first:
+  %x = shl i32 %a, 3
+  br label %join
+second:
+  %y = sub i32 %b, %a
+  br label %join
+join:
+  %r = phi i32 [ %x, %first ], [ %y, %second ]
+  ret i32 %r
+}
+; CHECK-LABEL: branches
+; CHECK: cmp
+; CHECK: shl
+; CHECK: sub
+; CHECK: ret
+
+; STATS: |_FINAL_|Renumberings|{{[1-9][0-9]*}}
+; OM1: |_FINAL_|Renumberings|0
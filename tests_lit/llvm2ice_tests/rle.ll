@@ -0,0 +1,77 @@
+; Tests that -enable-rle replaces reloads of a location by the value that was
+; last loaded from or stored to it in the same block, and that stores which may
+; alias and calls invalidate the known values.
+
+; REQUIRES: allow_dump
+
+; RUN: %p2i -i %s --args -O2 -enable-rle -verbose=inst -threads=0 \
+; RUN:   -allow-externally-defined-symbols -szstats | FileCheck %s
+
+declare void @external()
+
+define internal i32 @forward(i32 %p, i32 %v) {
+entry:
+  %field = add i32 %p, 4
+  %ptr = inttoptr i32 %field to i32*
+  store i32 %v, i32* %ptr, align 1
+  %x = load i32, i32* %ptr, align 1
+  %r = add i32 %x, %v
+  ret i32 %r
+}
+; CHECK-LABEL: After redundant load elimination
+; CHECK-LABEL: define internal i32 @forward
+; CHECK: store i32 %v
+; CHECK-NEXT: %x = i32 %v
+
+; The store to a different offset from the same base can't overwrite the field.
+define internal i32 @reload_disjoint(i32 %p, i32 %v) {
+entry:
+  %f4 = add i32 %p, 4
+  %f8 = add i32 %p, 8
+  %ptr4 = inttoptr i32 %f4 to i32*
+  %ptr8 = inttoptr i32 %f8 to i32*
+  %a = load i32, i32* %ptr4, align 1
+  store i32 %v, i32* %ptr8, align 1
+  %b = load i32, i32* %ptr4, align 1
+  %r = add i32 %a, %b
+  ret i32 %r
+}
+; CHECK-LABEL: After redundant load elimination
+; CHECK-LABEL: define internal i32 @reload_disjoint
+; CHECK: %a = load i32
+; CHECK: store i32 %v
+; CHECK-NEXT: %b = i32 %a
+
+; A store through an unrelated pointer may alias.
+define internal i32 @may_alias(i32 %p, i32 %q, i32 %v) {
+entry:
+  %ptr = inttoptr i32 %p to i32*
+  %other = inttoptr i32 %q to i32*
+  %a = load i32, i32* %ptr, align 1
+  store i32 %v, i32* %other, align 1
+  %b = load i32, i32* %ptr, align 1
+  %r = add i32 %a, %b
+  ret i32 %r
+}
+; CHECK-LABEL: After redundant load elimination
+; CHECK-LABEL: define internal i32 @may_alias
+; CHECK: store i32 %v
+; CHECK-NEXT: %b = load i32
+
+; A call is a barrier.
+define internal i32 @call_barrier(i32 %p) {
+entry:
+  %ptr = inttoptr i32 %p to i32*
+  %a = load i32, i32* %ptr, align 1
+  call void @external()
+  %b = load i32, i32* %ptr, align 1
+  %r = add i32 %a, %b
+  ret i32 %r
+}
+; CHECK-LABEL: After redundant load elimination
+; CHECK-LABEL: define internal i32 @call_barrier
+; CHECK: call void {{.*}}external
+; CHECK-NEXT: %b = load i32
+
+; CHECK: |_FINAL_|RLE Loads   |1
+; CHECK: |_FINAL_|RLE Forwards|1
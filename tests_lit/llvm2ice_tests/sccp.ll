@@ -0,0 +1,99 @@
+; Tests that -enable-sccp folds constants through arithmetic, compares, casts,
+; phis, branches and switches, and removes the code that becomes dead.
+
+; REQUIRES: allow_dump
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -enable-sccp \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s --check-prefix=NOSCCP
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=asm --target x8632 \
+; RUN:   -i %s --args -O2 -enable-sccp -szstats \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s --check-prefix=STATS
+
+define internal i32 @fold_arith() {
+entry:
+  %a = add i32 2, 3
+  %b = mul i32 %a, 4
+  %c = trunc i32 %b to i8
+  %d = sext i8 %c to i32
+  ret i32 %d
+}
+; CHECK-LABEL: fold_arith
+; CHECK-NOT: add
+; CHECK-NOT: imul
+; CHECK: mov eax,0x14
+; CHECK: ret
+; NOSCCP-LABEL: fold_arith
+; NOSCCP: add
+
+define internal i32 @fold_branch() {
+entry:
+  %cmp = icmp slt i32 1, 2
+  br i1 %cmp, label %then, label %else
+then:
+  ret i32 10
+else:
+  ret i32 20
+}
+; CHECK-LABEL: fold_branch
+; CHECK-NOT: cmp
+; CHECK: mov eax,0xa
+; CHECK-NOT: 0x14
+; CHECK: ret
+
+; %k stays 7 around the loop, so the add after the loop is folded even though
+; %i is not constant.
+define internal i32 @loop_phi(i32 %n) {
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %k = phi i32 [ 7, %entry ], [ %k, %loop ]
+  %i.next = add i32 %i, 1
+  %cmp = icmp ult i32 %i.next, %n
+  br i1 %cmp, label %loop, label %exit
+exit:
+  %r = add i32 %k, 1
+  ret i32 %r
+}
+; CHECK-LABEL: loop_phi
+; CHECK: cmp
+; CHECK: mov eax,0x8
+; CHECK: ret
+
+define internal i32 @fold_switch() {
+entry:
+  %s = add i32 1, 2
+  switch i32 %s, label %default [
+    i32 1, label %one
+    i32 3, label %three
+  ]
+one:
+  ret i32 11
+three:
+  ret i32 33
+default:
+  ret i32 99
+}
+; CHECK-LABEL: fold_switch
+; CHECK-NOT: cmp
+; CHECK: mov eax,0x21
+; CHECK-NOT: 0x63
+; CHECK: ret
+
+; Division by zero is left for the target to lower.
+define internal i32 @no_fold_div_by_zero() {
+entry:
+  %q = udiv i32 7, 0
+  ret i32 %q
+}
+; CHECK-LABEL: no_fold_div_by_zero
+; CHECK: div
+
+; STATS: |_FINAL_|SCCP Folds  |{{[1-9][0-9]*}}
+; STATS: |_FINAL_|SCCP DeadIns|{{[1-9][0-9]*}}
+; STATS: |_FINAL_|SCCP DeadBBs|{{[1-9][0-9]*}}
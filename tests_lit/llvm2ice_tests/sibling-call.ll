@@ -0,0 +1,97 @@
+; Tests that tail calls whose arguments are all passed in registers are lowered
+; as a jump to the callee after the epilog.
+
+; RUN: %p2i --target=x8632 --filetype=obj --disassemble -i %s --args -O2 \
+; RUN:   -allow-externally-defined-symbols \
+; RUN:   | FileCheck %s --check-prefix=X8632
+; RUN: %p2i --target=x8664 --filetype=obj --disassemble -i %s --args -O2 \
+; RUN:   -allow-externally-defined-symbols \
+; RUN:   | FileCheck %s --check-prefix=X8664
+; RUN: %p2i --target=x8664 --filetype=obj --disassemble -i %s --args -Om1 \
+; RUN:   -allow-externally-defined-symbols \
+; RUN:   | FileCheck %s --check-prefix=X8664
+; RUN: %p2i --target=x8664 --filetype=obj --disassemble -i %s --args -O2 \
+; RUN:   -allow-externally-defined-symbols -enable-sibling-calls=0 \
+; RUN:   | FileCheck %s --check-prefix=NOSIB
+
+; RUN: %if --need=target_ARM32 \
+; RUN:   --command %p2i --filetype=obj --disassemble --target arm32 \
+; RUN:   -i %s --args -O2 -allow-externally-defined-symbols \
+; RUN:   | %if --need=target_ARM32 \
+; RUN:   --command FileCheck --check-prefix ARM32 %s
+; RUN: %if --need=target_ARM32 --need=allow_dump \
+; RUN:   --command %p2i --filetype=asm --target arm32 \
+; RUN:   -i %s --args -O2 -allow-externally-defined-symbols \
+; RUN:   | %if --need=target_ARM32 --need=allow_dump \
+; RUN:   --command FileCheck --check-prefix ARM32-ASM %s
+
+declare void @noArgs()
+declare i32 @twoArgs(i32, i32)
+declare i32 @manyArgs(i32, i32, i32, i32, i32, i32, i32)
+
+define internal void @tailNoArgs() {
+entry:
+  tail call void @noArgs()
+  ret void
+}
+; X8632-LABEL: tailNoArgs
+; X8632-NOT: call
+; X8632: jmp {{.*}} R_386_PC32 noArgs
+; X8664-LABEL: tailNoArgs
+; X8664-NOT: call
+; X8664: jmp {{.*}} R_X86_64_PC32 noArgs
+; NOSIB-LABEL: tailNoArgs
+; NOSIB: call {{.*}} R_X86_64_PC32 noArgs
+; NOSIB: ret
+; ARM32-LABEL: tailNoArgs
+; ARM32-NOT: bl
+; ARM32: b {{.*}} R_ARM_JUMP24 noArgs
+; ARM32-ASM-LABEL: tailNoArgs
+; ARM32-ASM: b noArgs
+
+define internal i32 @tailTwoArgs(i32 %a, i32 %b) {
+entry:
+  %sum = add i32 %a, %b
+  %res = tail call i32 @twoArgs(i32 %sum, i32 %b)
+  ret i32 %res
+}
+; X8664-LABEL: tailTwoArgs
+; X8664-NOT: call
+; X8664: jmp {{.*}} R_X86_64_PC32 twoArgs
+; ARM32-LABEL: tailTwoArgs
+; ARM32-NOT: bl
+; ARM32: b {{.*}} R_ARM_JUMP24 twoArgs
+
+; The x86-32 calling convention passes these on the stack, so this remains a
+; regular call.
+; X8632-LABEL: tailTwoArgs
+; X8632: call {{.*}} R_386_PC32 twoArgs
+; X8632: ret
+
+; Not a tail call, since the result is modified before being returned.
+define internal i32 @notTail(i32 %a) {
+entry:
+  %res = tail call i32 @twoArgs(i32 %a, i32 %a)
+  %inc = add i32 %res, 1
+  ret i32 %inc
+}
+; X8664-LABEL: notTail
+; X8664: call {{.*}} R_X86_64_PC32 twoArgs
+; X8664: ret
+; ARM32-LABEL: notTail
+; ARM32: bl {{.*}} R_ARM_CALL twoArgs
+; ARM32: bx lr
+
+; Arguments passed on the stack are not handled.
+define internal i32 @stackArgs(i32 %a) {
+entry:
+  %res = tail call i32 @manyArgs(i32 %a, i32 %a, i32 %a, i32 %a, i32 %a,
+                                 i32 %a, i32 %a)
+  ret i32 %res
+}
+; X8664-LABEL: stackArgs
+; X8664: call {{.*}} R_X86_64_PC32 manyArgs
+; X8664: ret
+; ARM32-LABEL: stackArgs
+; ARM32: bl {{.*}} R_ARM_CALL manyArgs
+; ARM32: bx lr
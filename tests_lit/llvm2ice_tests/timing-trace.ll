@@ -0,0 +1,31 @@
+; Tests that -timing-trace writes the timer events of every thread in the
+; Chrome trace event format.
+
+; REQUIRES: allow_dump
+
+; RUN: %p2i --filetype=obj --output %t.o -i %s --args -O2 -threads=2 \
+; RUN:   -timing-trace=%t.json
+; RUN: FileCheck %s < %t.json
+
+; RUN: %p2i --filetype=obj --output %t.o -i %s --args -O2 -threads=0 \
+; RUN:   -timing-trace=%t.seq.json
+; RUN: FileCheck %s --check-prefix=SEQ < %t.seq.json
+
+define internal i32 @add(i32 %a, i32 %b) {
+entry:
+  %sum = add i32 %a, %b
+  ret i32 %sum
+}
+
+; CHECK: {"traceEvents":[
+; CHECK-DAG: "name":"thread_name","args":{"name":"main"}
+; CHECK-DAG: "name":"thread_name","args":{"name":"translator 0"}
+; CHECK-DAG: "name":"thread_name","args":{"name":"translator 1"}
+; CHECK-DAG: "name":"thread_name","args":{"name":"emitter"}
+; CHECK-DAG: {"ph":"B",{{.*}}"name":"pass.regAlloc"}
+; CHECK-DAG: {"ph":"E",{{.*}}"name":"pass.regAlloc"}
+; CHECK: ]}
+
+; SEQ: "name":"thread_name","args":{"name":"main"}
+; SEQ-NOT: "name":"translator
+; SEQ: {"ph":"B","pid":1,"tid":0,"ts":{{[0-9.]+}},"cat":"Total across all functions","name":"pass.regAlloc"}
@@ -0,0 +1,77 @@
+; Tests that functions replayed from the translation cache are emitted the
+; same way as when they are translated, including their relocations, pooled
+; floating point constants, and jump tables, and that changing a code
+; generation flag misses the cache.
+
+; REQUIRES: allow_dump
+
+; RUN: rm -rf %t.cache
+; RUN: %p2i --filetype=obj --output %t.miss.o -i %s --args -O2 \
+; RUN:   -allow-externally-defined-symbols -translation-cache=%t.cache \
+; RUN:   -szstats \
+; RUN:   | FileCheck --check-prefix=MISS %s
+; RUN: %p2i --filetype=obj --output %t.hit.o -i %s --args -O2 \
+; RUN:   -allow-externally-defined-symbols -translation-cache=%t.cache \
+; RUN:   -szstats \
+; RUN:   | FileCheck --check-prefix=HIT %s
+; RUN: cmp %t.miss.o %t.hit.o
+; A flag that changes the generated code must not reuse the cached code.
+; RUN: %p2i --filetype=obj --output %t.sccp.o -i %s --args -O2 \
+; RUN:   -allow-externally-defined-symbols -translation-cache=%t.cache \
+; RUN:   -enable-sccp -szstats \
+; RUN:   | FileCheck --check-prefix=MISS %s
+; RUN: %p2i --filetype=obj --disassemble -i %s --args -O2 \
+; RUN:   -allow-externally-defined-symbols -translation-cache=%t.cache \
+; RUN:   | FileCheck %s
+
+@global = internal global [4 x i8] zeroinitializer, align 4
+
+declare i32 @external(i32)
+
+define internal float @use_float_pool(float %a) {
+entry:
+  %add = fadd float %a, 1.500000e+00
+  ret float %add
+}
+; CHECK-LABEL: use_float_pool
+; CHECK: addss {{.*}} R_386_32 {{.*}}3fc00000
+
+define internal i32 @use_call_and_global(i32 %a) {
+entry:
+  %addr = bitcast [4 x i8]* @global to i32*
+  %v = load i32, i32* %addr, align 4
+  %sum = add i32 %a, %v
+  %r = call i32 @external(i32 %sum)
+  ret i32 %r
+}
+; CHECK-LABEL: use_call_and_global
+; CHECK: R_386_32 {{.*}}global
+; CHECK: call {{.*}} R_386_PC32 external
+
+define internal i32 @use_jump_table(i32 %a) {
+entry:
+  switch i32 %a, label %default [
+    i32 1, label %one
+    i32 2, label %two
+    i32 3, label %three
+    i32 4, label %four
+  ]
+one:
+  ret i32 10
+two:
+  ret i32 20
+three:
+  ret i32 30
+four:
+  ret i32 40
+default:
+  ret i32 0
+}
+; CHECK-LABEL: use_jump_table
+; CHECK: R_386_32 .{{.*}}use_jump_table$jumptable
+
+; MISS: |_FINAL_|TCache Hits |0
+; MISS: |_FINAL_|TCache Miss |3
+
+; HIT: |_FINAL_|TCache Hits |3
+; HIT: |_FINAL_|TCache Miss |0
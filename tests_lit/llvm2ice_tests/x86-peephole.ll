@@ -0,0 +1,103 @@
+; Tests the post-regalloc x86 peephole patterns of -x86-peephole, and their hit
+; counters in the -szstats output.
+
+; REQUIRES: allow_dump
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -x86-peephole \
+; RUN:   | %if --need=target_X8632 --command FileCheck %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=OFF %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=obj --disassemble \
+; RUN:   --target x8632 -i %s --args -O2 -x86-peephole -sz-seed=1 \
+; RUN:   -randomize-pool-immediates=randomize \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=BLIND %s
+
+; RUN: %if --need=target_X8632 --command %p2i --filetype=asm --target x8632 \
+; RUN:   -i %s --args -O2 -x86-peephole -szstats \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=STATS %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=asm --target x8632 \
+; RUN:   -i %s --args -Om1 -x86-peephole -szstats \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=OM1 %s
+; RUN: %if --need=target_X8632 --command %p2i --filetype=asm --target x8632 \
+; RUN:   -i %s --args -O2 -x86-peephole -asm-verbose -szstats \
+; RUN:   | %if --need=target_X8632 --command FileCheck --check-prefix=VERBOSE %s
+
+; The comparison against zero becomes a test of the register with itself.
+define internal i32 @cmp_zero(i32 %a, i32 %b) {
+entry:
+  %sum = add i32 %a, %b
+  %cmp = icmp eq i32 %sum, 0
+  br i1 %cmp, label %zero, label %nonzero
+zero:
+  ret i32 1
+nonzero:
+  ret i32 %sum
+}
+; CHECK-LABEL: cmp_zero
+; CHECK-NOT: cmp
+; CHECK: test [[REG:e..]],[[REG]]
+; CHECK-NEXT: j{{e|ne}}
+; OFF-LABEL: cmp_zero
+; OFF: cmp e{{..}},0x0
+
+; At -Om1, each value is stored to its stack slot and reloaded right away by
+; the next instruction, so the reload becomes a register move or disappears.
+define internal i32 @spill_reload(i32 %a, i32 %b) {
+entry:
+  %x = add i32 %a, %b
+  %y = add i32 %x, %a
+  ret i32 %y
+}
+
+; A blinded constant is materialized as "mov reg, imm+cookie" followed by
+; "lea reg, [reg-cookie]", which becomes an add when the flags are dead.
+define internal i32 @lea_to_add(i32 %a) {
+entry:
+  %sum = add i32 %a, 300000
+  ret i32 %sum
+}
+; BLIND-LABEL: lea_to_add
+; BLIND: mov [[REG:e..]],0x{{[0-9a-f]+}}
+; BLIND-NEXT: add [[REG]],0x{{[0-9a-f]+}}
+; BLIND-NOT: lea
+
+; Here the blinded constant is materialized between the cmp and the cmov that
+; reads its flags, so the lea must stay.
+define internal i32 @lea_flags_live(i32 %a, i32 %b, i32 %c) {
+entry:
+  %cmp = icmp slt i32 %a, %b
+  %sel = select i1 %cmp, i32 %c, i32 300000
+  ret i32 %sel
+}
+; BLIND-LABEL: lea_flags_live
+; BLIND: cmp
+; BLIND: mov [[REG:e..]],0x{{[0-9a-f]+}}
+; BLIND-NEXT: lea [[REG]],{{[[]}}[[REG]]{{[-+]}}0x{{[0-9a-f]+}}{{[]]}}
+; BLIND: cmov
+
+; In the tail of the 64-bit shift, the second move overwrites the source of the
+; first one rather than its destination, so the first one is not dead.
+define internal i64 @dead_mov_kept(i64 %a, i64 %b) {
+entry:
+  %shr = lshr i64 %a, %b
+  ret i64 %shr
+}
+; CHECK-LABEL: dead_mov_kept
+; CHECK: shrd
+; CHECK: mov [[LO:e..]],[[HI:e..]]
+; CHECK-NEXT: mov [[HI]],0x0
+; STATS: |dead_mov_kept{{[^|]*}}|PH DeadMov  |0
+
+; STATS: |_FINAL_|PH SelfMove |{{[1-9]}}
+; STATS: |_FINAL_|PH CmpZero  |{{[1-9]}}
+; OM1: |_FINAL_|PH SpillLoad|{{[1-9]}}
+
+; With -asm-verbose, nothing is rewritten, which keeps the live range
+; annotations right.
+; VERBOSE: |_FINAL_|PH SelfMove |0
+; VERBOSE-NEXT: |_FINAL_|PH DeadMov  |0
+; VERBOSE-NEXT: |_FINAL_|PH CmpZero  |0
+; VERBOSE-NEXT: |_FINAL_|PH LeaToAdd |0
+; VERBOSE-NEXT: |_FINAL_|PH SpillLoad|0
@@ -238,6 +238,36 @@ TEST_F(AssemblerX8632Test, Jmp) {
 #undef TestImplAddr
 }
 
+TEST_F(AssemblerX8632LowLevelTest, RelaxedJumps) {
+  // Relaxable branches start out with a rel8 displacement. Emitting the code
+  // again after a branch did not reach gives that branch, and only that
+  // branch, a rel32 displacement.
+  static const int Owner = 0;
+  auto EmitCode = [this](SizeT NumHlts) {
+    Label Done;
+    __ j(Cond::Br_e, &Done, &Owner, 0);
+    __ jmp(&Done, &Owner, 1);
+    for (SizeT I = 0; I < NumHlts; ++I)
+      __ hlt();
+    __ bind(&Done);
+  };
+
+  EmitCode(0x10);
+  EXPECT_FALSE(__ needsReemission());
+  ASSERT_EQ(4u + 0x10, codeBytesSize());
+  ASSERT_TRUE(verifyBytes<4>(codeBytes(), 0x74, 0x12, 0xEB, 0x10));
+
+  reset();
+  EmitCode(0x7E);
+  EXPECT_TRUE(__ needsReemission());
+  __ resetForReemission();
+  EmitCode(0x7E);
+  EXPECT_FALSE(__ needsReemission());
+  ASSERT_EQ(8u + 0x7E, codeBytesSize());
+  ASSERT_TRUE(verifyBytes<8>(codeBytes(), 0x0F, 0x84, 0x80, 0x00, 0x00, 0x00,
+                             0xEB, 0x7E));
+}
+
 } // end of anonymous namespace
 } // end of namespace Test
 } // end of namespace X8632
@@ -673,6 +673,159 @@ TEST_F(AssemblerX8632LowLevelTest, Cmp) {
 #undef TestRegReg
 }
 
+TEST_F(AssemblerX8632LowLevelTest, BitCount) {
+#define TestRegReg(Inst, Dst, Src, OpType, ByteCountUntyped, ...)              \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Src ", " #OpType ", " #ByteCountUntyped      \
+        ",  " #__VA_ARGS__ ")";                                                \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, GPRRegister::Encoded_Reg_##Dst,                  \
+            GPRRegister::Encoded_Reg_##Src);                                   \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+#define TestRegAddrBase(Inst, Dst, Base, Disp, OpType, ByteCountUntyped, ...)  \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Base ", " #Disp ", " #OpType                 \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, GPRRegister::Encoded_Reg_##Dst,                  \
+            Address(GPRRegister::Encoded_Reg_##Base, Disp,                     \
+                    AssemblerFixup::NoFixup));                                 \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+  // popcnt, lzcnt, and tzcnt are bsf's encoding with an F3 prefix, which is
+  // emitted after the operand size override.
+  TestRegReg(popcnt, eax, ecx, i32, 4, 0xF3, 0x0F, 0xB8, 0xC1);
+  TestRegReg(popcnt, edx, ebx, i16, 5, 0x66, 0xF3, 0x0F, 0xB8, 0xD3);
+  TestRegReg(lzcnt, ecx, edx, i32, 4, 0xF3, 0x0F, 0xBD, 0xCA);
+  TestRegReg(lzcnt, edi, esi, i16, 5, 0x66, 0xF3, 0x0F, 0xBD, 0xFE);
+  TestRegReg(tzcnt, esi, edi, i32, 4, 0xF3, 0x0F, 0xBC, 0xF7);
+  TestRegReg(tzcnt, ebx, eax, i16, 5, 0x66, 0xF3, 0x0F, 0xBC, 0xD8);
+
+  TestRegAddrBase(popcnt, eax, ecx, 0, i32, 4, 0xF3, 0x0F, 0xB8, 0x01);
+  TestRegAddrBase(lzcnt, edx, ebx, 0x40, i32, 5, 0xF3, 0x0F, 0xBD, 0x53, 0x40);
+  TestRegAddrBase(tzcnt, ecx, esi, 0, i16, 5, 0x66, 0xF3, 0x0F, 0xBC, 0x0E);
+
+#undef TestRegAddrBase
+#undef TestRegReg
+}
+
+TEST_F(AssemblerX8632LowLevelTest, Shiftx) {
+#define TestRegRegReg(Inst, Dst, Src, Shifter, OpType, ByteCountUntyped, ...)  \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Src ", " #Shifter ", " #OpType               \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, GPRRegister::Encoded_Reg_##Dst,                  \
+            GPRRegister::Encoded_Reg_##Src,                                    \
+            GPRRegister::Encoded_Reg_##Shifter);                               \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+#define TestRegAddrBaseReg(Inst, Dst, Base, Disp, Shifter, OpType,             \
+                           ByteCountUntyped, ...)                              \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Base ", " #Disp ", " #Shifter ", " #OpType   \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, GPRRegister::Encoded_Reg_##Dst,                  \
+            Address(GPRRegister::Encoded_Reg_##Base, Disp,                     \
+                    AssemblerFixup::NoFixup),                                  \
+            GPRRegister::Encoded_Reg_##Shifter);                               \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+  // VEX.LZ.0F38.W0 F7 /r, with the shift count in VEX.vvvv, and VEX.pp
+  // selecting 66 for shlx, F2 for shrx, and F3 for sarx.
+  TestRegRegReg(shlx, eax, ecx, edx, i32, 5, 0xC4, 0xE2, 0x69, 0xF7, 0xC1);
+  TestRegRegReg(shlx, edi, esi, ecx, i32, 5, 0xC4, 0xE2, 0x71, 0xF7, 0xFE);
+  TestRegRegReg(shrx, ebx, esi, edi, i32, 5, 0xC4, 0xE2, 0x43, 0xF7, 0xDE);
+  TestRegRegReg(sarx, ecx, eax, ebx, i32, 5, 0xC4, 0xE2, 0x62, 0xF7, 0xC8);
+
+  TestRegAddrBaseReg(shlx, eax, ebx, 0x10, ecx, i32, 6, 0xC4, 0xE2, 0x71,
+                     0xF7, 0x43, 0x10);
+  TestRegAddrBaseReg(sarx, edx, ecx, 0, eax, i32, 5, 0xC4, 0xE2, 0x7A, 0xF7,
+                     0x11);
+
+#undef TestRegAddrBaseReg
+#undef TestRegRegReg
+}
+
+TEST_F(AssemblerX8632LowLevelTest, VexXmm) {
+#define TestRegRegReg(Inst, Dst, Src0, Src1, OpType, ByteCountUntyped, ...)    \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Src0 ", " #Src1 ", " #OpType                 \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, XmmRegister::Encoded_Reg_##Dst,                  \
+            XmmRegister::Encoded_Reg_##Src0,                                   \
+            XmmRegister::Encoded_Reg_##Src1);                                  \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+#define TestRegRegAddrBase(Inst, Dst, Src0, Base, Disp, OpType,                \
+                           ByteCountUntyped, ...)                              \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Src0 ", " #Base ", " #Disp ", " #OpType      \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, XmmRegister::Encoded_Reg_##Dst,                  \
+            XmmRegister::Encoded_Reg_##Src0,                                   \
+            Address(GPRRegister::Encoded_Reg_##Base, Disp,                     \
+                    AssemblerFixup::NoFixup));                                 \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+  // Instructions in the 0F map use the two-byte C5 prefix, with Src0 in the
+  // inverted VEX.vvvv field, and VEX.pp encoding the implied legacy prefix.
+  TestRegRegReg(vaddps, xmm0, xmm1, xmm2, f32, 4, 0xC5, 0xF0, 0x58, 0xC2);
+  TestRegRegReg(vaddss, xmm3, xmm4, xmm5, f32, 4, 0xC5, 0xDA, 0x58, 0xDD);
+  TestRegRegReg(vaddss, xmm1, xmm2, xmm3, f64, 4, 0xC5, 0xEB, 0x58, 0xCB);
+  TestRegRegReg(vpadd, xmm0, xmm1, xmm2, i32, 4, 0xC5, 0xF1, 0xFE, 0xC2);
+  TestRegRegReg(vpxor, xmm7, xmm6, xmm5, i32, 4, 0xC5, 0xC9, 0xEF, 0xFD);
+  TestRegRegReg(vmovss, xmm0, xmm1, xmm2, f32, 4, 0xC5, 0xF2, 0x10, 0xC2);
+
+  // Instructions in the 0F38 map need the three-byte C4 prefix.
+  TestRegRegReg(vpmull, xmm0, xmm1, xmm2, i32, 5, 0xC4, 0xE2, 0x71, 0x40,
+                0xC2);
+  TestRegRegReg(vpshufb, xmm2, xmm3, xmm4, i8, 5, 0xC4, 0xE2, 0x61, 0x00,
+                0xD4);
+
+  TestRegRegAddrBase(vaddps, xmm0, xmm1, ebx, 0x10, f32, 5, 0xC5, 0xF0, 0x58,
+                     0x43, 0x10);
+  TestRegRegAddrBase(vpcmpgt, xmm6, xmm7, ecx, 0, i32, 4, 0xC5, 0xC1, 0x66,
+                     0x31);
+
+#undef TestRegRegAddrBase
+#undef TestRegRegReg
+}
+
 TEST_F(AssemblerX8632Test, ScratchpadGettersAndSetters) {
   const uint32_t S0 = allocateDword();
   const uint32_t S1 = allocateDword();
@@ -1101,6 +1101,159 @@ TEST_F(AssemblerX8664LowLevelTest, Cmp) {
 #undef TestRegReg
 }
 
+TEST_F(AssemblerX8664LowLevelTest, BitCount) {
+#define TestRegReg(Inst, Dst, Src, OpType, ByteCountUntyped, ...)              \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Src ", " #OpType ", " #ByteCountUntyped      \
+        ",  " #__VA_ARGS__ ")";                                                \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, Encoded_GPR_##Dst(), Encoded_GPR_##Src());       \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+#define TestRegAddrBase(Inst, Dst, Base, Disp, OpType, ByteCountUntyped, ...)  \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Base ", " #Disp ", " #OpType                 \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, Encoded_GPR_##Dst(),                             \
+            Address(Encoded_GPR_##Base(), Disp, AssemblerFixup::NoFixup));     \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+  // popcnt, lzcnt, and tzcnt are bsf's encoding with an F3 prefix, which
+  // must precede the REX prefix.
+  TestRegReg(popcnt, eax, ecx, i32, 4, 0xF3, 0x0F, 0xB8, 0xC1);
+  TestRegReg(popcnt, rax, rcx, i64, 5, 0xF3, 0x48, 0x0F, 0xB8, 0xC1);
+  TestRegReg(popcnt, r8, r9, i32, 5, 0xF3, 0x45, 0x0F, 0xB8, 0xC1);
+  TestRegReg(popcnt, eax, ecx, i16, 5, 0x66, 0xF3, 0x0F, 0xB8, 0xC1);
+  TestRegReg(lzcnt, ecx, edx, i32, 4, 0xF3, 0x0F, 0xBD, 0xCA);
+  TestRegReg(lzcnt, r10, rbx, i64, 5, 0xF3, 0x4C, 0x0F, 0xBD, 0xD3);
+  TestRegReg(tzcnt, esi, edi, i32, 4, 0xF3, 0x0F, 0xBC, 0xF7);
+  TestRegReg(tzcnt, rbx, r11, i64, 5, 0xF3, 0x49, 0x0F, 0xBC, 0xDB);
+
+  TestRegAddrBase(popcnt, eax, ecx, 0, i32, 5, 0x67, 0xF3, 0x0F, 0xB8, 0x01);
+  TestRegAddrBase(tzcnt, ecx, edx, 0, i32, 5, 0x67, 0xF3, 0x0F, 0xBC, 0x0A);
+  TestRegAddrBase(lzcnt, r9, r10, 0x40, i64, 7, 0x67, 0xF3, 0x4D, 0x0F, 0xBD,
+                  0x4A, 0x40);
+
+#undef TestRegAddrBase
+#undef TestRegReg
+}
+
+TEST_F(AssemblerX8664LowLevelTest, Shiftx) {
+#define TestRegRegReg(Inst, Dst, Src, Shifter, OpType, ByteCountUntyped, ...)  \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Src ", " #Shifter ", " #OpType               \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, Encoded_GPR_##Dst(), Encoded_GPR_##Src(),        \
+            Encoded_GPR_##Shifter());                                          \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+#define TestRegAddrBaseReg(Inst, Dst, Base, Disp, Shifter, OpType,             \
+                           ByteCountUntyped, ...)                              \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Base ", " #Disp ", " #Shifter ", " #OpType   \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, Encoded_GPR_##Dst(),                             \
+            Address(Encoded_GPR_##Base(), Disp, AssemblerFixup::NoFixup),      \
+            Encoded_GPR_##Shifter());                                          \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+  // VEX.LZ.0F38.W0/W1 F7 /r, with the shift count in VEX.vvvv, and VEX.pp
+  // selecting 66 for shlx, F2 for shrx, and F3 for sarx. VEX.R and VEX.B are
+  // the inverted REX.R and REX.B bits.
+  TestRegRegReg(shlx, eax, ecx, edx, i32, 5, 0xC4, 0xE2, 0x69, 0xF7, 0xC1);
+  TestRegRegReg(shlx, rax, rcx, rdx, i64, 5, 0xC4, 0xE2, 0xE9, 0xF7, 0xC1);
+  TestRegRegReg(shrx, r8, r9, r10, i32, 5, 0xC4, 0x42, 0x2B, 0xF7, 0xC1);
+  TestRegRegReg(sarx, ecx, eax, ebx, i32, 5, 0xC4, 0xE2, 0x62, 0xF7, 0xC8);
+  TestRegRegReg(sarx, r11, rsi, r15, i64, 5, 0xC4, 0x62, 0x82, 0xF7, 0xDE);
+
+  TestRegAddrBaseReg(sarx, ecx, r9, 0, eax, i32, 6, 0x67, 0xC4, 0xC2, 0x7A,
+                     0xF7, 0x09);
+  TestRegAddrBaseReg(shlx, rax, rbx, 0x10, rcx, i64, 7, 0x67, 0xC4, 0xE2,
+                     0xF1, 0xF7, 0x43, 0x10);
+
+#undef TestRegAddrBaseReg
+#undef TestRegRegReg
+}
+
+TEST_F(AssemblerX8664LowLevelTest, VexXmm) {
+#define TestRegRegReg(Inst, Dst, Src0, Src1, OpType, ByteCountUntyped, ...)    \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Src0 ", " #Src1 ", " #OpType                 \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, Encoded_Xmm_##Dst(), Encoded_Xmm_##Src0(),       \
+            Encoded_Xmm_##Src1());                                             \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+#define TestRegRegAddrBase(Inst, Dst, Src0, Base, Disp, OpType,                \
+                           ByteCountUntyped, ...)                              \
+  do {                                                                         \
+    static constexpr char TestString[] =                                       \
+        "(" #Inst ", " #Dst ", " #Src0 ", " #Base ", " #Disp ", " #OpType      \
+        ", " #ByteCountUntyped ",  " #__VA_ARGS__ ")";                         \
+    static constexpr uint8_t ByteCount = ByteCountUntyped;                     \
+    __ Inst(IceType_##OpType, Encoded_Xmm_##Dst(), Encoded_Xmm_##Src0(),       \
+            Address(Encoded_GPR_##Base(), Disp, AssemblerFixup::NoFixup));     \
+    ASSERT_EQ(ByteCount, codeBytesSize()) << TestString;                       \
+    ASSERT_TRUE(verifyBytes<ByteCount>(codeBytes(), __VA_ARGS__))              \
+        << TestString;                                                         \
+    reset();                                                                   \
+  } while (0)
+
+  // Instructions in the 0F map use the two-byte C5 prefix, with Src0 in the
+  // inverted VEX.vvvv field, and VEX.pp encoding the implied legacy prefix.
+  // The two-byte prefix only has room for VEX.R, so an extended ModRM.rm
+  // register needs the three-byte C4 prefix.
+  TestRegRegReg(vaddps, xmm0, xmm1, xmm2, f32, 4, 0xC5, 0xF0, 0x58, 0xC2);
+  TestRegRegReg(vaddps, xmm8, xmm1, xmm2, f32, 4, 0xC5, 0x70, 0x58, 0xC2);
+  TestRegRegReg(vaddps, xmm8, xmm9, xmm10, f32, 5, 0xC4, 0x41, 0x30, 0x58,
+                0xC2);
+  TestRegRegReg(vaddss, xmm3, xmm4, xmm5, f32, 4, 0xC5, 0xDA, 0x58, 0xDD);
+  TestRegRegReg(vpadd, xmm0, xmm1, xmm2, i32, 4, 0xC5, 0xF1, 0xFE, 0xC2);
+  TestRegRegReg(vpxor, xmm15, xmm6, xmm5, i32, 4, 0xC5, 0x49, 0xEF, 0xFD);
+  TestRegRegReg(vmovss, xmm0, xmm1, xmm2, f32, 4, 0xC5, 0xF2, 0x10, 0xC2);
+
+  // Instructions in the 0F38 map always need the three-byte C4 prefix.
+  TestRegRegReg(vpmull, xmm0, xmm1, xmm2, i32, 5, 0xC4, 0xE2, 0x71, 0x40,
+                0xC2);
+
+  TestRegRegAddrBase(vaddps, xmm0, xmm1, rbx, 0x10, f32, 6, 0x67, 0xC5, 0xF0,
+                     0x58, 0x43, 0x10);
+  TestRegRegAddrBase(vpcmpgt, xmm6, xmm7, r9, 0, i32, 6, 0x67, 0xC4, 0xC1,
+                     0x41, 0x66, 0x31);
+
+#undef TestRegRegAddrBase
+#undef TestRegRegReg
+}
+
 TEST_F(AssemblerX8664Test, ScratchpadGettersAndSetters) {
   const uint32_t S0 = allocateDword();
   const uint32_t S1 = allocateDword();
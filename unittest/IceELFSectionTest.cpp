@@ -8,12 +8,17 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 
 #include "gtest/gtest.h"
 
 #include "IceDefs.h"
 #include "IceELFSection.h"
+#include "IceELFStreamer.h"
 
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/raw_os_ostream.h"
 
 namespace Ice {
@@ -137,5 +142,30 @@ TEST(IceELFSectionTest, StringTableBuilderDuplicates) {
   CheckStringTablePermLayout(Strtab);
 }
 
+// Test that the memory mapped streamer grows the file past its initial mapping,
+// supports seeking back to patch earlier bytes, and leaves the file with
+// exactly the bytes written.
+TEST(IceELFSectionTest, MmapStreamerGrowAndPatch) {
+  llvm::SmallString<128> Path;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("elfstreamer", "o", Path));
+  const std::string Filename(Path.str());
+  const std::string Chunk(3 << 19, 'x');
+  {
+    std::unique_ptr<ELFMmapStreamer> Str = ELFMmapStreamer::create(Filename);
+    ASSERT_NE(nullptr, Str);
+    Str->writeLE32(0);
+    Str->writeBytes(Chunk);
+    Str->write8('y');
+    EXPECT_EQ(4 + Chunk.size() + 1, Str->tell());
+    Str->seek(0);
+    Str->writeLE32(0x64636261);
+  }
+  std::ifstream File(Filename, std::ios::in | std::ios::binary);
+  std::ostringstream Contents;
+  Contents << File.rdbuf();
+  EXPECT_EQ("abcd" + Chunk + "y", Contents.str());
+  llvm::sys::fs::remove(Filename);
+}
+
 } // end of anonymous namespace
 } // end of namespace Ice